@@ -10,6 +10,7 @@
 #include "Shared/Logger.hpp"
 #include "Shared/GameState.hpp"
 #include "EntityManager.hpp"
+#include "FrameUniforms.hpp"
 #include "GuiManager.hpp"
 #include "AudioManager.hpp"
 #include "ColliderManager.hpp"
@@ -579,6 +580,9 @@ void Application::Draw() {
 
 	  // Non-UI elements depend on localPlayer and that we're not in the lobby
 	  if (_localPlayer && !_inLobby) {
+		  // Camera and lights for every lit shader this frame
+		  FrameUniforms::getInstance().update(_localPlayer->getCamera());
+
 		  // Render Skybox
 		  _skyboxShader->Use();
 		  _skyboxShader->set_uniform("u_projection", _localPlayer->getCamera()->projection_matrix());
@@ -593,6 +597,7 @@ void Application::Draw() {
 		  ParticleSystemManager::getInstance().render(_localPlayer->getCamera());
 
 		  EntityManager::getInstance().render(_localPlayer->getCamera());
+		  GuiManager::getInstance().setCullStats(EntityManager::getInstance().getCullStats());
 
 		  // Debug Shader
 		  _debuglightShader->Use();
@@ -5,6 +5,8 @@
 #include "Shared/BaseState.hpp"
 #include "Camera.hpp"
 #include "Drawable.hpp"
+#include "FrameUniforms.hpp"
+#include "InstanceGroup.hpp"
 #include "Shader.hpp"
 
 /*
@@ -19,41 +21,99 @@
 class CBaseEntity
 {
 public:
-	// Base render function, affects all entities. If special handling is
-	// needed, override this in the child.
+	// Base render function, affects all entities. To draw more with the same
+	// shader, override draw() instead. If special handling is needed,
+	// override this in the child, along with getShader().
 	virtual void render(std::unique_ptr<Camera> const &camera)
 	{
 		_objectShader->Use();
+		draw(camera);
+	}
+
+	// Draws the entity, with the shader from getShader() already in use
+	virtual void draw(std::unique_ptr<Camera> const &camera)
+	{
 		setUniforms(camera);
 		_objectModel->render(_objectShader);
 	}
 
+	// Shader render() uses, so the render queue can group entities by it
+	// and call draw() without switching shaders when the last entity used
+	// the same one. Null if render() does something else, like switching
+	// shaders itself.
+	virtual Shader * getShader()
+	{
+		return _objectShader.get();
+	}
+
+	// Camera and light are shared by every shader, through FrameUniforms.
+	// Shaders from the same files share a program, so everything a draw
+	// depends on is set every time.
 	virtual void setUniforms(std::unique_ptr<Camera> const &camera)
 	{
-		_objectShader->set_uniform("u_projection", camera->projection_matrix());
-		_objectShader->set_uniform("u_view", camera->view_matrix());
+		if (!_hasUniformLocations)
+		{
+			_transparencyLocation = _objectShader->uniform_location("u_transparency");
+			_modelLocation = _objectShader->uniform_location("u_model");
+			_dirlightLocation = _objectShader->uniform_location("u_dirlight");
+			_hasUniformLocations = true;
+		}
 
 		// Setting tranparency
-		_objectShader->set_uniform("u_transparency", _state->transparency * _alpha);
+		_objectShader->set_uniform(_transparencyLocation, getShaderTransparency());
 
-		// Compute model matrix based on state: t * r * s
+		// Pass model matrix into shader
+		_objectShader->set_uniform(_modelLocation, getModelMatrix());
+		_objectShader->set_uniform(_dirlightLocation, static_cast<GLuint>(DIRLIGHT_SCENE));
+	}
+
+	// Queues this entity in its instance group to be drawn with the rest,
+	// rather than rendering it now. False if it has to render itself.
+	bool addInstance()
+	{
+		if (!_instanceGroup)
+		{
+			return false;
+		}
+
+		// Groups only draw fully opaque instances. Fully transparent ones
+		// would be discarded by the shader anyway.
+		float transparency = getShaderTransparency();
+		if (transparency >= 1.0f)
+		{
+			_instanceGroup->add({ getModelMatrix(), _state->scale });
+		}
+		return transparency >= 1.0f || transparency <= 0.0f;
+	}
+
+	// Compute model matrix based on state: t * r * s
+	glm::mat4 getModelMatrix() const
+	{
 		const auto t = glm::translate(glm::mat4(1.0f), _state->pos);
 		const auto r = glm::lookAt(glm::vec3(0.0f), _state->forward, _state->up);
 		const auto s = glm::scale(glm::mat4(1.0f), _state->scale);
 
-		auto model = t * r * s;
+		return t * r * s;
+	}
 
-		// Pass model matrix into shader
-		_objectShader->set_uniform("u_model", model);
-		_objectShader->set_uniform("u_dirlight.direction", glm::vec3(-0.4f, -1.0f, -0.4f));
-		_objectShader->set_uniform("u_dirlight.ambient", glm::vec3(0.2f, 0.2f, 0.3f));
-		_objectShader->set_uniform("u_dirlight.diffuse", glm::vec3(0.8f, 0.8f, 0.9f));
-		_objectShader->set_uniform("u_numdirlights", static_cast<GLuint>(1));
+	// Transparency the shader draws with
+	virtual float getShaderTransparency() const
+	{
+		return _state->transparency * _alpha;
 	}
 
 	// Every child must override this if they carry additional state
 	virtual void updateState(std::shared_ptr<BaseState> state)
 	{
+		// Anything that moves or resizes once is culled on its own from then on
+		if (_hasState && (state->pos != _state->pos || state->scale != _state->scale ||
+			state->width != _state->width || state->height != _state->height ||
+			state->depth != _state->depth))
+		{
+			_hasMoved = true;
+		}
+		_hasState = true;
+
 		_state->id = state->id;
 
 		// Translation
@@ -86,6 +146,11 @@ public:
 		return _state->type;
 	}
 
+	Drawable * getDrawable() const
+	{
+		return _objectModel.get();
+	}
+
 	// Getter for culling
 	virtual glm::vec3 getPos() const
 	{
@@ -98,6 +163,13 @@ public:
 		return std::max(_state->width, std::max(_state->height, _state->depth));
 	}
 
+	// Whether the entity has moved or resized since its first state. Those
+	// that have not are culled a part of the map at a time.
+	virtual bool hasMoved() const
+	{
+		return _hasMoved;
+	}
+
 	// TODO: add any functionality here that is needed in every client-side
 	// object.
 
@@ -115,12 +187,26 @@ protected:
 	// State pointer for object
 	std::shared_ptr<BaseState> _state;
 
-	// Drawable object. Can be an animation or model
-	std::unique_ptr<Drawable> _objectModel;
+	// Drawable object. Can be an animation or model, and shared with an
+	// instance group.
+	std::shared_ptr<Drawable> _objectModel;
+
+	// Group this entity is drawn in while opaque, if any
+	InstanceGroup * _instanceGroup = nullptr;
 
 	// Transparency information
 	float _alpha = 1.0f;
 
+	// Whether a state has come in, and whether a later one moved the entity
+	bool _hasState = false;
+	bool _hasMoved = false;
+
 	// Shader program for object
 	std::unique_ptr<Shader> _objectShader;
+
+	// Locations in _objectShader, looked up on the first setUniforms()
+	bool _hasUniformLocations = false;
+	GLint _transparencyLocation;
+	GLint _modelLocation;
+	GLint _dirlightLocation;
 };
@@ -25,6 +25,12 @@ public:
 
 	~CBillboardEntity() {};
 
+	// Text is rendered with its own shader first
+	Shader * getShader() override
+	{
+		return nullptr;
+	}
+
 	void render(std::unique_ptr<Camera> const& camera) override
 	{
 		// Save previous framebuffer
@@ -39,4 +39,9 @@ public:
 	{
 
 	}
+
+	Shader * getShader() override
+	{
+		return nullptr;
+	}
 };
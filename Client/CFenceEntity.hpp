@@ -8,7 +8,9 @@ public:
 	CFenceEntity()
 	{
 		// Allocate member variables
-		_objectModel = std::make_unique<Model>("./Resources/Models/fence.fbx");
+		_instanceGroup = InstanceGroup::get("./Resources/Models/fence.fbx",
+			INSTANCED_WALL_VERT, "./Resources/Shaders/wall.frag");
+		_objectModel = _instanceGroup->getModel();
 		_objectShader = std::make_unique<Shader>();
 		_state = std::make_shared<BaseState>();
 
@@ -25,9 +27,11 @@ public:
 		// Walls need scale
 		const auto s = glm::scale(glm::mat4(1.0f), _state->scale);
 		_objectShader->set_uniform("u_scale", s);
+	}
 
-		// Transparency (don't use alpha)
-		_objectShader->set_uniform("u_transparency", _state->transparency);
+	// Transparency (don't use alpha)
+	float getShaderTransparency() const override {
+		return _state->transparency;
 	}
 
 	float getAlpha() const override {
@@ -4,9 +4,9 @@
 #include "EntityManager.hpp"
 
 std::vector<std::vector<FloorType>> CFloorEntity::_floorMap;
-std::vector<glm::mat4> CFloorEntity::_grassList;
-std::vector<glm::mat4> CFloorEntity::_pebbleList;
-std::vector<glm::mat4> CFloorEntity::_dirtPebbleList;
+std::vector<Instance> CFloorEntity::_grassList;
+std::vector<Instance> CFloorEntity::_pebbleList;
+std::vector<Instance> CFloorEntity::_dirtPebbleList;
 std::vector<std::vector<bool>> CFloorEntity::_claimedMap;
 
 CFloorEntity::CFloorEntity()
@@ -45,6 +45,15 @@ CFloorEntity::CFloorEntity()
 	_pebbleModel = std::make_unique<Model>("./Resources/Models/rock.fbx");
 	_dirtPebbleModel = std::make_unique<Model>("./Resources/Models/dirt_pebble.fbx");
 
+	glGenBuffers(1, &_grassBuffer);
+	glGenBuffers(1, &_pebbleBuffer);
+	glGenBuffers(1, &_dirtPebbleBuffer);
+	_instancedShader = std::make_unique<Shader>();
+	_instancedShader->LoadFromFile(GL_VERTEX_SHADER, INSTANCED_LIGHT_VERT);
+	_instancedShader->LoadFromFile(GL_FRAGMENT_SHADER, "./Resources/Shaders/basiclight.frag");
+	_instancedShader->CreateProgram();
+	isTileMeshBaked = false;
+
 	_blendFloorModel = std::make_unique<Model>("./Resources/Models/round_floor.fbx");
 	_blendShader = std::make_unique<Shader>();
 	_blendShader->LoadFromFile(GL_VERTEX_SHADER, "./Resources/Shaders/basiclight.vert");
@@ -78,6 +87,7 @@ void CFloorEntity::updateTile(std::shared_ptr<BaseState> const & state)
 	_claimedMap[(int)(state->pos.x)][(int)(state->pos.z)] = (bool)(state->pos.y);
 
 	updatedTexture = false;
+	isTileMeshBaked = false;
 }
 
 void CFloorEntity::render(std::unique_ptr<Camera> const & camera)
@@ -95,64 +105,41 @@ void CFloorEntity::render(std::unique_ptr<Camera> const & camera)
 
 	floorMesh.Draw(_objectShader);
 
-	auto s = glm::scale(glm::mat4(1.0f), glm::vec3(tileScale, 1, tileScale));
-
-	for (int x = 0; x < _floorMap.size(); x++) {
-		for (int z = 0; z < _floorMap[0].size(); z++) {
-			// skip the tile that is default
-			if (_floorMap[x][z] == FLOOR_GRASS) {
-				continue;
-			};
-
-			// get actual position and scale of tile
-			float xPos = ((float)x * tileScale) - (MAP_WIDTH / 2) + tileScale / 2;
-			float zPos = ((float)z * tileScale) - (MAP_WIDTH / 2) + tileScale / 2;
-			auto t = glm::translate(glm::mat4(1.0f), glm::vec3(xPos, 0.002f, zPos));
-			auto model = t * s;
-			_objectShader->set_uniform("u_model", model);
-
-			// render the tile according to the floor type
-			switch (_floorMap[x][z])
-			{
-			case FLOOR_DIRT:
-				floorMesh.Draw(_objectShader, dirtTextureID);
-				break;
-			case FLOOR_ROAD:
-				floorMesh.Draw(_objectShader, roadTextureID);
-				break;
-			}
-		}
+	// Dirt and road tiles, already in world space
+	if (!isTileMeshBaked) {
+		bakeTiles(FLOOR_DIRT, _dirtTiles);
+		bakeTiles(FLOOR_ROAD, _roadTiles);
+		isTileMeshBaked = true;
 	}
 
-	// Also draw the grass
-	for (auto& grassM : _grassList)
-	{
-		_objectShader->set_uniform("u_model", grassM);
-		_grassModel->render(_objectShader);
+	_objectShader->set_uniform("u_model", glm::mat4(1.0f));
+	if (_dirtTiles) {
+		_dirtTiles->Draw(_objectShader, dirtTextureID);
 	}
-
-	for (auto& pebbleM : _pebbleList)
-	{
-		_objectShader->set_uniform("u_model", pebbleM);
-		_pebbleModel->render(_objectShader);
+	if (_roadTiles) {
+		_roadTiles->Draw(_objectShader, roadTextureID);
 	}
 
-	for (auto& dirtPebbleM : _dirtPebbleList)
-	{
-		_objectShader->set_uniform("u_model", dirtPebbleM);
-		_dirtPebbleModel->render(_objectShader);
+	// Also draw the grass and pebbles
+	_instancedShader->Use();
+	_instancedShader->set_uniform("u_transparency", _state->transparency * _alpha);
+	_instancedShader->set_uniform("u_dirlight", static_cast<GLuint>(DIRLIGHT_SCENE));
+
+	if (!_grassList.empty()) {
+		_grassModel->renderInstanced(_instancedShader, (GLsizei)_grassList.size());
+	}
+	if (!_pebbleList.empty()) {
+		_pebbleModel->renderInstanced(_instancedShader, (GLsizei)_pebbleList.size());
+	}
+	if (!_dirtPebbleList.empty()) {
+		_dirtPebbleModel->renderInstanced(_instancedShader, (GLsizei)_dirtPebbleList.size());
 	}
 
 	//floorMesh.Draw(_objectShader, fbo->getRGBA());
 
 	_blendShader->Use();
-	_blendShader->set_uniform("u_projection", camera->projection_matrix());
-	_blendShader->set_uniform("u_view", camera->view_matrix());
 	_blendShader->set_uniform("u_transparency", _state->transparency * _alpha);
-	_blendShader->set_uniform("u_dirlight.direction", glm::vec3(0.0f, -1.0f, -0.4f));
-	_blendShader->set_uniform("u_dirlight.ambient", glm::vec3(0.2f, 0.2f, 0.3f));
-	_blendShader->set_uniform("u_dirlight.diffuse", glm::vec3(0.8f, 0.8f, 0.9f));
-	_blendShader->set_uniform("u_numdirlights", static_cast<GLuint>(1));
+	_blendShader->set_uniform("u_dirlight", static_cast<GLuint>(DIRLIGHT_OVERHEAD));
 
 	float map_radius = std::sqrtf(MAP_WIDTH * MAP_WIDTH * 2) + 2.0f;
 	floorMesh = (static_cast<Model*>(_blendFloorModel.get()))->getMeshAt(0);
@@ -161,7 +148,7 @@ void CFloorEntity::render(std::unique_ptr<Camera> const & camera)
 		// Compute model matrix based on state: t * r * s
 		auto t = glm::translate(glm::mat4(1.0f), _state->pos + glm::vec3(0, -0.002f * i, 0));
 		auto r = glm::lookAt(glm::vec3(0.0f), _state->forward, _state->up);
-		s = glm::scale(glm::mat4(1.0f), glm::vec3(map_radius + MAP_BLEND_DIST * i, 1, map_radius + MAP_BLEND_DIST * i));
+		auto s = glm::scale(glm::mat4(1.0f), glm::vec3(map_radius + MAP_BLEND_DIST * i, 1, map_radius + MAP_BLEND_DIST * i));
 
 		auto model = t * r * s;
 
@@ -200,10 +187,11 @@ void CFloorEntity::initGrass()
 				auto r = glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0, 1, 0));
 				auto s = glm::scale(glm::mat4(1.0f), glm::vec3(scale));
 
-				_grassList.push_back(t * r * s);
+				_grassList.push_back({ t * r * s, glm::vec3(scale) });
 			}
 		}
 	}
+	uploadInstances(_grassList, _grassBuffer, _grassModel);
 	isGrassInitialized = true;
 }
 
@@ -234,12 +222,13 @@ void CFloorEntity::initPebble()
 					auto r = glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0, 1, 0));
 					auto s = glm::scale(glm::mat4(1.0f), glm::vec3(scale));
 
-					_pebbleList.push_back(t * r * s);
+					_pebbleList.push_back({ t * r * s, glm::vec3(scale) });
 				}
 			}
 
 		}
 	}
+	uploadInstances(_pebbleList, _pebbleBuffer, _pebbleModel);
 	isPebbleInitialized = true;
 }
 
@@ -270,12 +259,13 @@ void CFloorEntity::initDirtPebble()
 					auto r = glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0, 1, 0));
 					auto s = glm::scale(glm::mat4(1.0f), glm::vec3(scale));
 
-					_dirtPebbleList.push_back(t * r * s);
+					_dirtPebbleList.push_back({ t * r * s, glm::vec3(scale) });
 				}
 			}
 
 		}
 	}
+	uploadInstances(_dirtPebbleList, _dirtPebbleBuffer, _dirtPebbleModel);
 	isDirtPebbleInitialized = true;
 }
 
@@ -290,7 +280,7 @@ void CFloorEntity::createFloorTexture(std::unique_ptr<Camera> const & camera)
 	_textureShader->Use();
 	fbo->renderScene([&]
 	{
-		Logger::getInstance()->debug("Texture generating");
+		LOG_DEBUG("Texture generating");
 		glViewport(0, 0, MAP_WIDTH * FLOOR_TEXTURE_SCALE, MAP_WIDTH * FLOOR_TEXTURE_SCALE);
 		//Mesh floorMesh = (static_cast<Model*>(_objectModel.get()))->getMeshAt(0);
 		auto s = glm::scale(glm::mat4(1.0f), glm::vec3(MAP_WIDTH, 1, MAP_WIDTH));
@@ -355,4 +345,58 @@ void CFloorEntity::reset()
 	isDirtPebbleInitialized = false;
 	_floorMap.clear();
 	_claimedMap.clear();
-}
\ No newline at end of file
+	isTileMeshBaked = false;
+}
+
+void CFloorEntity::uploadInstances(std::vector<Instance> const& instances, GLuint buffer, std::unique_ptr<Model> const& model)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	model->setInstanceBuffer(buffer);
+}
+
+void CFloorEntity::bakeTiles(FloorType type, std::unique_ptr<Mesh>& mesh)
+{
+	if (mesh) {
+		mesh->CleanUp();
+		mesh = nullptr;
+	}
+
+	Mesh floorMesh = (static_cast<Model*>(_objectModel.get()))->getMeshAt(0);
+	auto s = glm::scale(glm::mat4(1.0f), glm::vec3(tileScale, 1, tileScale));
+
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	for (int x = 0; x < _floorMap.size(); x++) {
+		for (int z = 0; z < _floorMap[0].size(); z++) {
+			if (_floorMap[x][z] != type) {
+				continue;
+			}
+
+			// get actual position and scale of tile
+			float xPos = ((float)x * tileScale) - (MAP_WIDTH / 2) + tileScale / 2;
+			float zPos = ((float)z * tileScale) - (MAP_WIDTH / 2) + tileScale / 2;
+			auto t = glm::translate(glm::mat4(1.0f), glm::vec3(xPos, 0.002f, zPos));
+			auto model = t * s;
+			auto normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+
+			// Tile vertices moved to where the tile is
+			GLuint first = (GLuint)vertices.size();
+			for (auto& vertex : floorMesh.vertices()) {
+				Vertex baked = vertex;
+				baked.position = glm::vec3(model * glm::vec4(vertex.position, 1.0f));
+				baked.normal = glm::normalize(normalMatrix * vertex.normal);
+				vertices.push_back(baked);
+			}
+			for (auto index : floorMesh.indices()) {
+				indices.push_back(first + index);
+			}
+		}
+	}
+
+	if (!vertices.empty()) {
+		mesh = std::make_unique<Mesh>(vertices, indices, std::vector<Texture>());
+	}
+}
@@ -3,6 +3,7 @@
 #include "CBaseEntity.hpp"
 #include "Model.hpp"
 #include "FrameBuffer.h"
+#include "InstanceGroup.hpp"
 
 #define FLOOR_TEXTURE_SCALE 30
 
@@ -12,9 +13,9 @@ private:
 	CFloorEntity();
 	static std::vector<std::vector<FloorType>> _floorMap;
 	static std::vector<std::vector<bool>> _claimedMap;
-	static std::vector<glm::mat4> _grassList;
-	static std::vector<glm::mat4> _pebbleList;
-	static std::vector<glm::mat4> _dirtPebbleList;
+	static std::vector<Instance> _grassList;
+	static std::vector<Instance> _pebbleList;
+	static std::vector<Instance> _dirtPebbleList;
 	float tileScale;
 	unsigned int dirtTextureID;
 	unsigned int roadTextureID;
@@ -29,9 +30,28 @@ private:
 	std::unique_ptr<Model> _pebbleModel;
 	std::unique_ptr<Model> _dirtPebbleModel;
 
+	// Grass and pebbles never move, so are uploaded once when created and
+	// drawn instanced
+	GLuint _grassBuffer;
+	GLuint _pebbleBuffer;
+	GLuint _dirtPebbleBuffer;
+	std::unique_ptr<Shader> _instancedShader;
+
+	// Dirt and road tiles, each baked into one mesh in world space. Rebuilt
+	// when tiles change.
+	std::unique_ptr<Mesh> _dirtTiles;
+	std::unique_ptr<Mesh> _roadTiles;
+	bool isTileMeshBaked;
+
 	std::unique_ptr<Model> _blendFloorModel;
 	std::unique_ptr<Shader> _blendShader;
 
+	// Uploads grass or pebble instances for model to draw
+	void uploadInstances(std::vector<Instance> const& instances, GLuint buffer, std::unique_ptr<Model> const& model);
+
+	// Builds one mesh out of every tile of a type, or null if there are none
+	void bakeTiles(FloorType type, std::unique_ptr<Mesh>& mesh);
+
 public:
 	/**
 	* \brief The singleton getter of FloorManager (create one if not exist)
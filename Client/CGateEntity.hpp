@@ -29,9 +29,9 @@ public:
 		_objectShader->set_uniform("u_scale", s);
 	}
 
-	void render(std::unique_ptr<Camera> const &camera) override
+	void draw(std::unique_ptr<Camera> const &camera) override
 	{
-		CBaseEntity::render(camera);
+		CBaseEntity::draw(camera);
 
 		auto t = glm::translate(glm::mat4(1.0f), _state->pos);
 		const auto r = glm::lookAt(glm::vec3(0.0f), _state->forward, _state->up);
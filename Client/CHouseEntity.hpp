@@ -18,8 +18,9 @@ public:
 		if (usedSkin != 0)
 			modelLoc += std::to_string(usedSkin);
 		modelLoc += ".fbx";
-		const char * modelSource = modelLoc.c_str();
-		_objectModel = std::make_unique<Model>(modelSource);
+		_instanceGroup = InstanceGroup::get(modelLoc,
+			INSTANCED_LIGHT_VERT, "./Resources/Shaders/basiclight.frag");
+		_objectModel = _instanceGroup->getModel();
 
 		_objectShader = std::make_unique<Shader>();
 		_state = std::make_shared<BaseState>();
@@ -117,9 +117,6 @@ public:
 		if (currentState->chargeMeter > 0) {
 			std::cout << currentState->chargeMeter << std::endl;
 			_arrowShader->Use();
-			_arrowShader->set_uniform("u_projection", camera->projection_matrix());
-			_arrowShader->set_uniform("u_view", camera->view_matrix());
-
 			// Setting tranparency
 			_arrowShader->set_uniform("u_transparency", arrowTransparency);
 
@@ -132,10 +129,7 @@ public:
 
 			// Pass model matrix into shader
 			_arrowShader->set_uniform("u_model", model);
-			_arrowShader->set_uniform("u_dirlight.direction", glm::vec3(0.0f, -1.0f, -0.4f));
-			_arrowShader->set_uniform("u_dirlight.ambient", glm::vec3(0.2f, 0.2f, 0.3f));
-			_arrowShader->set_uniform("u_dirlight.diffuse", glm::vec3(0.8f, 0.8f, 0.9f));
-			_arrowShader->set_uniform("u_numdirlights", static_cast<GLuint>(1));
+			_arrowShader->set_uniform("u_dirlight", static_cast<GLuint>(DIRLIGHT_OVERHEAD));
 			_arrowModel->render(_arrowShader);
 		}
 	}
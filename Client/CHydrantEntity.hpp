@@ -7,7 +7,9 @@ class CHydrantEntity : public CBaseEntity
 {
 public:
 	CHydrantEntity() {
-		_objectModel = std::make_unique<Model>("./Resources/Models/fire_hydrant.fbx");
+		_instanceGroup = InstanceGroup::get("./Resources/Models/fire_hydrant.fbx",
+			INSTANCED_LIGHT_VERT, "./Resources/Shaders/basiclight.frag");
+		_objectModel = _instanceGroup->getModel();
 		_objectShader = std::make_unique<Shader>();
 		_state = std::make_shared<BaseState>();
 
@@ -45,6 +45,12 @@ public:
 		}
 	}
 
+	// Animation and name tags are handled in render()
+	Shader * getShader() override
+	{
+		return nullptr;
+	}
+
 	virtual void updateState(std::shared_ptr<BaseState> state) override
 	{
 		// Base update first
@@ -103,6 +109,12 @@ public:
 		}
 	}
 
+	// Players are always on the move
+	virtual bool hasMoved() const override
+	{
+		return true;
+	}
+
 protected:
 	void initAnimation(std::string modelPath)
 	{
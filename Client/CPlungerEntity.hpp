@@ -55,9 +55,6 @@ public:
 
 	virtual void setUniforms(std::unique_ptr<Camera> const &camera) override
 	{
-		plungerShader->set_uniform("u_projection", camera->projection_matrix());
-		plungerShader->set_uniform("u_view", camera->view_matrix());
-
 		// Setting tranparency
 		plungerShader->set_uniform("u_transparency", _state->transparency * _alpha);
 
@@ -70,19 +67,26 @@ public:
 
 		// Pass model matrix into shader
 		plungerShader->set_uniform("u_model", model);
-		plungerShader->set_uniform("u_dirlight.direction", glm::vec3(0.0f, -1.0f, -0.4f));
-		plungerShader->set_uniform("u_dirlight.ambient", glm::vec3(0.2f, 0.2f, 0.3f));
-		plungerShader->set_uniform("u_dirlight.diffuse", glm::vec3(0.8f, 0.8f, 0.9f));
-		plungerShader->set_uniform("u_numdirlights", static_cast<GLuint>(1));
+		plungerShader->set_uniform("u_dirlight", static_cast<GLuint>(DIRLIGHT_OVERHEAD));
 	}
 
 	virtual void render(std::unique_ptr<Camera> const &camera) override
 	{
 		plungerShader->Use();
+		draw(camera);
+	}
+
+	virtual void draw(std::unique_ptr<Camera> const &camera) override
+	{
 		setUniforms(camera);
 		_objectModel->render(plungerShader);
 	}
 
+	Shader * getShader() override
+	{
+		return plungerShader.get();
+	}
+
 	static std::unique_ptr<Shader> plungerShader;
 
 protected:
@@ -7,7 +7,9 @@ class CTreeEntity : public CBaseEntity
 {
 public:
 	CTreeEntity() {
-		_objectModel = std::make_unique<Model>("Resources/Models/tree.fbx");
+		_instanceGroup = InstanceGroup::get("Resources/Models/tree.fbx",
+			INSTANCED_LIGHT_VERT, "./Resources/Shaders/basiclight.frag");
+		_objectModel = _instanceGroup->getModel();
 		_objectShader = std::make_unique<Shader>();
 		_state = std::make_shared<BaseState>();
 
@@ -50,12 +50,17 @@ void Camera::Update() {
     nbl = nc - (_up * nh / 2.0f) - (_right * nw / 2.0f);
     nbr = nc - (_up * nh / 2.0f) + (_right * nw / 2.0f);
 
-    _planes[0] = {ntr, ntl, ftl};
-    _planes[1] = {nbl, nbr, fbr};
-    _planes[2] = {ntl, nbl, fbl};
-    _planes[3] = {nbr, ntr, fbr};
-    _planes[4] = {ntl, ntr, nbr};
-    _planes[5] = {ftr, ftl, fbl};
+    // Each plane through three corners, wound so the normal points in
+    auto setPlane = [this](int i, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2) {
+        glm::vec3 normal = glm::normalize(glm::cross((p1 - p0), (p2 - p1)));
+        _planes[i] = glm::vec4(normal, -glm::dot(normal, p0));
+    };
+    setPlane(0, ntr, ntl, ftl);
+    setPlane(1, nbl, nbr, fbr);
+    setPlane(2, ntl, nbl, fbl);
+    setPlane(3, nbr, ntr, fbr);
+    setPlane(4, ntl, ntr, nbr);
+    setPlane(5, ftr, ftl, fbl);
 }
 
 void Camera::Reset() {
@@ -74,7 +79,7 @@ void Camera::Reset() {
     _movement_speed = cameradefaults::move_speed;
     _sensitivity = cameradefaults::mouse_sensitivity;
 
-    _planes.resize(6);
+    _planes.fill(glm::vec4(0));
     set_distance(14.0f, false);
     set_pitch(45.0f);
 }
@@ -145,17 +150,18 @@ glm::vec3 Camera::lookat() const {
 }
 
 bool Camera::isInFrustum(glm::vec3 p, float radius) const {
-    for (int i = 0; i < 6; i++) {
-        auto& [p0, p1, p2] = _planes[i];
-        glm::vec3 normal = glm::normalize(glm::cross((p1 - p0), (p2 - p1)));
-        glm::vec3 vec = p - p0;
-        float dist = glm::dot(vec, normal);
+    for (auto& plane : _planes) {
+        float dist = glm::dot(glm::vec3(plane), p) + plane.w;
         if (dist + radius < 0)
             return false;
     }
     return true;
 }
 
+const std::array<glm::vec4, 6> & Camera::frustum_planes() const {
+    return _planes;
+}
+
 float Camera::getTransparency(glm::vec3 p, float radius) const {
     // Make close object transparent
     float dist = glm::length(p - _position);
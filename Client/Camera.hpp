@@ -8,7 +8,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
-#include <tuple>
+#include <array>
 #include <vector>
 
 enum CameraMovement
@@ -69,6 +69,13 @@ class Camera
   glm::vec3 position() const;
     glm::vec3 lookat() const;
   bool isInFrustum(glm::vec3 p, float radius) const;
+
+  /**
+   * @brief Planes bounding the view as of the last Update(), each a normal
+   * pointing into the view and a distance, so that dot(normal, p) + distance
+   * is how far p is inside.
+   */
+  const std::array<glm::vec4, 6> & frustum_planes() const;
   float getTransparency(glm::vec3 p, float radius) const;
   float fov() const;
 
@@ -118,7 +125,7 @@ class Camera
     glm::vec3 nbl;
     glm::vec3 nbr;
 
-    std::vector<std::tuple<glm::vec3, glm::vec3, glm::vec3>> _planes; 
+    std::array<glm::vec4, 6> _planes;
   
   float _pitch = -45.0f;        ///< The camera's pitch.
   float _pitchLimit = 0.0f; ///< The upper limit of camera pitch.
@@ -0,0 +1,186 @@
+#include <cmath>
+#include <unordered_map>
+
+#include "Culling.hpp"
+#ifdef CULL_SSE
+#include <xmmintrin.h>
+#endif
+
+void SphereList::clear()
+{
+	_x.clear();
+	_y.clear();
+	_z.clear();
+	_r.clear();
+	_ids.clear();
+}
+
+void SphereList::add(glm::vec3 center, float radius, uint32_t id)
+{
+	size_t i = _ids.size();
+
+	// Pad with another step's worth of empty spheres when out of room
+	if (i % CULL_LANES == 0)
+	{
+		_x.resize(i + CULL_LANES, 0.0f);
+		_y.resize(i + CULL_LANES, 0.0f);
+		_z.resize(i + CULL_LANES, 0.0f);
+		_r.resize(i + CULL_LANES, 0.0f);
+	}
+
+	_x[i] = center.x;
+	_y[i] = center.y;
+	_z[i] = center.z;
+	_r[i] = radius;
+	_ids.push_back(id);
+}
+
+void SphereList::cull(const std::array<glm::vec4, 6> & planes, std::vector<uint32_t> & visible) const
+{
+	size_t count = _ids.size();
+
+#ifdef CULL_SSE
+	// Each plane's components, in every lane
+	__m128 nx[6], ny[6], nz[6], d[6];
+	for (size_t p = 0; p < planes.size(); p++)
+	{
+		nx[p] = _mm_set1_ps(planes[p].x);
+		ny[p] = _mm_set1_ps(planes[p].y);
+		nz[p] = _mm_set1_ps(planes[p].z);
+		d[p] = _mm_set1_ps(planes[p].w);
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < count; i += CULL_LANES)
+	{
+		__m128 x = _mm_loadu_ps(&_x[i]);
+		__m128 y = _mm_loadu_ps(&_y[i]);
+		__m128 z = _mm_loadu_ps(&_z[i]);
+		__m128 r = _mm_loadu_ps(&_r[i]);
+
+		// A sphere is out if it is wholly behind any plane
+		__m128 outside = zero;
+		for (size_t p = 0; p < planes.size(); p++)
+		{
+			__m128 dist = _mm_add_ps(_mm_mul_ps(x, nx[p]), _mm_mul_ps(y, ny[p]));
+			dist = _mm_add_ps(dist, _mm_mul_ps(z, nz[p]));
+			dist = _mm_add_ps(dist, _mm_add_ps(d[p], r));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+		}
+
+		int inside = ~_mm_movemask_ps(outside) & 0xF;
+		for (size_t lane = 0; inside && lane < CULL_LANES && i + lane < count; lane++)
+		{
+			if (inside & (1 << lane))
+			{
+				visible.push_back(_ids[i + lane]);
+			}
+		}
+	}
+#else
+	for (size_t i = 0; i < count; i++)
+	{
+		bool isInside = true;
+		for (auto& plane : planes)
+		{
+			float dist = plane.x * _x[i] + plane.y * _y[i] + plane.z * _z[i] + plane.w;
+			if (dist + _r[i] < 0)
+			{
+				isInside = false;
+				break;
+			}
+		}
+
+		if (isInside)
+		{
+			visible.push_back(_ids[i]);
+		}
+	}
+#endif
+}
+
+void CullGrid::build(const SphereList & spheres)
+{
+	_cells.clear();
+	_cellBounds.clear();
+
+	// Boxes around the spheres of each cell, by grid coordinates
+	std::unordered_map<uint64_t, size_t> cellIndices;
+	std::vector<glm::vec3> mins;
+	std::vector<glm::vec3> maxes;
+
+	for (size_t i = 0; i < spheres.size(); i++)
+	{
+		glm::vec3 center = spheres.getCenter(i);
+		float radius = spheres.getRadius(i);
+
+		int64_t cellX = (int64_t)std::floor(center.x / CULL_CELL_SIZE);
+		int64_t cellZ = (int64_t)std::floor(center.z / CULL_CELL_SIZE);
+		uint64_t key = ((uint64_t)cellX << 32) | ((uint64_t)cellZ & 0xFFFFFFFF);
+
+		auto result = cellIndices.find(key);
+		size_t cell;
+		if (result != cellIndices.end())
+		{
+			cell = result->second;
+		}
+		else
+		{
+			cell = _cells.size();
+			cellIndices.insert({ key, cell });
+			_cells.emplace_back();
+			mins.push_back(center - radius);
+			maxes.push_back(center + radius);
+		}
+
+		_cells[cell].spheres.add(center, radius, spheres.getId(i));
+		mins[cell] = glm::min(mins[cell], center - radius);
+		maxes[cell] = glm::max(maxes[cell], center + radius);
+	}
+
+	for (size_t i = 0; i < _cells.size(); i++)
+	{
+		_cells[i].center = (mins[i] + maxes[i]) * 0.5f;
+		_cells[i].radius = glm::length(maxes[i] - mins[i]) * 0.5f;
+		_cellBounds.add(_cells[i].center, _cells[i].radius, (uint32_t)i);
+	}
+}
+
+void CullGrid::cull(const std::array<glm::vec4, 6> & planes, std::vector<uint32_t> & visible, CullStats & stats)
+{
+	_visibleCells.clear();
+	_cellBounds.cull(planes, _visibleCells);
+
+	stats.cells += (uint32_t)_cells.size();
+	stats.cellsCulled += (uint32_t)(_cells.size() - _visibleCells.size());
+
+	for (auto index : _visibleCells)
+	{
+		auto& cell = _cells[index];
+
+		// Wholly inside if in front of every plane by more than its radius
+		bool isInside = true;
+		for (auto& plane : planes)
+		{
+			if (glm::dot(glm::vec3(plane), cell.center) + plane.w < cell.radius)
+			{
+				isInside = false;
+				break;
+			}
+		}
+
+		if (isInside)
+		{
+			for (size_t i = 0; i < cell.spheres.size(); i++)
+			{
+				visible.push_back(cell.spheres.getId(i));
+			}
+			stats.cellsInside++;
+		}
+		else
+		{
+			cell.spheres.cull(planes, visible);
+			stats.spheresTested += (uint32_t)cell.spheres.size();
+		}
+	}
+}
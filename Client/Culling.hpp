@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+
+// SSE is there on every x86 and x64 CPU we run on, and tests four spheres
+// against a plane at once. Anything else falls back to one at a time.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define CULL_SSE
+#endif
+
+// Spheres tested per step of the kernel
+#define CULL_LANES 4
+
+// Width and depth of a grid cell, in world units
+#define CULL_CELL_SIZE 8.0f
+
+// What culling did in a frame, for the debug overlay
+struct CullStats
+{
+	uint32_t cells = 0;				// Grid cells holding entities
+	uint32_t cellsCulled = 0;		// Cells wholly outside the view
+	uint32_t cellsInside = 0;		// Cells wholly inside, kept without testing
+	uint32_t spheresTested = 0;		// Entities tested one by one
+	uint32_t visible = 0;			// Entities left to draw
+};
+
+/*
+** Bounding spheres in structure-of-arrays form, each with an id for the
+** caller, culled against the planes of a view CULL_LANES at a time. The
+** arrays are padded to a multiple of CULL_LANES, so the kernel never reads
+** past them.
+*/
+class SphereList
+{
+public:
+	void clear();
+
+	void add(glm::vec3 center, float radius, uint32_t id);
+
+	size_t size() const { return _ids.size(); };
+
+	glm::vec3 getCenter(size_t i) const { return glm::vec3(_x[i], _y[i], _z[i]); };
+	float getRadius(size_t i) const { return _r[i]; };
+	uint32_t getId(size_t i) const { return _ids[i]; };
+
+	// Appends the ids of spheres at least partly inside every plane. Planes
+	// are a normal pointing in and a distance, as from Camera::frustum_planes().
+	void cull(const std::array<glm::vec4, 6> & planes, std::vector<uint32_t> & visible) const;
+
+private:
+	std::vector<float> _x;
+	std::vector<float> _y;
+	std::vector<float> _z;
+	std::vector<float> _r;
+	std::vector<uint32_t> _ids;
+};
+
+/*
+** Entities that stay put, bucketed in a uniform grid over the ground, so
+** whole parts of the map are culled with one test. A cell's bounds cover every
+** sphere in it, so big entities near an edge make their cell a bit bigger
+** rather than land in several.
+**
+** Cells outside the view are skipped, cells wholly inside it are kept without
+** looking at what is in them, and only cells on its edge have their spheres
+** tested one by one.
+*/
+class CullGrid
+{
+public:
+	// Replaces what is in the grid with spheres
+	void build(const SphereList & spheres);
+
+	// Appends the ids of spheres at least partly inside every plane
+	void cull(const std::array<glm::vec4, 6> & planes, std::vector<uint32_t> & visible, CullStats & stats);
+
+private:
+	struct Cell
+	{
+		glm::vec3 center;
+		float radius;
+		SphereList spheres;
+	};
+
+	std::vector<Cell> _cells;
+
+	// Bounds of _cells, ids being cell indices, to cull cells with the kernel
+	SphereList _cellBounds;
+
+	// Cells left by the last cull(), kept so it is not reallocated
+	std::vector<uint32_t> _visibleCells;
+};
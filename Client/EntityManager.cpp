@@ -18,6 +18,7 @@
 #include "CTrapEntity.hpp"
 #include "CTreeEntity.hpp"
 #include "ColliderManager.hpp"
+#include "RenderQueue.hpp"
 #include "ParticleSystemManager.hpp"
 #include "Shared/Logger.hpp"
 #include <algorithm>
@@ -132,10 +133,11 @@ std::shared_ptr<CBaseEntity> EntityManager::getEntity(std::shared_ptr<BaseState>
     {
 		if (!state->isVisible)
 		{
-			Logger::getInstance()->debug("type:" + std::to_string(state->type));
+			LOG_DEBUG("type:" + std::to_string(state->type));
 		}
         _entityList.push_back(entity);
         _entityMap.insert({id, _entityList.size() - 1});
+        _isCullGridStale = true;
     }
 
     return entity;
@@ -164,7 +166,14 @@ void EntityManager::update(std::shared_ptr<BaseState> const &state)
 
     if (entity)
     {
+        bool hadMoved = entity->hasMoved();
         entity->updateState(state);
+
+        // Now that it moves, it leaves the grid
+        if (!hadMoved && entity->hasMoved())
+        {
+            _isCullGridStale = true;
+        }
     }
 
 	ColliderManager::getInstance().updateState(state);
@@ -189,6 +198,7 @@ void EntityManager::update(std::shared_ptr<BaseState> const &state)
 				}
 			}
 			_entityMap.erase(result);
+			_isCullGridStale = true;
 		}
 
         ColliderManager::getInstance().erase(state->id);
@@ -199,31 +209,47 @@ void EntityManager::update(std::shared_ptr<BaseState> const &state)
 
 void EntityManager::render(std::unique_ptr<Camera> const &camera)
 {
-    std::vector<bool> test(_entityList.size());
-    std::vector<CBaseEntity *> transparentEntities;
-    std::vector<int> isOpaque;
+    auto& queue = RenderQueue::getInstance();
 
-    for (uint32_t i = 0; i < _entityList.size(); i++)
+    if (_isCullGridStale)
     {
-		if (_entityList[i]) {
-			const glm::vec3 pos = _entityList[i]->getPos();
-			const float radius = _entityList[i]->getRadius();
-			test[i] = camera->isInFrustum(pos, radius);
-			if (test[i])
-			{
-				_entityList[i]->setAlpha(camera->getTransparency(pos, radius));
-				if (_entityList[i]->getAlpha() < 1.0f || _entityList[i]->getType() == ENTITY_BOX)
-				{
-					if (_entityList[i]->getAlpha() > 0.01f) {
-						transparentEntities.push_back(_entityList[i].get());
-					}
-				}
-				else
-				{
-					isOpaque.push_back(i);
-				}
+        rebuildCullGrid();
+    }
+
+    // Unmoved entities by grid cell, then moving ones
+    const auto& planes = camera->frustum_planes();
+    _cullStats = CullStats();
+    _visibleEntities.clear();
+    _cullGrid.cull(planes, _visibleEntities, _cullStats);
+
+    _cullSpheres.clear();
+    for (auto index : _movingEntities)
+    {
+        auto& entity = _entityList[index];
+        _cullSpheres.add(entity->getPos(), entity->getRadius(), index);
+    }
+    _cullSpheres.cull(planes, _visibleEntities);
+    _cullStats.spheresTested += (uint32_t)_cullSpheres.size();
+    _cullStats.visible = (uint32_t)_visibleEntities.size();
+
+    for (auto index : _visibleEntities)
+    {
+		auto& entity = _entityList[index];
+		const glm::vec3 pos = entity->getPos();
+		const float radius = entity->getRadius();
+
+		entity->setAlpha(camera->getTransparency(pos, radius));
+		if (entity->getAlpha() < 1.0f || entity->getType() == ENTITY_BOX)
+		{
+			if (entity->getAlpha() > 0.01f) {
+				queue.submit(entity.get(), RENDER_TRANSPARENT, camera);
 			}
 		}
+		else if (!entity->addInstance())
+		{
+			// Those in an instance group are queued there instead
+			queue.submit(entity.get(), RENDER_OPAQUE, camera);
+		}
     }
 
     // save off current state of src / dst blend functions
@@ -232,30 +258,16 @@ void EntityManager::render(std::unique_ptr<Camera> const &camera)
     glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrc);
     glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDst);
 
-    // Render Opaque object
-    for (uint32_t i = 0; i < isOpaque.size(); i++)
-    {
-        _entityList[isOpaque[i]]->render(camera);
-    }
+    // Render Opaque object, then instance groups a group at a time
+    queue.execute(RENDER_OPAQUE, camera);
+    InstanceGroup::renderAll(camera);
 
     glDisable(GL_CULL_FACE);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Render Transparent objects from far to close
-    std::sort(transparentEntities.begin(), transparentEntities.end(),
-              [&](const CBaseEntity *a, const CBaseEntity *b) {
-                  glm::vec3 aPos = a->getPos();
-                  glm::vec3 bPos = b->getPos();
-                  float aDist = glm::length2(aPos - camera->position());
-                  float bDist = glm::length2(bPos - camera->position());
-                  return aDist > bDist;
-              });
-
-    for (uint32_t i = 0; i < transparentEntities.size(); i++)
-    {
-        transparentEntities[i]->render(camera);
-    }
+    queue.execute(RENDER_TRANSPARENT, camera);
 
     // restore
     glEnable(GL_CULL_FACE);
@@ -265,13 +277,46 @@ void EntityManager::render(std::unique_ptr<Camera> const &camera)
     ColliderManager::getInstance().render(camera);
 }
 
+void EntityManager::rebuildCullGrid()
+{
+	_movingEntities.clear();
+	_cullSpheres.clear();
+
+	for (uint32_t i = 0; i < _entityList.size(); i++)
+	{
+		auto& entity = _entityList[i];
+		if (!entity)
+		{
+			continue;
+		}
+
+		if (entity->hasMoved())
+		{
+			_movingEntities.push_back(i);
+		}
+		else
+		{
+			_cullSpheres.add(entity->getPos(), entity->getRadius(), i);
+		}
+	}
+
+	_cullGrid.build(_cullSpheres);
+	_isCullGridStale = false;
+}
+
 void EntityManager::clearAll() {
 	_entityList.clear();
 	_entityMap.clear();
 	_dogList.clear();
+	_isCullGridStale = true;
 }
 
 std::vector<std::shared_ptr<CDogEntity>> EntityManager::getDogList()
 {
 	return _dogList;
 }
+
+const CullStats & EntityManager::getCullStats() const
+{
+	return _cullStats;
+}
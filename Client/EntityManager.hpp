@@ -2,6 +2,7 @@
 #include <unordered_map>
 #include "CBaseEntity.hpp"
 #include "CDogEntity.hpp"
+#include "Culling.hpp"
 
 /**
  * \brief Manage all entities. Handle entities' updating and rendering.
@@ -13,6 +14,22 @@ private:
 	std::unordered_map<uint32_t, int> _entityMap;
     std::vector<std::shared_ptr<CBaseEntity>> _entityList;
 	std::vector<std::shared_ptr<CDogEntity>> _dogList;
+
+	// Entities that have not moved, culled a part of the map at a time, and
+	// indices in _entityList of those that have, culled one by one. Rebuilt
+	// when entities come, go or first move.
+	CullGrid _cullGrid;
+	std::vector<uint32_t> _movingEntities;
+	bool _isCullGridStale = true;
+
+	// Kept between frames, so they are not reallocated
+	SphereList _cullSpheres;
+	std::vector<uint32_t> _visibleEntities;
+
+	CullStats _cullStats;
+
+	// Sorts live entities into _cullGrid and _movingEntities
+	void rebuildCullGrid();
 public:
 	/**
 	 * \brief The singleton getter of EntityManager (create one if not exist)
@@ -56,4 +73,9 @@ public:
 	void clearAll();
 
 	std::vector<std::shared_ptr<CDogEntity>> getDogList();
+
+	/**
+	 * \brief What culling did in the last render()
+	 */
+	const CullStats & getCullStats() const;
 };
@@ -0,0 +1,41 @@
+#include "FrameUniforms.hpp"
+
+FrameUniforms& FrameUniforms::getInstance()
+{
+	static FrameUniforms frameUniforms;
+	return frameUniforms;
+}
+
+FrameUniforms::FrameUniforms()
+{
+	_block = {};
+
+	auto setLight = [this](int index, glm::vec3 direction)
+	{
+		_block.dirlights[index].direction = glm::vec4(direction, 0.0f);
+		_block.dirlights[index].ambient = glm::vec4(0.2f, 0.2f, 0.3f, 0.0f);
+		_block.dirlights[index].diffuse = glm::vec4(0.8f, 0.8f, 0.9f, 0.0f);
+	};
+	setLight(DIRLIGHT_SCENE, glm::vec3(-0.4f, -1.0f, -0.4f));
+	setLight(DIRLIGHT_OVERHEAD, glm::vec3(0.0f, -1.0f, -0.4f));
+	_block.numDirlights = FRAME_DIRLIGHTS;
+
+	glGenBuffers(1, &_buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), &_block, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	// Stays bound, since nothing else uses uniform buffers
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, _buffer);
+}
+
+void FrameUniforms::update(std::unique_ptr<Camera> const &camera)
+{
+	_block.projection = camera->projection_matrix();
+	_block.view = camera->view_matrix();
+	_block.viewPos = glm::vec4(camera->position(), 1.0f);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &_block);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+
+// Binding point of the Frame block, as in layout(binding = 0) in the shaders
+#define FRAME_UNIFORM_BINDING 0
+
+// Directional lights in the Frame block. A draw picks one with u_dirlight.
+#define FRAME_DIRLIGHTS 2
+#define DIRLIGHT_SCENE 0		// Lights the world
+#define DIRLIGHT_OVERHEAD 1		// Steeper, for the floor's rim, plungers and the charge arrow
+
+/*
+** Uniforms shared by every lit shader for a whole frame: the camera and the
+** directional lights. They live in one std140 uniform buffer, uploaded once a
+** frame and bound to FRAME_UNIFORM_BINDING, instead of being set on every
+** shader for every draw. Lit shaders declare the block as
+**
+** layout(std140, binding = 0) uniform Frame
+** {
+**   mat4 u_projection;
+**   mat4 u_view;
+**   vec3 u_viewPos;
+**   DirLight u_dirlights[2];
+**   uint u_numdirlights;
+** };
+**
+** which must match FrameBlock below.
+*/
+class FrameUniforms
+{
+public:
+	// Needs a GL context the first time
+	static FrameUniforms& getInstance();
+
+	// Uploads the camera for this frame
+	void update(std::unique_ptr<Camera> const &camera);
+
+private:
+	FrameUniforms();
+
+	// vec3s are padded to 16 bytes in std140
+	struct FrameDirLight
+	{
+		glm::vec4 direction;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+	};
+
+	struct FrameBlock
+	{
+		glm::mat4 projection;
+		glm::mat4 view;
+		glm::vec4 viewPos;
+		FrameDirLight dirlights[FRAME_DIRLIGHTS];
+		GLuint numDirlights;
+		GLuint padding[3];
+	};
+	static_assert(sizeof(FrameBlock) == 256, "FrameBlock must match the std140 Frame block");
+
+	FrameBlock _block;
+	GLuint _buffer;
+};
@@ -43,6 +43,10 @@ void GuiManager::init(GLFWwindow* window) {
     _fpsCounter = new Label(_screen, "fps: 0", DEFAULT_FONT, 32);
     _fpsCounter->setColor(SOLID_NONE);
 
+	_cullCounter = new Label(_screen, "", DEFAULT_FONT, 24);
+	_cullCounter->setColor(SOLID_NONE);
+	_cullCounter->setPosition(nanogui::Vector2i(0, 32));
+
 	// Tooltip display for players
 	_tooltipGUI = std::make_unique<TooltipGUI>(_screen->size().x(), _screen->size().y());
 }
@@ -316,14 +320,30 @@ void GuiManager::toggleFPS() {
 		if (_fpsCounter->color() == SOLID_NONE)
 		{
 			_fpsCounter->setColor(SOLID_WHITE);
+			_cullCounter->setColor(SOLID_WHITE);
 		}
 		else
 		{
 			_fpsCounter->setColor(SOLID_NONE);
+			_cullCounter->setColor(SOLID_NONE);
 		}
 	}
 }
 
+void GuiManager::setCullStats(const CullStats & stats) {
+	if (!_cullCounter || _cullCounter->color() == SOLID_NONE)
+	{
+		return;
+	}
+
+	_cullCounter->setCaption("cells: " + std::to_string(stats.cells) +
+		" (" + std::to_string(stats.cellsCulled) + " culled, " +
+		std::to_string(stats.cellsInside) + " inside), tested: " +
+		std::to_string(stats.spheresTested) + ", visible: " +
+		std::to_string(stats.visible));
+	_cullCounter->setSize(_cullCounter->preferredSize(_screen->nvgContext()));
+}
+
 std::string GuiManager::getPlayerName() {
 	return _playerNameBox->value();
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <nanogui/nanogui.h>
 #include <chrono>
+#include "Culling.hpp"
 #include "GamePadXbox.hpp"
 #include "TooltipGUI.hpp"
 
@@ -82,9 +83,12 @@ public:
 	void toggleMute();
 	void toggleMusicMute();
 
-	// Toggle FPS
+	// Toggle FPS, along with culling stats
 	void toggleFPS();
 
+	// Culling stats shown under FPS
+	void setCullStats(const CullStats & stats);
+
 	// Text in player name and address boxes
 	std::string getPlayerName();
 	void setPlayerName(std::string val);
@@ -169,6 +173,9 @@ private:
     // Test Text Label
     nanogui::Label * _fpsCounter;
 
+	// Culling stats for the last frame
+	nanogui::Label * _cullCounter = nullptr;
+
 	// Lists of dogs and humans; maps IDs to player names
 	std::unordered_map<std::string, std::string> _dogs;
 	std::unordered_map<std::string, std::string> _humans;
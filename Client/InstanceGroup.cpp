@@ -0,0 +1,79 @@
+#include "FrameUniforms.hpp"
+#include "InstanceGroup.hpp"
+
+std::unordered_map<std::string, std::unique_ptr<InstanceGroup>> InstanceGroup::_groups;
+
+InstanceGroup::InstanceGroup(const std::string & modelPath, const char * vertexPath, const char * fragmentPath)
+{
+	_model = std::make_shared<Model>(modelPath.c_str());
+
+	_shader = std::make_unique<Shader>();
+	_shader->LoadFromFile(GL_VERTEX_SHADER, vertexPath);
+	_shader->LoadFromFile(GL_FRAGMENT_SHADER, fragmentPath);
+	_shader->CreateProgram();
+	_transparencyLocation = _shader->uniform_location("u_transparency");
+	_dirlightLocation = _shader->uniform_location("u_dirlight");
+
+	// Allocated up front, since the model's meshes read from it as soon as
+	// it is attached
+	_capacity = INSTANCE_BUFFER_SIZE;
+	glGenBuffers(1, &_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, _capacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_model->setInstanceBuffer(_instanceBuffer);
+	_instances.reserve(_capacity);
+}
+
+InstanceGroup * InstanceGroup::get(const std::string & modelPath, const char * vertexPath, const char * fragmentPath)
+{
+	auto key = modelPath + "|" + vertexPath + "|" + fragmentPath;
+	auto result = _groups.find(key);
+	if (result != _groups.end())
+	{
+		return result->second.get();
+	}
+
+	auto group = new InstanceGroup(modelPath, vertexPath, fragmentPath);
+	_groups.insert({ key, std::unique_ptr<InstanceGroup>(group) });
+	return group;
+}
+
+void InstanceGroup::renderAll(std::unique_ptr<Camera> const & camera)
+{
+	for (auto& group : _groups)
+	{
+		group.second->render(camera);
+	}
+}
+
+void InstanceGroup::render(std::unique_ptr<Camera> const & camera)
+{
+	if (_instances.empty())
+	{
+		return;
+	}
+
+	// Orphan last frame's data rather than wait for draws still reading it.
+	// Growing keeps the buffer name, so the meshes need not be told.
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	while (_capacity < _instances.size())
+	{
+		_capacity *= 2;
+	}
+	glBufferData(GL_ARRAY_BUFFER, _capacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, _instances.size() * sizeof(Instance), _instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Camera and light come from FrameUniforms. Only opaque instances are
+	// queued, so transparency is always 1. The program is shared with other
+	// shaders from the same files, so the light is picked every time.
+	_shader->Use();
+	_shader->set_uniform(_transparencyLocation, 1.0f);
+	_shader->set_uniform(_dirlightLocation, static_cast<GLuint>(DIRLIGHT_SCENE));
+
+	_model->renderInstanced(_shader, (GLsizei)_instances.size());
+
+	_instances.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Camera.hpp"
+#include "Model.hpp"
+#include "Shader.hpp"
+
+// Instanced versions of basiclight.vert and wall.vert
+#define INSTANCED_LIGHT_VERT "./Resources/Shaders/basiclightInstanced.vert"
+#define INSTANCED_WALL_VERT "./Resources/Shaders/wallInstanced.vert"
+
+// Instances a group has buffer space for at first. Doubled when it runs out.
+#define INSTANCE_BUFFER_SIZE 256
+
+/*
+** Entities that share a model and shaders, drawn with one instanced draw per
+** mesh rather than a draw and a round of uniforms per entity. Entities in a
+** group share its model. When they are opaque, they queue themselves with add()
+** instead of rendering, and render() draws everything queued this frame.
+**
+** The group's vertex shader is an instanced version of the one the entities
+** use on their own, taking each instance's model matrix and scale as vertex
+** attributes.
+*/
+class InstanceGroup
+{
+public:
+	// The group for a model and shaders, created the first time it is asked for.
+	// Needs a GL context.
+	static InstanceGroup * get(const std::string & modelPath, const char * vertexPath, const char * fragmentPath);
+
+	// Draws and clears the instances of every group
+	static void renderAll(std::unique_ptr<Camera> const & camera);
+
+	std::shared_ptr<Model> getModel() { return _model; };
+
+	void add(const Instance & instance) { _instances.push_back(instance); };
+
+	void render(std::unique_ptr<Camera> const & camera);
+
+private:
+	InstanceGroup(const std::string & modelPath, const char * vertexPath, const char * fragmentPath);
+
+	// Groups by model and shader paths
+	static std::unordered_map<std::string, std::unique_ptr<InstanceGroup>> _groups;
+
+	std::shared_ptr<Model> _model;
+	std::unique_ptr<Shader> _shader;
+	GLint _transparencyLocation;
+	GLint _dirlightLocation;
+
+	// Instances queued this frame, uploaded to _instanceBuffer to draw
+	std::vector<Instance> _instances;
+	GLuint _instanceBuffer;
+	size_t _capacity;
+};
@@ -19,7 +19,27 @@ Mesh::Mesh(const std::vector<Vertex>  &vertices,
 
 void Mesh::Draw(std::unique_ptr<Shader> const &shader)
 {
-  // Bind textures (last texture of specified type is used)
+  BindTextures(shader);
+
+  glBindVertexArray(_vao);
+  glDrawElements(GL_TRIANGLES, (GLsizei)_indices.size(), GL_UNSIGNED_INT, 0);
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::DrawInstanced(std::unique_ptr<Shader> const &shader, GLsizei count)
+{
+  BindTextures(shader);
+
+  glBindVertexArray(_vao);
+  glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)_indices.size(),
+    GL_UNSIGNED_INT, 0, count);
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::BindTextures(std::unique_ptr<Shader> const &shader)
+{
   for (GLuint i = 0; i < _textures.size(); i++)
   {
     glActiveTexture(GL_TEXTURE0 + i);
@@ -30,11 +50,6 @@ void Mesh::Draw(std::unique_ptr<Shader> const &shader)
 
     glBindTexture(GL_TEXTURE_2D, _textures[i].id);
   }
-
-  glBindVertexArray(_vao);
-  glDrawElements(GL_TRIANGLES, (GLsizei)_indices.size(), GL_UNSIGNED_INT, 0);
-  glBindVertexArray(0);
-  glActiveTexture(GL_TEXTURE0);
 }
 
 void Mesh::Draw(std::unique_ptr<Shader> const &shader, GLuint textureID)
@@ -59,6 +74,16 @@ void Mesh::DrawLine(std::unique_ptr<Shader> const &shader) {
 	glActiveTexture(GL_TEXTURE0);
 }
 
+void Mesh::CleanUp()
+{
+  glDeleteVertexArrays(1, &_vao);
+  glDeleteBuffers(1, &_vbo);
+  glDeleteBuffers(1, &_ebo);
+  _vao = 0;
+  _vbo = 0;
+  _ebo = 0;
+}
+
 // Binds mesh's VAO, VBO, and EBO data to corresponding buffers and sets the
 // attribute locations of position, normal, and texture coordinate data to
 // location 0, 1, and 2, respectively.
@@ -96,3 +121,27 @@ void Mesh::Setup()
 
   glBindVertexArray(0);
 }
+
+// Sets attribute locations 3 to 6 to the columns of each instance's model
+// matrix, and location 7 to its scale. Shaders that do not use them, like
+// those for drawing the mesh once, ignore them.
+void Mesh::SetInstanceBuffer(GLuint buffer)
+{
+  glBindVertexArray(_vao);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+  for (GLuint i = 0; i < 4; i++)
+  {
+    glEnableVertexAttribArray(3 + i);
+    glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+      (GLvoid*)(offsetof(Instance, model) + sizeof(glm::vec4) * i));
+    glVertexAttribDivisor(3 + i, 1);
+  }
+
+  glEnableVertexAttribArray(7);
+  glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+    (GLvoid*)offsetof(Instance, scale));
+  glVertexAttribDivisor(7, 1);
+
+  glBindVertexArray(0);
+}
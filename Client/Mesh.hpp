@@ -28,9 +28,23 @@ public:
   // Renders the mesh to the current framebuffer given texture ID.
   void Draw(std::unique_ptr<Shader> const &shader, GLuint textureID);
 
+  // Renders count instances of the mesh in one draw, with per-instance
+  // attributes from the buffer given to SetInstanceBuffer().
+  void DrawInstanced(std::unique_ptr<Shader> const &shader, GLsizei count);
+
+  // Sources per-instance attributes from buffer, an array of Instance.
+  void SetInstanceBuffer(GLuint buffer);
+
   // Renders the mesh into lines to the current framebuffer
   void DrawLine(std::unique_ptr<Shader> const &shader);
 
+  // Deletes the mesh's buffers. Copies of the mesh share them, so this is
+  // left to whoever owns the last one.
+  void CleanUp();
+
+  const std::vector<Vertex> &vertices() const { return _vertices; }
+  const std::vector<GLuint> &indices() const { return _indices; }
+
 private:
 
   std::vector<Vertex>  _vertices;
@@ -41,6 +55,9 @@ private:
 
   // Stores all relevant information about the mesh.
   void Setup();
+
+  // Binds textures to the shader's material (last texture of a type is used).
+  void BindTextures(std::unique_ptr<Shader> const &shader);
 };
 
 #endif /* MESH_HPP */
@@ -22,7 +22,17 @@ Model::~Model()
 
 void Model::render(std::unique_ptr<Shader> const &shader)
 {
-  for (Mesh mesh : _meshes) mesh.Draw(shader);
+  for (auto &mesh : _meshes) mesh.Draw(shader);
+}
+
+void Model::renderInstanced(std::unique_ptr<Shader> const &shader, GLsizei count)
+{
+  for (auto &mesh : _meshes) mesh.DrawInstanced(shader, count);
+}
+
+void Model::setInstanceBuffer(GLuint buffer)
+{
+  for (auto &mesh : _meshes) mesh.SetInstanceBuffer(buffer);
 }
 
 // Using Assimp, loads and post-processes model data such that all geometry
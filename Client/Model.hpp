@@ -26,6 +26,12 @@ public:
 
   void render(std::unique_ptr<Shader> const &shader) override;
 
+  // Renders count instances of the model, one draw per mesh.
+  void renderInstanced(std::unique_ptr<Shader> const &shader, GLsizei count);
+
+  // Sources per-instance attributes of every mesh from buffer.
+  void setInstanceBuffer(GLuint buffer);
+
   // Get mesh in _meshes at index i
   Mesh getMeshAt(int i);
 
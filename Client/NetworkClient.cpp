@@ -1,6 +1,7 @@
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
 
 #include "NetworkClient.hpp"
 #include "Shared/PlayerState.hpp"
@@ -13,6 +14,7 @@ NetworkClient::NetworkClient()
 	_updateQueue = std::make_unique<std::queue<std::shared_ptr<BaseState>>>();
 	_eventQueue = std::make_unique<BlockingQueue<std::shared_ptr<GameEvent>>>();
 	_socket = INVALID_SOCKET;
+	_wireFormat = WIRE_FORMAT_STANDARD;
 }
 
 
@@ -32,7 +34,7 @@ uint32_t NetworkClient::connect(std::string address, std::string port)
 	int iResult;
 
 	// Initialize Winsock version 2.2
-	Logger::getInstance()->debug("Initializing Winsock");
+	LOG_DEBUG("Initializing Winsock");
 
 	if ((iResult = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0)
 	{
@@ -93,15 +95,15 @@ uint32_t NetworkClient::connect(std::string address, std::string port)
 		// Assign socket
 		_socket = clientSock;
 
-		// Get player id from socket
+		// Get player id and offered wire formats from socket
 		int bytesRead = 0;
-		char playerId[sizeof(uint32_t)];
-		while (bytesRead < sizeof(uint32_t))
+		uint32_t handshake[2];
+		while (bytesRead < sizeof(handshake))
 		{
 			int recvResult = recv(
 					_socket,
-					playerId + bytesRead,
-					sizeof(playerId) - bytesRead,
+					(char*)handshake + bytesRead,
+					sizeof(handshake) - bytesRead,
 					0);
 
 			// We got data
@@ -117,6 +119,18 @@ uint32_t NetworkClient::connect(std::string address, std::string port)
 				throw(std::runtime_error("Error when receiving playerId"));
 			}
 		}
+		uint32_t playerId = handshake[0];
+
+		// Every server can send the standard format
+		_wireFormat = (handshake[1] & WIRE_FORMAT_BIT(PREFERRED_WIRE_FORMAT)) ?
+				PREFERRED_WIRE_FORMAT : WIRE_FORMAT_STANDARD;
+
+		// The server holds on to our updates until it knows the format, so
+		// this goes out before anything else
+		auto formatEvent = std::make_shared<GameEvent>();
+		formatEvent->type = EVENT_SET_WIRE_FORMAT;
+		formatEvent->wireFormat = _wireFormat;
+		_eventQueue->push(formatEvent);
 
 		// Threads are dependent on this variable to run
 		_isAlive = true;
@@ -131,18 +145,23 @@ uint32_t NetworkClient::connect(std::string address, std::string port)
 
 		Logger::getInstance()->info(
 				"Successfully connected to " + address + ":" + port +
-				" with playerId " + std::to_string(*(uint32_t*)playerId));
+				" with playerId " + std::to_string(playerId) +
+				(_wireFormat == WIRE_FORMAT_COMPACT ? " (compact updates)" : ""));
 
 		// Return player ID
-		return *(uint32_t*)playerId;
+		return playerId;
 	}
 }
 
 
 void NetworkClient::socketReadHandler()
 {
-	// Buffer for recv
-	char * readBuf = (char*)calloc(1, RECV_BUFSIZE);
+	// Baselines from an old connection mean nothing to this one
+	_baselines.clear();
+
+	// Buffer for recv. Grows to fit the largest packet seen so far, since the
+	// server sends a whole tick of updates (or the entire map) as one packet.
+	std::vector<char> readBuf(RECV_BUFSIZE);
 
 	// Iterate until thread interrupted
 	while (_isAlive)
@@ -169,7 +188,6 @@ void NetworkClient::socketReadHandler()
 						std::string("shutting down read thread"));
 
 				closeConnection();
-				free(readBuf);
 				return;
 			}
 		}
@@ -179,13 +197,17 @@ void NetworkClient::socketReadHandler()
 
 		// Grab next "length" bytes
 		bytesRead = 0;
+		if (length > readBuf.size())
+		{
+			readBuf.resize(length);
+		}
 
 		// Read until we've buffered the expected object
 		while (bytesRead < length)
 		{
 			int recvResult = recv(
 					_socket,
-					readBuf + bytesRead,
+					readBuf.data() + bytesRead,
 					length - bytesRead,
 					0);
 
@@ -200,28 +222,150 @@ void NetworkClient::socketReadHandler()
 						std::string("shutting down read thread"));
 
 				closeConnection();
-				free(readBuf);
 				return;
 			}
 		}
 
-		// Stream for deserialization
-		std::stringstream ss;
+		// Rebuild the states in the packet
+		uint32_t sequence = readSnapshot(readBuf.data(), length);
+		if (!sequence)
+		{
+			Logger::getInstance()->error(
+					"Received bad snapshot from server, " +
+					std::string("shutting down read thread"));
+
+			closeConnection();
+			return;
+		}
+
+		// Let the server know it can delta against this packet
+		auto ackEvent = std::make_shared<GameEvent>();
+		ackEvent->type = EVENT_SNAPSHOT_ACK;
+		ackEvent->sequence = sequence;
+		_eventQueue->push(ackEvent);
+	}
+
+	return;
+}
+
+
+uint32_t NetworkClient::readSnapshot(const char * packet, uint32_t length)
+{
+	const char * end = packet + length;
+
+	// Reads a plain value from the packet, failing if it runs out
+	auto readValue = [&packet, end](void * value, size_t size) -> bool
+	{
+		if ((size_t)(end - packet) < size)
+		{
+			return false;
+		}
+		memcpy(value, packet, size);
+		packet += size;
+		return true;
+	};
+
+	uint32_t sequence, recordCount;
+	if (!readValue(&sequence, sizeof(sequence)) ||
+		!readValue(&recordCount, sizeof(recordCount)))
+	{
+		return 0;
+	}
+
+	auto statePtrs = std::vector<std::shared_ptr<BaseState>>();
+	statePtrs.reserve(recordCount);
+
+	for (uint32_t i = 0; i < recordCount; i++)
+	{
+		uint32_t id, baseSequence, size;
+		uint8_t kind;
+		if (!readValue(&id, sizeof(id)) ||
+			!readValue(&kind, sizeof(kind)) ||
+			!readValue(&baseSequence, sizeof(baseSequence)) ||
+			!readValue(&size, sizeof(size)))
+		{
+			return 0;
+		}
+
+		// The server never uses anything older than baseSequence as a
+		// baseline again, so those states can go
+		auto& history = _baselines[id];
+		while (!history.empty() && history.front().first < baseSequence)
+		{
+			history.pop_front();
+		}
 
-		// Deserialize the object
-		ss.write(readBuf, RECV_BUFSIZE);
-		cereal::BinaryInputArchive iarchive(ss);
+		std::vector<char> data;
+		if (kind == STATE_RECORD_FULL)
+		{
+			if ((size_t)(end - packet) < size)
+			{
+				return 0;
+			}
+			data.assign(packet, packet + size);
+			packet += size;
+		}
+		else
+		{
+			// Baseline is now at the front of the history
+			if (history.empty() || history.front().first != baseSequence ||
+				history.front().second.size() != size)
+			{
+				Logger::getInstance()->error(
+						"Missing baseline " + std::to_string(baseSequence) +
+						" for entity " + std::to_string(id));
+				return 0;
+			}
+
+			data = history.front().second;
+			size_t used = StateDelta::apply(packet, end - packet, data.data(), size);
+			if (!used)
+			{
+				return 0;
+			}
+			packet += used;
+		}
+
+		// Deserialize the rebuilt state
+		std::stringstream ss;
+		ss.write(data.data(), data.size());
 		std::shared_ptr<BaseState> statePtr;
-		iarchive(statePtr);
+		if (_wireFormat == WIRE_FORMAT_COMPACT)
+		{
+			CompactInputArchive iarchive(ss);
+			iarchive(statePtr);
+		}
+		else
+		{
+			cereal::BinaryInputArchive iarchive(ss);
+			iarchive(statePtr);
+		}
+		statePtrs.push_back(statePtr);
 
-		// Lock and add to queue
-		std::unique_lock<std::mutex> lock(_updateMutex);
+		// Keep it around as a possible baseline. The server forgets destroyed
+		// entities once we ack them, so we can too.
+		if (statePtr->isDestroyed)
+		{
+			_baselines.erase(id);
+		}
+		else if (!history.empty() && history.back().first == sequence)
+		{
+			history.back().second = std::move(data);
+		}
+		else
+		{
+			history.push_back({ sequence, std::move(data) });
+		}
+	}
+
+	// Lock and add to queue
+	std::unique_lock<std::mutex> lock(_updateMutex);
+	for (auto& statePtr : statePtrs)
+	{
 		_updateQueue->push(statePtr);
-		lock.unlock();
 	}
 
-	free(readBuf);
-	return;
+	return sequence;
 }
 
 
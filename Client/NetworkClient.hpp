@@ -1,7 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <memory>
+#include <unordered_map>
 #include <stdlib.h>
 #include <stdio.h>
 #include <winsock2.h>
@@ -11,10 +13,15 @@
 #include "Shared/BaseState.hpp"
 #include "Shared/GameEvent.hpp"
 #include "Shared/BlockingQueue.hpp"
+#include "Shared/StateDelta.hpp"
+#include "Shared/WireFormat.hpp"
 
 #define RECV_BUFSIZE 8192
 #define SEND_BUFSIZE 8192
 
+// Format to ask the server for, if it offers it
+#define PREFERRED_WIRE_FORMAT WIRE_FORMAT_COMPACT
+
 /*
 ** Class to interact with a server over the network. Public documentation
 ** marked with "API".
@@ -103,7 +110,23 @@ private:
 	** to the socket.
 	*/
 	void socketWriteHandler();
-	
+
+	/*
+	** Rebuilds the states in a snapshot packet (see Shared/StateDelta.hpp)
+	** from its records and the baselines they reference, and adds them to
+	** _updateQueue. Returns the packet's sequence number, or zero if the
+	** packet is malformed or references a state we do not have.
+	*/
+	uint32_t readSnapshot(const char * packet, uint32_t length);
+
+	// Serialized states received for each entity, oldest first, along with
+	// the sequence number of the packet they came in. Only touched by the
+	// read thread.
+	std::unordered_map<uint32_t, std::deque<std::pair<uint32_t, std::vector<char>>>> _baselines;
+
+	// Format states are serialized in, agreed on when connecting
+	WireFormat _wireFormat;
+
 	// Blocking queue for events
 	std::unique_ptr<BlockingQueue<std::shared_ptr<GameEvent>>> _eventQueue;
 
@@ -0,0 +1,66 @@
+#include <algorithm>
+
+#include "RenderQueue.hpp"
+
+RenderQueue& RenderQueue::getInstance()
+{
+	static RenderQueue renderQueue;
+	return renderQueue;
+}
+
+void RenderQueue::submit(CBaseEntity * entity, RenderPass pass, std::unique_ptr<Camera> const &camera)
+{
+	// Entities that switch shaders themselves sort first, as shader 0
+	Shader * shader = entity->getShader();
+	uint64_t program = shader ? shader->program() & 0xFFFF : 0;
+
+	// Entities sharing a model are grouped by its address
+	uint64_t model = ((uintptr_t)entity->getDrawable() >> 4) & 0x3FFFFFFF;
+
+	float distance = glm::length(entity->getPos() - camera->position());
+	uint64_t depth = (uint64_t)(std::min(distance / RENDER_MAX_DEPTH, 1.0f) * 0xFFFF);
+
+	uint64_t key = (uint64_t)pass << 62;
+	if (pass == RENDER_OPAQUE)
+	{
+		key |= program << 46 | model << 16 | depth;
+	}
+	else
+	{
+		key |= (0xFFFF - depth) << 46 | program << 30 | model;
+	}
+
+	_packets[pass].push_back({ key, entity });
+}
+
+void RenderQueue::execute(RenderPass pass, std::unique_ptr<Camera> const &camera)
+{
+	auto& packets = _packets[pass];
+	std::sort(packets.begin(), packets.end(),
+		[](const DrawPacket & a, const DrawPacket & b)
+		{
+			return a.key < b.key;
+		});
+
+	// Program in use, or 0 if unknown
+	GLuint current = 0;
+	for (auto& packet : packets)
+	{
+		Shader * shader = packet.entity->getShader();
+		if (!shader)
+		{
+			packet.entity->render(camera);
+			current = 0;
+			continue;
+		}
+
+		if (shader->program() != current)
+		{
+			shader->Use();
+			current = shader->program();
+		}
+		packet.entity->draw(camera);
+	}
+
+	packets.clear();
+}
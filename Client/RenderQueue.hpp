@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "Camera.hpp"
+#include "CBaseEntity.hpp"
+
+// Distance from the camera past which draws all sort as equally far
+#define RENDER_MAX_DEPTH 256.0f
+
+enum RenderPass
+{
+	RENDER_OPAQUE,
+	RENDER_TRANSPARENT,
+
+	RENDER_PASS_COUNT
+};
+
+/*
+** Entities to draw this frame, in the order that switches shaders the least.
+** Entities are submitted with a 64-bit sort key, and execute() draws a pass in
+** key order, only switching shaders when an entity's differs from the last
+** one's. Shaders built from the same files share a program, so entities of a
+** kind draw back to back with one switch.
+**
+** Keys, from the most significant bit:
+** opaque       pass (2) | shader (16) | model (30) | depth (16), near first
+** transparent  pass (2) | depth (16), far first | shader (16) | model (30)
+** so opaque draws are grouped and roughly front to back within a group, and
+** transparent ones blend back to front as before.
+*/
+class RenderQueue
+{
+public:
+	static RenderQueue& getInstance();
+
+	// Queues an entity to draw in a pass
+	void submit(CBaseEntity * entity, RenderPass pass, std::unique_ptr<Camera> const &camera);
+
+	// Draws what was queued for a pass, in key order, and clears it
+	void execute(RenderPass pass, std::unique_ptr<Camera> const &camera);
+
+private:
+	RenderQueue() {};
+
+	struct DrawPacket
+	{
+		uint64_t key;
+		CBaseEntity * entity;
+	};
+
+	// Kept between frames, so they are not reallocated
+	std::vector<DrawPacket> _packets[RENDER_PASS_COUNT];
+};
@@ -14,8 +14,24 @@ out vec2 pass_uv;
 
 const int MAX_BONES = 100;
 
-uniform mat4 u_projection; 
-uniform mat4 u_view; 
+struct DirLight
+{
+  vec3 direction;
+
+  vec3 ambient;
+  vec3 diffuse;
+};
+
+// Camera and lights for the whole frame, see FrameUniforms.hpp
+layout(std140, binding = 0) uniform Frame
+{
+  mat4 u_projection;
+  mat4 u_view;
+  vec3 u_viewPos;
+  DirLight u_dirlights[2];
+  uint u_numdirlights;
+};
+
 uniform mat4 u_model;
 uniform mat4 u_bones[MAX_BONES];
 
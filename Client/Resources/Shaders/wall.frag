@@ -29,14 +29,23 @@ struct PointLight
   float quadratic;
 };
 
+// Camera and lights for the whole frame, see FrameUniforms.hpp
+layout(std140, binding = 0) uniform Frame
+{
+  mat4 u_projection;
+  mat4 u_view;
+  vec3 u_viewPos;
+  DirLight u_dirlights[2];
+  uint u_numdirlights;
+};
+
 // Lighting
-uniform uint u_numdirlights = 0;
+// Which of u_dirlights lights this draw
+uniform uint u_dirlight = 0;
 uniform uint u_numpointlights = 0;
 
-uniform DirLight   u_dirlight;
 uniform PointLight u_pointlight;
 uniform Material   u_material;
-uniform vec3       u_viewPos;
 uniform float      u_transparency = 1.0;
 
 // uniform int numBin = 30;
@@ -94,10 +103,10 @@ void main(void)
   
   vec3 resultCol = vec3(0); // Final color
 
-  // Calculate contribution of directional lights
-  for (uint i = 0; i < u_numdirlights; i++)
+  // Calculate contribution of the draw's directional light
+  if (u_dirlight < u_numdirlights)
   {
-    resultCol += CalcDirLight(u_dirlight, normal, viewDir);
+    resultCol += CalcDirLight(u_dirlights[u_dirlight], normal, viewDir);
   }
 
   // Calculate contribution of point lights
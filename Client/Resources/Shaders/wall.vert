@@ -4,8 +4,24 @@ layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec2 in_uv;
 
-uniform mat4 u_projection;
-uniform mat4 u_view;
+struct DirLight
+{
+  vec3 direction;
+
+  vec3 ambient;
+  vec3 diffuse;
+};
+
+// Camera and lights for the whole frame, see FrameUniforms.hpp
+layout(std140, binding = 0) uniform Frame
+{
+  mat4 u_projection;
+  mat4 u_view;
+  vec3 u_viewPos;
+  DirLight u_dirlights[2];
+  uint u_numdirlights;
+};
+
 uniform mat4 u_scale;
 uniform mat4 u_model;
 
@@ -0,0 +1,50 @@
+#version 440 core
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_uv;
+
+// Per instance
+layout(location = 3) in mat4 in_model;
+layout(location = 7) in vec3 in_scale;
+
+struct DirLight
+{
+  vec3 direction;
+
+  vec3 ambient;
+  vec3 diffuse;
+};
+
+// Camera and lights for the whole frame, see FrameUniforms.hpp
+layout(std140, binding = 0) uniform Frame
+{
+  mat4 u_projection;
+  mat4 u_view;
+  vec3 u_viewPos;
+  DirLight u_dirlights[2];
+  uint u_numdirlights;
+};
+
+out vec3 pass_fragPos;
+out vec3 pass_normal;
+out vec2 pass_uv;
+
+void main(void)
+{
+  vec4 worldPosition = vec4(in_position, 1.0f);
+
+  pass_fragPos = vec3(in_model * worldPosition);
+  pass_normal  = mat3(transpose(inverse(in_model))) * in_normal;
+
+  vec3 localPos = in_scale * in_position;
+  if (in_normal.x != 0) {
+	pass_uv = vec2(localPos.z, localPos.y);
+  } else if (in_normal.y != 0) {
+	pass_uv = vec2(localPos.x, localPos.z);
+  } else {
+	pass_uv = vec2(localPos.x, localPos.y);
+  }
+
+  gl_Position = u_projection * u_view * in_model * worldPosition;
+}
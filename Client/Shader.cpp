@@ -10,6 +10,12 @@
 #include <sstream>
 #include <string>
 
+std::unordered_map<std::string, std::weak_ptr<Shader::Program>> Shader::_programs;
+
+Shader::Program::~Program() {
+  glDeleteProgram(id);
+}
+
 Shader::Shader() : _program(0), _vertex_shader(0), _fragment_shader(0) {
 }
 
@@ -39,6 +45,10 @@ void Shader::LoadFromFile(GLenum type, const char* path) {
 }
 
 void Shader::LoadFromText(GLenum type, const char* code) {
+  _stages.emplace_back(type, code);
+}
+
+void Shader::Compile(GLenum type, const char* code) {
   GLuint shader = glCreateShader(type);
   glShaderSource(shader, 1, &code, nullptr);
   glCompileShader(shader);
@@ -66,6 +76,26 @@ void Shader::LoadFromText(GLenum type, const char* code) {
 }
 
 void Shader::CreateProgram() {
+  // Use the program of a shader with the same sources, if there still is one
+  std::string key;
+  for (auto& stage : _stages) {
+    key += std::to_string(stage.first) + "\n" + stage.second + "\n";
+  }
+  auto result = _programs.find(key);
+  if (result != _programs.end()) {
+    _shared = result->second.lock();
+  }
+  if (_shared) {
+    _program = _shared->id;
+    _stages.clear();
+    return;
+  }
+
+  for (auto& stage : _stages) {
+    Compile(stage.first, stage.second.c_str());
+  }
+  _stages.clear();
+
   // Create program, attach shaders, and link program
   GLuint program = glCreateProgram();
 
@@ -97,9 +127,13 @@ void Shader::CreateProgram() {
   _fragment_shader = 0;
 
   _program = program;
+  _shared = std::make_shared<Program>();
+  _shared->id = program;
 
   // Register uniform variables
   AutoRegisterUniforms();
+
+  _programs[key] = _shared;
 }
 
 void Shader::Use() const {
@@ -107,107 +141,136 @@ void Shader::Use() const {
 }
 
 void Shader::set_uniform(const char* uniform, GLint value) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform1iv(_uniforms.at(uniform), 1, &value);
+  glUniform1iv(u_elem->second, 1, &value);
 }
 
 void Shader::set_uniform(const char* uniform, GLuint value) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform1uiv(_uniforms.at(uniform), 1, &value);
+  glUniform1uiv(u_elem->second, 1, &value);
 }
 
 void Shader::set_uniform(const char* uniform, GLfloat value) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform1fv(_uniforms.at(uniform), 1, &value);
+  glUniform1fv(u_elem->second, 1, &value);
 }
 
 void Shader::set_uniform(const char* uniform, const glm::vec2& values) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform2fv(_uniforms.at(uniform), 1, &values[0]);
+  glUniform2fv(u_elem->second, 1, &values[0]);
 }
 
 void Shader::set_uniform(const char* uniform, const glm::vec3& values) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform3fv(_uniforms.at(uniform), 1, &values[0]);
+  glUniform3fv(u_elem->second, 1, &values[0]);
 }
 
 void Shader::set_uniform(const char* uniform, const glm::vec4& values) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniform4fv(_uniforms.at(uniform), 1, &values[0]);
+  glUniform4fv(u_elem->second, 1, &values[0]);
 }
 
 void Shader::set_uniform(const char* uniform, const glm::mat3& mat) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniformMatrix3fv(_uniforms.at(uniform), 1, GL_FALSE, &mat[0][0]);
+  glUniformMatrix3fv(u_elem->second, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::set_uniform(const char* uniform, const glm::mat4& mat) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniformMatrix4fv(_uniforms.at(uniform), 1, GL_FALSE, &mat[0][0]);
+  glUniformMatrix4fv(u_elem->second, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::set_uniform(const char* uniform, const std::vector<glm::mat4>& mats,
   const GLuint count) {
-  auto u_elem = _uniforms.find(uniform);
-  if (u_elem == _uniforms.end()) {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
     Logger::getInstance()->error(
       "Attempting to set unregistered uniform: " +
       std::string(uniform));
     return;
   }
-  glUniformMatrix4fv(_uniforms.at(uniform), count, GL_FALSE, &mats[0][0][0]);
+  glUniformMatrix4fv(u_elem->second, count, GL_FALSE, &mats[0][0][0]);
+}
+
+GLint Shader::uniform_location(const char* uniform) const {
+  auto u_elem = _shared->uniforms.find(uniform);
+  if (u_elem == _shared->uniforms.end()) {
+    return -1;
+  }
+  return u_elem->second;
+}
+
+void Shader::set_uniform(GLint location, GLint value) {
+  glUniform1i(location, value);
+}
+
+void Shader::set_uniform(GLint location, GLuint value) {
+  glUniform1ui(location, value);
+}
+
+void Shader::set_uniform(GLint location, GLfloat value) {
+  glUniform1f(location, value);
+}
+
+void Shader::set_uniform(GLint location, const glm::vec3& values) {
+  glUniform3fv(location, 1, &values[0]);
+}
+
+void Shader::set_uniform(GLint location, const glm::mat4& mat) {
+  glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::CleanUp() {
-  glDeleteProgram(_program);
+  // The program goes with the last shader using it
+  _shared = nullptr;
   glDeleteShader(_vertex_shader);
   glDeleteShader(_fragment_shader);
   _program = 0;
@@ -232,7 +295,7 @@ void Shader::RegisterUniform(const char* uniform) {
   }
   else
   {
-    _uniforms.emplace(std::string(uniform), uniform_loc);
+    _shared->uniforms.emplace(std::string(uniform), uniform_loc);
     //Logger::getInstance()->info("For program " + std::to_string(_program) + ": \""
     //  + std::string(uniform) + "\" registered.");
   }
@@ -260,6 +323,14 @@ void Shader::AutoRegisterUniforms()
   {
     glGetActiveUniform(_program, static_cast<GLuint>(i), uniform_name_max_len,
       &length, &size, &type, name.data());
+
+    // Members of uniform blocks are set through their buffer, not here
+    GLuint index = static_cast<GLuint>(i);
+    GLint block;
+    glGetActiveUniformsiv(_program, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block);
+    if (block != -1)
+      continue;
+
     RegisterUniform(name.data());
   }
 }
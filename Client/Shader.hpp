@@ -9,6 +9,8 @@
 #include <glm/glm.hpp>
 
 #include <vector>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <initializer_list>
 
@@ -21,6 +23,12 @@ public:
 
   void LoadFromFile(GLenum type, const char *path);
   void LoadFromText(GLenum type, const char *code);
+
+  /**
+   * \brief Compiles and links the loaded sources. Shaders loaded from the same
+   * sources share one program, so entities drawing alike can be drawn without
+   * switching programs in between.
+   */
   void CreateProgram();
 
   void Use() const;
@@ -38,18 +46,51 @@ public:
   void set_uniform(const char *uniform, const std::vector<glm::mat4> &mats,
     const GLuint count);
 
+  /**
+   * \brief Location of a uniform, looked up once so per-draw values can be
+   * set with the overloads below without looking up the name every time.
+   * -1 if the shader has no such uniform, which the setters ignore like GL does.
+   */
+  GLint uniform_location(const char *uniform) const;
+
+  void set_uniform(GLint location, GLint value);
+  void set_uniform(GLint location, GLuint value);
+  void set_uniform(GLint location, GLfloat value);
+  void set_uniform(GLint location, const glm::vec3 &values);
+  void set_uniform(GLint location, const glm::mat4 &mat);
+
   void CleanUp();
 
   GLuint program();
 
 private:
 
+  // A linked program and its uniforms, deleted with the last Shader using it
+  struct Program
+  {
+    GLuint id = 0;
+
+    // Map of uniform names to locations
+    std::unordered_map<std::string, GLint> uniforms;
+
+    ~Program();
+  };
+
+  // Programs by the sources they were built from
+  static std::unordered_map<std::string, std::weak_ptr<Program>> _programs;
+
+  std::shared_ptr<Program> _shared;
   GLuint _program;
   GLuint _vertex_shader;
   GLuint _fragment_shader;
 
-  // Map of uniform names to locations
-  std::unordered_map<std::string, GLint> _uniforms;
+  // Sources loaded since the last CreateProgram(), by type
+  std::vector<std::pair<GLenum, std::string>> _stages;
+
+  /**
+   * \brief Compiles one stage of the program.
+   */
+  void Compile(GLenum type, const char* code);
 
   /**
    * \brief Finds and stores the specified uniform variable's location in the shader program.
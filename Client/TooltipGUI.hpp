@@ -47,6 +47,9 @@ public:
 			_quadFrameBuffer->drawQuad(_quadShader, _trappedTooltipTexture);
 			break;
 		}
+
+		// Other images share the program, and are drawn opaque
+		_quadShader->set_uniform("alpha", 1.0f);
 	}
 
 	void setTooltip(PlayerTooltip tooltip)
@@ -14,4 +14,11 @@ struct Vertex
   glm::vec2 tex_coord;
 };
 
+// Per-instance attributes of an instanced draw
+struct Instance
+{
+  glm::mat4 model; // Locations 3 to 6, a column each
+  glm::vec3 scale; // Location 7
+};
+
 #endif
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 #include <memory>
 
-#include "Shared/QuadTree.hpp"
+#include "Shared/BroadPhase.hpp"
 #include "Shared/BaseState.hpp"
 
 #define COLLISION_THRESHOLD 0.001
@@ -21,11 +21,12 @@ public:
 
 	~BaseCollider() {};
 
-	// Checks for ANY collision with objects inside a quadtree
-	bool isColliding(QuadTree & tree)
+	// Checks for ANY collision with objects inside a broad phase
+	bool isColliding(BroadPhase & tree)
 	{
-		// TODO: cache results
-		for (auto& candidate : broadPhase(tree))
+		_candidates.clear();
+		broadPhase(tree, _candidates);
+		for (auto& candidate : _candidates)
 		{
 			if (narrowPhase(candidate))
 			{
@@ -41,21 +42,18 @@ public:
 		return narrowPhase(state);
 	};
 
-	// Gets a vector of all colliding objects
-	std::vector<BaseState*> getColliding(QuadTree & tree)
+	// Appends all colliding objects to results
+	void getColliding(BroadPhase & tree, std::vector<BaseState*> & results)
 	{
-		auto resultVec = std::vector<BaseState*>();
-
-		// TODO: cache results
-		for (auto& candidate : broadPhase(tree))
+		_candidates.clear();
+		broadPhase(tree, _candidates);
+		for (auto& candidate : _candidates)
 		{
 			if (narrowPhase(candidate))
 			{
-				resultVec.push_back(candidate);
+				results.push_back(candidate);
 			}
 		}
-
-		return resultVec;
 	};
 
 	// Handle push-back between entities. By default, does nothing
@@ -64,13 +62,18 @@ public:
 protected:
 	BaseState* _state;
 
-	// Broad-phase collision detection always uses a QuadTree
-	virtual std::vector<BaseState*> broadPhase(QuadTree & tree)
+	// Broad-phase collision detection goes through the given structure. Appends
+	// possible collisions to candidates.
+	virtual void broadPhase(BroadPhase & tree, std::vector<BaseState*> & candidates)
 	{
-		return tree.query(_state);
+		tree.query(_state, candidates);
 	};
 
 	// Only function that colliders need to implement
 	virtual bool narrowPhase(BaseState* candidate) = 0;
+
+private:
+	// Reused between checks so that broad phase does not allocate
+	std::vector<BaseState*> _candidates;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cfloat>
 #include "BaseCollider.hpp"
 
 // At the moment this is NOT a capsule collider, but a 2D circle collider. For
@@ -55,7 +56,7 @@ public:
 				}
 
 				// Corners
-				if (std::sqrtf((float)(std::pow(distX - candidate->width / 2, 2) +
+				if (std::sqrt((float)(std::pow(distX - candidate->width / 2, 2) +
 					std::pow(distZ - candidate->depth / 2, 2))) <= r1 - COLLISION_THRESHOLD)
 				{
 					return true;
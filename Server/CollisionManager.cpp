@@ -1,104 +1,226 @@
-#include <unordered_set>
+#include <algorithm>
 #include <random>
 #include "CollisionManager.hpp"
+#include "Profiler.hpp"
 #include "SDogEntity.hpp"
 
-// Allow pairs inside unordered_set
-struct PairHash
-{
-	template <class T1, class T2>
-	std::size_t operator () (std::pair<T1, T2> const &pair) const
-	{
-		std::size_t h1 = std::hash<T1>()(pair.first);
-		std::size_t h2 = std::hash<T2>()(pair.second);
-
-		return h1 ^ h2;
-	}
-};
-
 CollisionManager::CollisionManager(
-	std::unordered_map<uint32_t, std::shared_ptr<SBaseEntity>>* entityMap)
+	StructureInfo* structureInfo,
+	BroadPhaseType broadPhaseType)
 {
-	_entityMap = entityMap;
+	_structureInfo = structureInfo;
+	_entities = structureInfo->entities;
+	_broadPhaseType = broadPhaseType;
+
+	loadStaticGeometry();
 }
 
 CollisionManager::~CollisionManager()
 {
 }
 
-void CollisionManager::handleCollisions()
+void CollisionManager::loadStaticGeometry()
 {
-	// Build quadtree
-	auto tree = new QuadTree({ glm::vec2(0), MAP_WIDTH / 2 });
-	for (auto& entityPair : *_entityMap)
+	auto boundary = BoundingBox({ glm::vec2(0), MAP_WIDTH / 2 });
+	_staticTree = BroadPhase::create(_broadPhaseType, boundary, _structureInfo->gridWidth);
+	_sweepAndPrune.clear();
+
+	auto& states = _entities->getStates();
+	auto& flags = _entities->getFlags();
+	for (size_t i = 0; i < states.size(); i++)
 	{
-		// Only insert if it has a collider
-		auto entityState = entityPair.second->getState().get();
-		if (entityState->colliderType != COLLIDER_NONE)
+		if (states[i]->isStatic && states[i]->colliderType != COLLIDER_NONE)
+		{
+			flags[i] |= ENTITY_FLAG_STATIC_GEOMETRY;
+			_staticTree->update(states[i]);
+		}
+		else
 		{
-			tree->insert(entityState);
+			flags[i] &= ~ENTITY_FLAG_STATIC_GEOMETRY;
 		}
 	}
+}
 
-	auto collisionSet = std::unordered_set<std::pair<BaseState*, BaseState*>, PairHash>();
+void CollisionManager::removeEntity(uint32_t id)
+{
+	_staticTree->remove(id);
+	_sweepAndPrune.remove(id);
+}
+
+void CollisionManager::findContacts()
+{
+	_contacts.clear();
 
-	// Build set of pairs of collisions
-	for (auto& entityPair : *_entityMap)
 	{
-		auto entity = entityPair.second;
+		// Static lookups run their colliders' checks as they go
+		ProfileScope scope(PROFILE_BROAD_PHASE);
 
-		// Only run collision check if not static
-		if (!entity->getState()->isStatic)
+		// Level geometry is only ever collided with, so each non-static entity
+		// looks itself up in the static tree
+		for (auto& entity : _movers)
 		{
-			for (auto& collidingEntity : entity->getColliding(*tree))
+			_colliding.clear();
+			entity->getColliding(*_staticTree, _colliding);
+			for (auto& collidingState : _colliding)
 			{
-				collisionSet.insert({ entity->getState().get(), collidingEntity });
+				auto collidingEntity = _entities->find(collidingState->id);
+				_contacts.push_back({ entity, collidingEntity,
+					entity->getState()->id, collidingState->id });
 			}
 		}
+
+		// Everything else comes out of the sweep, one pair at a time
+		_sweepAndPrune.findPairs(_pairs);
+	}
+
+	ProfileScope scope(PROFILE_NARROW_PHASE);
+	for (auto& pair : _pairs)
+	{
+		auto stateA = pair.first;
+		auto stateB = pair.second;
+
+		if (stateA->isStatic && stateB->isStatic)
+		{
+			continue;
+		}
+
+		// Non-static entity first, or lowest ID first if both are
+		if (stateA->isStatic || (!stateB->isStatic && stateB->id < stateA->id))
+		{
+			std::swap(stateA, stateB);
+		}
+
+		auto entityA = _entities->find(stateA->id);
+		auto entityB = _entities->find(stateB->id);
+
+		// Colliders are not always symmetric, so give B's collider a chance
+		// if it is allowed to run its own check
+		if (entityA->isColliding(stateB))
+		{
+			_contacts.push_back({ entityA, entityB, stateA->id, stateB->id });
+		}
+		else if (!stateB->isStatic && entityB->isColliding(stateA))
+		{
+			_contacts.push_back({ entityB, entityA, stateB->id, stateA->id });
+		}
 	}
 
-	// Iterate until no collisions
-	while (!collisionSet.empty())
+	// Resolve in the same order regardless of the order entities are stored in
+	std::sort(_contacts.begin(), _contacts.end(),
+		[](const Contact & a, const Contact & b)
 	{
-		auto collisionPair = (collisionSet.begin());
-		auto stateA = collisionPair->first;
-		auto stateB = collisionPair->second;
+		return a.idA < b.idA || (a.idA == b.idA && a.idB < b.idB);
+	});
+}
 
-		// Erase from beginning
-		collisionSet.erase(collisionPair);
+void CollisionManager::handleCollisions()
+{
+	{
+		ProfileScope scope(PROFILE_BROAD_PHASE);
+
+		// Bring the sweep up to date with this tick's positions. Level geometry
+		// never moves, so it is already in the static tree.
+		_movers.clear();
+		auto& entities = _entities->getEntities();
+		auto& states = _entities->getStates();
+		auto& flags = _entities->getFlags();
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			// Level geometry is static, so can be skipped without looking at it
+			if (flags[i] & ENTITY_FLAG_STATIC_GEOMETRY)
+			{
+				continue;
+			}
 
-		// Find A and B entities
-		auto entityA = _entityMap->find(stateA->id)->second;
-		auto entityB = _entityMap->find(stateB->id)->second;
+			// Only insert if it has a collider
+			if (states[i]->colliderType != COLLIDER_NONE)
+			{
+				_sweepAndPrune.update(states[i]);
+			}
 
-		// First handle bounce-off
-		entityA->handlePushBack(entityB.get());
+			// Only run collision checks for entities that are not static
+			if (!states[i]->isStatic)
+			{
+				_movers.push_back(entities[i].get());
+			}
+		}
 
-		entityA->hasChanged = true;
+		// Drops deleted entities, and ones that lost their collider
+		_sweepAndPrune.removeStale();
+	}
 
-		// Remove duplicates (e.g. <A,B> vs <B,A> if both players)
-		if (!stateB->isStatic)
+	_handledPairs.clear();
+	for (int i = 0; i < COLLISION_SOLVER_ITERATIONS; i++)
+	{
+		findContacts();
+
+		bool isResolved = true;
 		{
-			collisionSet.erase({ stateB, stateA });
+			ProfileScope scope(PROFILE_NARROW_PHASE);
+
+			size_t handledCount = _handledPairs.size();
 
-			// Mark as changed
-			entityB->hasChanged = true;
+			for (auto& contact : _contacts)
+			{
+				auto stateA = contact.entityA->getState().get();
+				auto stateB = contact.entityB->getState().get();
+
+				auto key = std::make_pair(
+					std::min(contact.idA, contact.idB),
+					std::max(contact.idA, contact.idB));
+				bool isNew = !std::binary_search(
+					_handledPairs.begin(), _handledPairs.begin() + handledCount, key);
+
+				// Earlier contacts may have pushed these two apart already
+				bool isSolid = stateA->getSolidity(stateB) && stateB->getSolidity(stateA);
+				bool needsPushBack = isSolid && contact.entityA->isColliding(stateB);
+
+				if (!isNew && !needsPushBack)
+				{
+					continue;
+				}
+
+				// First handle bounce-off
+				if (needsPushBack)
+				{
+					contact.entityA->handlePushBack(contact.entityB);
+					isResolved = false;
+				}
+
+				// Mark as changed
+				contact.entityA->markChanged();
+				if (!stateB->isStatic)
+				{
+					contact.entityB->markChanged();
+				}
+
+				// General collision logic, only once per pair per tick
+				if (isNew)
+				{
+					contact.entityA->handleCollision(contact.entityB);
+					contact.entityB->handleCollision(contact.entityA);
+					_handledPairs.push_back(key);
+				}
+			}
+
+			std::sort(_handledPairs.begin(), _handledPairs.end());
 		}
 
-		// General collision logic
-		entityA->handleCollision(entityB.get());
-		entityB->handleCollision(entityA.get());
+		// Nothing was pushed, so nothing new can be overlapping
+		if (isResolved)
+		{
+			break;
+		}
 
-		// Re-check for colliding
-		for (auto& collidingEntity : entityA->getColliding(*tree))
+		// Pick up the pushed positions before looking again
+		ProfileScope scope(PROFILE_BROAD_PHASE);
+		for (auto& entity : _movers)
 		{
-			// Only re-add if solid
-			if (stateA->getSolidity(collidingEntity) && collidingEntity->getSolidity(stateA))
+			auto entityState = entity->getState().get();
+			if (entityState->colliderType != COLLIDER_NONE)
 			{
-				collisionSet.insert({ entityA->getState().get(), collidingEntity });
+				_sweepAndPrune.update(entityState);
 			}
 		}
 	}
-
-	delete tree;
-}
\ No newline at end of file
+}
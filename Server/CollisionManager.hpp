@@ -1,8 +1,17 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <unordered_map>
+#include "Shared/BroadPhase.hpp"
+#include "Shared/SweepAndPrune.hpp"
 #include "SBaseEntity.hpp"
+#include "StructureInfo.hpp"
+
+// Max number of times contacts are found and pushed apart each tick. Anything
+// still overlapping after that is left for the next tick, so a pile-up cannot
+// stall the update loop.
+#define COLLISION_SOLVER_ITERATIONS 4
 
 /**
   * Basic class to handle collisions between all entities on the server
@@ -10,18 +19,60 @@
 class CollisionManager
 {
 public:
-	// Constructs a new manager. Requires raw pointers to the server-wide
-	// entity map and the vector of jail locations.
+	// Constructs a new manager over the server-wide structures, which must
+	// already hold a parsed level. broadPhaseType picks the structure used
+	// to find collision candidates.
 	CollisionManager(
-		std::unordered_map<uint32_t, std::shared_ptr<SBaseEntity>>* entityMap);
+		StructureInfo* structureInfo,
+		BroadPhaseType broadPhaseType = DEFAULT_BROAD_PHASE);
 
 	~CollisionManager();
 
-	// Iterates over every non-static entity on the server and resolves
-	// collisions on a pair-wise basis
+	// Finds every pair of colliding entities where at least one is not
+	// static, then pushes solid ones apart. Collision handlers run once per
+	// pair, and pairs are always resolved in the same order.
 	void handleCollisions();
 
+	// Builds the static broad phase from every static entity in the store.
+	// Call whenever a level has been loaded.
+	void loadStaticGeometry();
+
+	// Call before an entity is erased from the store
+	void removeEntity(uint32_t id);
+
 private:
-	std::unordered_map<uint32_t, std::shared_ptr<SBaseEntity>>* _entityMap;
+	StructureInfo* _structureInfo;
+	EntityStore* _entities;
+
+	// Colliding pair, with the entity whose collider found the collision
+	// first. Only A is guaranteed to be non-static.
+	struct Contact
+	{
+		SBaseEntity* entityA;
+		SBaseEntity* entityB;
+		uint32_t idA, idB;
+	};
+
+	// Fills _contacts with everything currently colliding, sorted by ID
+	void findContacts();
+
+	// Level geometry goes in the static tree once per level load. Everything
+	// else with a collider goes in the sweep, which is kept up to date every
+	// tick.
+	BroadPhaseType _broadPhaseType;
+	std::unique_ptr<BroadPhase> _staticTree;
+	SweepAndPrune _sweepAndPrune;
+
+	// Non-static entities, gathered at the start of each tick
+	std::vector<SBaseEntity*> _movers;
+
+	std::vector<Contact> _contacts;
+	std::vector<std::pair<BaseState*, BaseState*>> _pairs;
+
+	// Pairs of IDs, lowest first, whose collision handlers ran this tick
+	std::vector<std::pair<uint32_t, uint32_t>> _handledPairs;
+
+	// Results of the current collision query
+	std::vector<BaseState*> _colliding;
 };
 
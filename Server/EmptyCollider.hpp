@@ -9,9 +9,8 @@ public:
 	EmptyCollider() {};
 
 	// Override broad phase and narrow phase to return nothing
-	std::vector<BaseState*> broadPhase(QuadTree& tree) override
+	void broadPhase(BroadPhase& tree, std::vector<BaseState*> & candidates) override
 	{
-		return std::vector<BaseState*>();
 	}
 
 	bool narrowPhase(BaseState* candidate) override
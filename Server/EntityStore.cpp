@@ -0,0 +1,198 @@
+#include <algorithm>
+
+#include "EntityStore.hpp"
+
+EntityHandle EntityStore::insert(std::shared_ptr<SBaseEntity> entity)
+{
+	uint32_t id = entity->getState()->id;
+
+	auto it = _idToSlot.find(id);
+	if (it != _idToSlot.end())
+	{
+		return EntityHandle({ it->second, _slots[it->second].generation });
+	}
+
+	// Reuse a free slot, or add one
+	uint32_t slotIndex;
+	if (_freeSlot != UINT32_MAX)
+	{
+		slotIndex = _freeSlot;
+		_freeSlot = _slots[slotIndex].denseIndex;
+	}
+	else
+	{
+		slotIndex = (uint32_t)_slots.size();
+		_slots.push_back({ 0, 1 });
+	}
+
+	auto& slot = _slots[slotIndex];
+	slot.denseIndex = (uint32_t)_entities.size();
+
+	_states.push_back(entity->getState().get());
+	_entities.push_back(std::move(entity));
+	_ids.push_back(id);
+	_flags.push_back(0);
+	_slotIndices.push_back(slotIndex);
+
+	_idToSlot.insert({ id, slotIndex });
+
+	auto added = _entities.back().get();
+	added->_store = this;
+	if (added->_hasChanged)
+	{
+		_changed.push_back(added);
+	}
+	if (added->getState()->isDestroyed)
+	{
+		_destroyed.push_back(id);
+	}
+	if (added->isAwake())
+	{
+		added->_isActive = true;
+		_active.push_back(added);
+	}
+
+	return EntityHandle({ slotIndex, slot.generation });
+}
+
+void EntityStore::erase(uint32_t id)
+{
+	auto it = _idToSlot.find(id);
+	if (it == _idToSlot.end())
+	{
+		return;
+	}
+
+	uint32_t slotIndex = it->second;
+	uint32_t denseIndex = _slots[slotIndex].denseIndex;
+	_idToSlot.erase(it);
+
+	auto erased = _entities[denseIndex].get();
+	erased->_store = nullptr;
+	if (erased->_hasChanged)
+	{
+		_changed.erase(std::find(_changed.begin(), _changed.end(), erased));
+	}
+	if (erased->_isActive)
+	{
+		erased->_isActive = false;
+		_active.erase(std::find(_active.begin(), _active.end(), erased));
+	}
+
+	// Fill the gap with the last entity
+	uint32_t last = (uint32_t)_entities.size() - 1;
+	if (denseIndex != last)
+	{
+		_entities[denseIndex] = std::move(_entities[last]);
+		_ids[denseIndex] = _ids[last];
+		_states[denseIndex] = _states[last];
+		_flags[denseIndex] = _flags[last];
+		_slotIndices[denseIndex] = _slotIndices[last];
+		_slots[_slotIndices[denseIndex]].denseIndex = denseIndex;
+	}
+
+	// Entity is destroyed here, once the store is consistent again, in case
+	// its destructor looks anything up
+	auto entity = std::move(_entities.back());
+	_entities.pop_back();
+	_ids.pop_back();
+	_states.pop_back();
+	_flags.pop_back();
+	_slotIndices.pop_back();
+
+	// Outstanding handles no longer match. Generation 0 is never handed out.
+	auto& slot = _slots[slotIndex];
+	if (++slot.generation == 0)
+	{
+		slot.generation = 1;
+	}
+	slot.denseIndex = _freeSlot;
+	_freeSlot = slotIndex;
+}
+
+void EntityStore::clear()
+{
+	// Invalidate every handle, keeping the slots for reuse
+	for (auto& slotIndex : _slotIndices)
+	{
+		auto& slot = _slots[slotIndex];
+		if (++slot.generation == 0)
+		{
+			slot.generation = 1;
+		}
+		slot.denseIndex = _freeSlot;
+		_freeSlot = slotIndex;
+	}
+
+	for (auto& entity : _entities)
+	{
+		entity->_store = nullptr;
+		entity->_isActive = false;
+	}
+	_changed.clear();
+	_destroyed.clear();
+	_active.clear();
+
+	_ids.clear();
+	_states.clear();
+	_flags.clear();
+	_slotIndices.clear();
+	_idToSlot.clear();
+
+	// Last, so entity destructors see an empty store
+	auto entities = std::move(_entities);
+	_entities.clear();
+}
+
+void EntityStore::clearChanged()
+{
+	for (auto& entity : _changed)
+	{
+		entity->_hasChanged = false;
+	}
+	_changed.clear();
+}
+
+void EntityStore::removeSleeping()
+{
+	_active.erase(std::remove_if(_active.begin(), _active.end(),
+		[](SBaseEntity * entity)
+		{
+			if (entity->_isAwake)
+			{
+				return false;
+			}
+			entity->_isActive = false;
+			return true;
+		}), _active.end());
+}
+
+SBaseEntity * EntityStore::find(uint32_t id)
+{
+	auto it = _idToSlot.find(id);
+	if (it == _idToSlot.end())
+	{
+		return nullptr;
+	}
+	return _entities[_slots[it->second].denseIndex].get();
+}
+
+SBaseEntity * EntityStore::get(EntityHandle handle)
+{
+	if (handle.index >= _slots.size() ||
+		_slots[handle.index].generation != handle.generation)
+	{
+		return nullptr;
+	}
+	return _entities[_slots[handle.index].denseIndex].get();
+}
+
+EntityHandle EntityStore::getHandle(uint32_t id)
+{
+	auto it = _idToSlot.find(id);
+	if (it == _idToSlot.end())
+	{
+		return EntityHandle();
+	}
+	return EntityHandle({ it->second, _slots[it->second].generation });
+}
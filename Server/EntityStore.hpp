@@ -0,0 +1,125 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+#include "SBaseEntity.hpp"
+
+// Per-entity flags kept in the store rather than on the entity, so passes
+// over every entity can test them without touching the entity itself
+#define ENTITY_FLAG_STATIC_GEOMETRY 0x1	// Part of the level's static broad phase
+
+/*
+** Refers to an entity in an EntityStore. Unlike an index, it keeps referring
+** to the same entity as others come and go, and once that entity is erased it
+** refers to nothing, even when its slot is reused.
+*/
+struct EntityHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;	// 0 never refers to an entity
+
+	bool isSet() { return generation != 0; };
+};
+
+/*
+** Every entity in a room, packed densely so per-tick passes are linear scans.
+** Entity i's ID, state, flags and the entity itself sit at index i of
+** parallel arrays, and iterating the store walks them in that order.
+**
+** Erasing moves the last entity into the gap, so indices are only good until
+** the next erase. Hold on to an entity across ticks by handle or ID instead.
+**
+** Entities add themselves to the store's changed and destroyed lists with
+** SBaseEntity::markChanged() and destroy(), so sending updates and deleting
+** entities at the end of a tick only costs as much as what happened in it.
+** Likewise, the active list holds only entities that are awake, so walls,
+** floors and other scenery are never visited by the update pass.
+*/
+class EntityStore
+{
+public:
+	EntityStore() {};
+	~EntityStore() {};
+
+	// Adds an entity under the ID in its state. If one with that ID is
+	// already stored, it is kept and entity is not added. An entity that was
+	// changed or destroyed before being added goes on the lists now.
+	EntityHandle insert(std::shared_ptr<SBaseEntity> entity);
+
+	// Removes the entity with this ID, if any. Moves another entity into its
+	// place, so do not call while iterating.
+	void erase(uint32_t id);
+
+	void clear();
+
+	// Lookups return nullptr if there is no such entity
+	SBaseEntity * find(uint32_t id);
+	SBaseEntity * get(EntityHandle handle);
+
+	// Handle of the entity with this ID, or an unset one
+	EntityHandle getHandle(uint32_t id);
+
+	size_t size() { return _entities.size(); };
+	bool empty() { return _entities.empty(); };
+
+	// Entities in dense order
+	std::vector<std::shared_ptr<SBaseEntity>>::iterator begin() { return _entities.begin(); };
+	std::vector<std::shared_ptr<SBaseEntity>>::iterator end() { return _entities.end(); };
+
+	// Dense arrays, in the same order as iteration
+	const std::vector<std::shared_ptr<SBaseEntity>> & getEntities() { return _entities; };
+	const std::vector<uint32_t> & getIds() { return _ids; };
+	const std::vector<BaseState*> & getStates() { return _states; };
+	std::vector<uint8_t> & getFlags() { return _flags; };
+
+	// Entities marked as changed since clearChanged(), in the order they were
+	// marked
+	const std::vector<SBaseEntity*> & getChanged() { return _changed; };
+
+	// Unmarks every changed entity and empties the list
+	void clearChanged();
+
+	// Entities to update this tick, in the order they were added or woken.
+	// Entities woken while it is walked are appended, and ones that fall
+	// asleep stay on it until removeSleeping().
+	const std::vector<SBaseEntity*> & getActive() { return _active; };
+
+	// Drops entities that fell asleep from the active list, keeping order
+	void removeSleeping();
+
+	// IDs of entities destroyed and not yet erased. Erasing them may destroy
+	// more, which are appended; the caller empties the list when done.
+	std::vector<uint32_t> & getDestroyed() { return _destroyed; };
+
+private:
+	friend class SBaseEntity;
+
+	// Maps handles to dense indices. Free slots are chained through
+	// denseIndex.
+	struct Slot
+	{
+		uint32_t denseIndex;
+		uint32_t generation;
+	};
+
+	// Dense arrays
+	std::vector<std::shared_ptr<SBaseEntity>> _entities;
+	std::vector<uint32_t> _ids;
+	std::vector<BaseState*> _states;
+	std::vector<uint8_t> _flags;
+	std::vector<uint32_t> _slotIndices;	// Slot of each dense entry
+
+	std::vector<Slot> _slots;
+	uint32_t _freeSlot = UINT32_MAX;
+
+	// Entity IDs come from a server-wide generator, so are looked up by hash
+	std::unordered_map<uint32_t, uint32_t> _idToSlot;
+
+	// Filled by the entities themselves
+	std::vector<SBaseEntity*> _changed;
+	std::vector<uint32_t> _destroyed;
+	std::vector<SBaseEntity*> _active;
+};
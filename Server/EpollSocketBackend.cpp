@@ -0,0 +1,70 @@
+#include "EpollSocketBackend.hpp"
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+
+EpollSocketBackend::EpollSocketBackend()
+{
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+}
+
+
+EpollSocketBackend::~EpollSocketBackend()
+{
+	if (_epollFd != -1)
+	{
+		close(_epollFd);
+	}
+}
+
+
+bool EpollSocketBackend::addSocket(SOCKET socket, uint32_t playerId)
+{
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+
+	// Edge-triggered; the read thread drains sockets until they would block,
+	// and EPOLLOUT only fires again after send() would have blocked
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.u32 = playerId;
+
+	return epoll_ctl(_epollFd, EPOLL_CTL_ADD, socket, &event) != -1;
+}
+
+
+void EpollSocketBackend::removeSocket(SOCKET socket, uint32_t)
+{
+	// Closing the socket would also do this, but only once every duplicate
+	// of the descriptor is gone
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, socket, NULL);
+}
+
+
+int EpollSocketBackend::wait(std::vector<SocketEvent> & events, int timeoutMs)
+{
+	struct epoll_event epollEvents[SOCKET_MAX_EVENTS];
+
+	int eventCount = epoll_wait(_epollFd, epollEvents, SOCKET_MAX_EVENTS, timeoutMs);
+	if (eventCount == -1)
+	{
+		// Interrupted by a signal; not an error
+		return (errno == EINTR) ? 0 : -1;
+	}
+
+	for (int i = 0; i < eventCount; i++)
+	{
+		uint32_t flags = epollEvents[i].events;
+
+		// A hangup still needs to be read so that recv() returns 0
+		events.push_back({
+			epollEvents[i].data.u32,
+			(flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0,
+			(flags & EPOLLOUT) != 0,
+			(flags & EPOLLERR) != 0 });
+	}
+
+	return eventCount;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SocketBackend.hpp"
+
+#ifdef __linux__
+
+/*
+** Edge-triggered epoll backend. Registration is O(1), and each wakeup only
+** reports the sockets that actually have activity, so the cost of wait() does
+** not grow with the number of sessions. Sockets can be added while another
+** thread is blocked in wait(), and are picked up immediately.
+*/
+class EpollSocketBackend : public SocketBackend
+{
+public:
+	EpollSocketBackend();
+	~EpollSocketBackend();
+
+	bool addSocket(SOCKET socket, uint32_t playerId) override;
+
+	void removeSocket(SOCKET socket, uint32_t playerId) override;
+
+	// No-op; EPOLLOUT is always registered, and being edge-triggered it only
+	// fires when a full send buffer drains
+	void setWriteInterest(SOCKET, uint32_t, bool) override {};
+
+	int wait(std::vector<SocketEvent> & events, int timeoutMs) override;
+
+	const char * getName() override { return "epoll"; }
+
+	// Whether the epoll instance was created successfully
+	bool isValid() { return _epollFd != -1; }
+
+private:
+	int _epollFd;
+};
+
+#endif
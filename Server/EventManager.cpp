@@ -1,14 +1,33 @@
 #include "EventManager.hpp"
+#include "Profiler.hpp"
 #include "SHumanEntity.hpp"
 #include "SDogEntity.hpp"
 
+// Orders events by player, for finding a player's events with equal_range()
+struct PlayerIdLess
+{
+	bool operator()(const std::shared_ptr<GameEvent> & event, uint32_t playerId) const
+	{
+		return event->playerId < playerId;
+	}
+
+	bool operator()(uint32_t playerId, const std::shared_ptr<GameEvent> & event) const
+	{
+		return playerId < event->playerId;
+	}
+};
+
 EventManager::EventManager(
-	NetworkServer* networkInterface,
+	NetworkInterface* networkInterface,
 	StructureInfo* structureInfo)
 {
 	_networkInterface = networkInterface;
 	_structureInfo = structureInfo;
 	_gameState = structureInfo->gameState.get();
+	_tickedCount = 0;
+
+	_receivedEvents.reserve(EVENT_ARENA_SIZE);
+	_entityEvents.reserve(EVENT_ARENA_SIZE);
 }
 
 EventManager::~EventManager()
@@ -18,93 +37,130 @@ EventManager::~EventManager()
 
 bool EventManager::update()
 {
-	auto playerEvents = _networkInterface->receiveEvents();
-
-	// Create map of events
-	auto eventMap = std::unordered_map<uint32_t, std::vector<std::shared_ptr<GameEvent>>>();
+	_tickedCount = 0;
 
-	// Now iterate over player events, inserting them into their respective
-	// vectors if they are to be handled by the entities, or handling them
-	// here otherwise.
-	for (auto& event : playerEvents)
 	{
-		switch (event->type)
-		{
-		case EVENT_PLAYER_JOIN:
-		{
-			handlePlayerJoin(event);
-			break;
-		}
-		case EVENT_PLAYER_SWITCH:
-		{
-			handlePlayerSwitch(event);
-			break;
-		}
-		case EVENT_PLAYER_LEAVE:
+		ProfileScope scope(PROFILE_EVENT_INGEST);
+
+		_networkInterface->receiveEvents(_receivedEvents);
+
+		// Now iterate over player events, collecting them if they are to be
+		// handled by the entities, or handling them here otherwise.
+		for (auto& event : _receivedEvents)
 		{
-			if (!handlePlayerLeave(event))
+			switch (event->type)
 			{
-				return false;
+			case EVENT_PLAYER_JOIN:
+			{
+				handlePlayerJoin(event);
+				break;
 			}
-			break;
-		}
-		case EVENT_PLAYER_READY:
-		{
-			handlePlayerReady(event);
-			break;
-		}
-		case EVENT_CLIENT_READY:
-		{
-			// Client has fully loaded the game
-			_gameState->clientReadyCount++;
-			_gameState->_loadedStart = std::chrono::steady_clock::now();
-			break;
-		}
-		case EVENT_REQUEST_RESEND:
-		{
-			handleResendRequest(event);
-			break;
-		}
-		default:
-			// By default, the entity handles the event
-			auto it = eventMap.find(event->playerId);
-			if (it == eventMap.end())
+			case EVENT_PLAYER_SWITCH:
+			{
+				handlePlayerSwitch(event);
+				break;
+			}
+			case EVENT_PLAYER_LEAVE:
+			{
+				if (!handlePlayerLeave(event))
+				{
+					clearEvents();
+					return false;
+				}
+				break;
+			}
+			case EVENT_PLAYER_READY:
+			{
+				handlePlayerReady(event);
+				break;
+			}
+			case EVENT_CLIENT_READY:
 			{
-				eventMap.insert({ event->playerId, std::vector<std::shared_ptr<GameEvent>>() });
+				// Client has fully loaded the game
+				_gameState->clientReadyCount++;
+				_gameState->_loadedStart = GameClock::now();
+				break;
+			}
+			case EVENT_REQUEST_RESEND:
+			{
+				handleResendRequest(event);
+				break;
+			}
+			default:
+				// By default, the entity handles the event
+				_entityEvents.push_back(event);
 			}
-			eventMap.find(event->playerId)->second.push_back(event);
 		}
 	}
 
 	// Call update() on all entities if we are not in the pregame countdown
 	if (!_gameState->pregameCountdown && !_gameState->waitingForClients)
 	{
-		for (auto& entityPair : *_structureInfo->entityMap)
 		{
-			// There are some cases where the map does not have a vector
-			auto it = eventMap.find(entityPair.first);
-			if (it == eventMap.end())
-			{
-				eventMap.insert({ entityPair.first, std::vector<std::shared_ptr<GameEvent>>() });
-			}
-
-			auto eventVec = eventMap.find(entityPair.first)->second;
+			ProfileScope scope(PROFILE_EVENT_INGEST);
 
-			// Sort by event type
-			std::sort(eventVec.begin(), eventVec.end(),
+			// Bucket by player, and sort each player's events by type
+			std::sort(_entityEvents.begin(), _entityEvents.end(),
 				[](const std::shared_ptr<GameEvent> & a, const std::shared_ptr<GameEvent> & b) -> bool
 				{
-					return a->type < b->type;
+					if (a->playerId != b->playerId)
+						return a->playerId < b->playerId;
+					else
+						return a->type < b->type;
 				});
+		}
+
+		ProfileScope scope(PROFILE_ENTITY_UPDATE);
+
+		auto eventsBegin = _entityEvents.data();
+		auto eventsEnd = eventsBegin + _entityEvents.size();
+
+		// Wake up anyone with events
+		for (size_t i = 0; i < _entityEvents.size(); i++)
+		{
+			uint32_t playerId = _entityEvents[i]->playerId;
+			if (i == 0 || playerId != _entityEvents[i - 1]->playerId)
+			{
+				auto entity = _structureInfo->entities->find(playerId);
+				if (entity)
+				{
+					entity->wake();
+				}
+			}
+		}
+
+		// Entities woken along the way are appended, and updated this tick
+		auto& active = _structureInfo->entities->getActive();
+		for (size_t i = 0; i < active.size(); i++)
+		{
+			auto entity = active[i];
+			if (!entity->isAwake())
+			{
+				continue;
+			}
+
+			// This entity's bucket, empty if it has no events
+			auto bucket = std::equal_range(eventsBegin, eventsEnd, entity->getState()->id,
+				PlayerIdLess());
 
-			entityPair.second->update(eventVec);
+			entity->update(EventSpan(bucket.first, bucket.second));
+			_tickedCount++;
 		}
+
+		_structureInfo->entities->removeSleeping();
 	}
 
+	clearEvents();
 	return true;
 }
 
-void EventManager::handlePlayerJoin(std::shared_ptr<GameEvent> event)
+void EventManager::clearEvents()
+{
+	_receivedEvents.clear();
+	_entityEvents.clear();
+}
+
+void EventManager::handlePlayerJoin(const std::shared_ptr<GameEvent> & event)
 {
 	// Immediately close the connection if a game is running
 	if (!_gameState->inLobby)
@@ -122,12 +178,12 @@ void EventManager::handlePlayerJoin(std::shared_ptr<GameEvent> event)
 		_gameState->humans.insert({ event->playerId, event->playerName });
 	}
 
-	Logger::getInstance()->debug(
+	LOG_DEBUG(
 		std::string("\"") + event->playerName +
 		std::string("\" joined the server!"));
 }
 
-void EventManager::handlePlayerSwitch(std::shared_ptr<GameEvent> event)
+void EventManager::handlePlayerSwitch(const std::shared_ptr<GameEvent> & event)
 {
 	auto dogsResult = _gameState->dogs.find(event->playerId);
 	auto humansResult = _gameState->humans.find(event->playerId);
@@ -144,7 +200,7 @@ void EventManager::handlePlayerSwitch(std::shared_ptr<GameEvent> event)
 	}
 }
 
-void EventManager::handlePlayerReady(std::shared_ptr<GameEvent> event)
+void EventManager::handlePlayerReady(const std::shared_ptr<GameEvent> & event)
 {
 	// Disregard duplicate events
 	for (auto& player : _gameState->readyPlayers)
@@ -164,7 +220,7 @@ void EventManager::handlePlayerReady(std::shared_ptr<GameEvent> event)
 	}
 }
 
-bool EventManager::handlePlayerLeave(std::shared_ptr<GameEvent> event)
+bool EventManager::handlePlayerLeave(const std::shared_ptr<GameEvent> & event)
 {
 	if (_gameState->dogs.find(event->playerId) != _gameState->dogs.end())
 	{
@@ -205,17 +261,16 @@ bool EventManager::handlePlayerLeave(std::shared_ptr<GameEvent> event)
 	}
 
 	// Mark entity for deletion if it exists
-	auto result = _structureInfo->entityMap->find(event->playerId);
-	if (result != _structureInfo->entityMap->end()) {
-		auto entity = result->second;
-		entity->getState()->isDestroyed = true;
-		entity->hasChanged = true;
+	auto entity = _structureInfo->entities->find(event->playerId);
+	if (entity) {
+		entity->destroy();
+		entity->markChanged();
 	}
 
 	return true;
 }
 
-void EventManager::handleResendRequest(std::shared_ptr<GameEvent> event)
+void EventManager::handleResendRequest(const std::shared_ptr<GameEvent> & event)
 {
 	/*
 	// List of entities known to the client
@@ -224,9 +279,9 @@ void EventManager::handleResendRequest(std::shared_ptr<GameEvent> event)
 	// Get list of entities currently on the server
 	std::vector<uint32_t> serverList;
 
-	for (auto& entityPair : *_structureInfo->entityMap)
+	for (auto& id : _structureInfo->entities->getIds())
 	{
-		serverList.push_back(entityPair.first);
+		serverList.push_back(id);
 	}
 
 	// Difference between the two vectors
@@ -238,21 +293,21 @@ void EventManager::handleResendRequest(std::shared_ptr<GameEvent> event)
 
 	*/
 
-	Logger::getInstance()->debug("Received resend request from playerId " +
+	LOG_DEBUG("Received resend request from playerId " +
 		std::to_string(event->playerId));
 
 	// Build a list of updates for this client based on diff
 	std::vector<std::shared_ptr<BaseState>> updates;
 
-	for (auto& entityPair : *_structureInfo->entityMap)
+	for (auto& entity : *_structureInfo->entities)
 	{
-		updates.push_back(entityPair.second->getState());
+		updates.push_back(entity->getState());
 	}
 
 	/*
 	for (auto& entityId : diff)
 	{
-		std::shared_ptr<SBaseEntity> entity = _structureInfo->entityMap->find(entityId)->second;
+		auto entity = _structureInfo->entities->find(entityId);
 		updates.push_back(entity->getState());
 	}
 	*/
@@ -291,7 +346,7 @@ void EventManager::startGame()
 		humanEntity->getState()->pos = glm::vec3(humanSpawn.x, 0, humanSpawn.y);
 
 		// Insert into global map
-		_structureInfo->entityMap->insert({ humanPair.first, humanEntity });
+		_structureInfo->entities->insert(humanEntity);
 
 		skinID++;
 	}
@@ -317,20 +372,20 @@ void EventManager::startGame()
 		dogEntity->getState()->pos = glm::vec3(dogSpawn.x, 0, dogSpawn.y);
 
 		// Insert into global map
-		_structureInfo->entityMap->insert({ dogPair.first, dogEntity });
+		_structureInfo->entities->insert(dogEntity);
 
 		skinID++;
 	}
 
 	// Send state of every object to every player
 	auto updateVec = std::vector<std::shared_ptr<BaseState>>();
-	for (auto& entityPair : *_structureInfo->entityMap)
+	for (auto& entity : *_structureInfo->entities)
 	{
-		updateVec.push_back(entityPair.second->getState());
+		updateVec.push_back(entity->getState());
 
 		// Visible entity count. Used by the client to determine whether
 		// the game is fully rendered or not
-		if (entityPair.second->getState()->isVisible)
+		if (entity->getState()->isVisible)
 		{
 			_structureInfo->gameState->entityCount++;
 		}
@@ -356,11 +411,11 @@ void EventManager::startGame()
 	}
 
 	// Optimization: remove all tile entities from the server map
-	for (auto& entityPair : *_structureInfo->entityMap)
+	for (auto& entity : *_structureInfo->entities)
 	{
-		if (entityPair.second->getState()->type == ENTITY_FLOOR)
+		if (entity->getState()->type == ENTITY_FLOOR)
 		{
-			entityPair.second->getState()->isDestroyed = true;
+			entity->destroy();
 		}
 	}
 }
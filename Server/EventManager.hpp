@@ -8,18 +8,27 @@
 #include "Shared/GameState.hpp"
 #include "SBaseEntity.hpp"
 #include "StructureInfo.hpp"
-#include "NetworkServer.hpp"
+#include "NetworkInterface.hpp"
+
+// Events a tick is expected to hold. The buffers grow past this if needed,
+// and keep their size from then on.
+#define EVENT_ARENA_SIZE 256
 
 /*
 ** This class gets events from the clients, filters them, and
 ** calls the update() function on each entity on the server with the
 ** appropriate events.
+**
+** Events are received into, and bucketed in, buffers that are kept from tick
+** to tick, and entities are handed spans of them. Only awake entities are
+** visited, so the level's static geometry costs nothing; see
+** SBaseEntity::sleep().
 */
 class EventManager
 {
 public:
 	EventManager(
-		NetworkServer* networkInterface,
+		NetworkInterface* networkInterface,
 		StructureInfo* structureInfo);
 	~EventManager();
 
@@ -31,22 +40,28 @@ public:
 	// I don't want to make a GameStateManager just to handle this one case.
 	bool update();
 
+	// Entities updated in the last call to update()
+	size_t getTickedCount() { return _tickedCount; };
+
 private:
 	// Helper functions
-	void handlePlayerJoin(std::shared_ptr<GameEvent> event);
-	void handlePlayerSwitch(std::shared_ptr<GameEvent> event);
-	void handlePlayerReady(std::shared_ptr<GameEvent> event);
+	void handlePlayerJoin(const std::shared_ptr<GameEvent> & event);
+	void handlePlayerSwitch(const std::shared_ptr<GameEvent> & event);
+	void handlePlayerReady(const std::shared_ptr<GameEvent> & event);
 
 	// Handle player leave events. Returns true if there are still players
 	// on the server, false otherwise.
-	bool handlePlayerLeave(std::shared_ptr<GameEvent> event);
+	bool handlePlayerLeave(const std::shared_ptr<GameEvent> & event);
 
-	void handleResendRequest(std::shared_ptr<GameEvent> event);
+	void handleResendRequest(const std::shared_ptr<GameEvent> & event);
 
 	void startGame();
 
+	// Lets go of this tick's events
+	void clearEvents();
+
 	// Raw pointer to network interface
-	NetworkServer* _networkInterface;
+	NetworkInterface* _networkInterface;
 
 	// General structure info
 	StructureInfo* _structureInfo;
@@ -54,5 +69,14 @@ private:
 	// Game state struct. It is contained within _structureInfo; we keep this
 	// variable as an alias for convenience.
 	GameState* _gameState;
+
+	// Every event received this tick
+	std::vector<std::shared_ptr<GameEvent>> _receivedEvents;
+
+	// Events handled by entities, sorted by player and then by type, so each
+	// player's are together
+	std::vector<std::shared_ptr<GameEvent>> _entityEvents;
+
+	size_t _tickedCount;
 };
 
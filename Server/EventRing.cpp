@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "EventRing.hpp"
+
+EventRing::EventRing(size_t capacity)
+{
+	_slots = std::make_unique<Slot[]>(capacity);
+	_mask = capacity - 1;
+
+	for (size_t i = 0; i < capacity; i++)
+	{
+		_slots[i].sequence = i;
+		_slots[i].event = std::make_shared<GameEvent>();
+	}
+
+	_tail = 0;
+	_head = 0;
+	_hasOverflow = false;
+
+	_drained = 0;
+	_spilled = 0;
+	_delayTotalNs = 0;
+	_delayMaxNs = 0;
+}
+
+void EventRing::push(const GameEvent & event)
+{
+	// Once anything has spilled, keep spilling until it is drained, so
+	// nothing overtakes it
+	if (_hasOverflow)
+	{
+		spill(event);
+		return;
+	}
+
+	// Claim a position whose slot has been drained, or give up if the ring
+	// has come round to one that has not
+	size_t position = _tail.load(std::memory_order_relaxed);
+	Slot * slot;
+	while (true)
+	{
+		slot = &_slots[position & _mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+		if (difference == 0)
+		{
+			if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			spill(event);
+			return;
+		}
+		else
+		{
+			position = _tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Reuse the pooled event unless the game still holds it. Its last holder
+	// let go with a release, so this needs an acquire before writing to it.
+	if (slot->event.use_count() == 1)
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	else
+	{
+		slot->event = std::make_shared<GameEvent>();
+	}
+
+	*slot->event = event;
+	slot->pushTime = std::chrono::steady_clock::now();
+
+	// Publish
+	slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void EventRing::spill(const GameEvent & event)
+{
+	std::unique_lock<std::mutex> lock(_overflowMutex);
+	_overflow.push_back(std::make_shared<GameEvent>(event));
+	_hasOverflow = true;
+	_spilled.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventRing::take(Slot & slot, size_t position, std::vector<std::shared_ptr<GameEvent>> * events)
+{
+	if (events)
+	{
+		events->push_back(slot.event);
+	}
+
+	// Frees the slot for the push one lap later
+	slot.sequence.store(position + _mask + 1, std::memory_order_release);
+}
+
+void EventRing::drain(std::vector<std::shared_ptr<GameEvent>> & events)
+{
+	auto now = std::chrono::steady_clock::now();
+	uint64_t delayTotal = 0;
+	uint64_t delayMax = 0;
+
+	size_t position = _head.load(std::memory_order_relaxed);
+	size_t start = position;
+	while (true)
+	{
+		Slot & slot = _slots[position & _mask];
+
+		// Stop at the first slot not yet published. Pushes that claimed a
+		// later one finish on their own and are picked up next time.
+		if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+		{
+			break;
+		}
+
+		uint64_t delay = std::chrono::duration_cast<std::chrono::nanoseconds>(now - slot.pushTime).count();
+		delayTotal += delay;
+		delayMax = std::max(delayMax, delay);
+
+		take(slot, position, &events);
+		position++;
+	}
+	_head.store(position, std::memory_order_relaxed);
+
+	// Spilled events come after everything in the ring, so they have to wait
+	// if a push into the ring has yet to finish. Nothing new goes in the ring
+	// once something has spilled, so the ring always empties eventually.
+	if (_hasOverflow && position == _tail.load(std::memory_order_acquire))
+	{
+		std::unique_lock<std::mutex> lock(_overflowMutex);
+		events.insert(events.end(), _overflow.begin(), _overflow.end());
+		_overflow.clear();
+		_hasOverflow = false;
+	}
+
+	_drained.fetch_add(position - start, std::memory_order_relaxed);
+	_delayTotalNs.fetch_add(delayTotal, std::memory_order_relaxed);
+	if (delayMax > _delayMaxNs.load(std::memory_order_relaxed))
+	{
+		_delayMaxNs.store(delayMax, std::memory_order_relaxed);
+	}
+}
+
+void EventRing::clear()
+{
+	size_t position = _head.load(std::memory_order_relaxed);
+	while (_slots[position & _mask].sequence.load(std::memory_order_acquire) == position + 1)
+	{
+		take(_slots[position & _mask], position, nullptr);
+		position++;
+	}
+	_head.store(position, std::memory_order_relaxed);
+
+	std::unique_lock<std::mutex> lock(_overflowMutex);
+	_overflow.clear();
+	_hasOverflow = false;
+}
+
+bool EventRing::isEmpty()
+{
+	size_t position = _head.load(std::memory_order_relaxed);
+	return _slots[position & _mask].sequence.load(std::memory_order_acquire) != position + 1 &&
+		!_hasOverflow;
+}
+
+EventRing::Stats EventRing::takeStats()
+{
+	Stats stats;
+	stats.drained = _drained.exchange(0, std::memory_order_relaxed);
+	stats.spilled = _spilled.exchange(0, std::memory_order_relaxed);
+	stats.delayTotalNs = _delayTotalNs.exchange(0, std::memory_order_relaxed);
+	stats.delayMaxNs = _delayMaxNs.exchange(0, std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+#include "Shared/GameEvent.hpp"
+
+// Events a room's ring holds before they spill into a locked overflow list.
+// Must be a power of two.
+#define EVENT_RING_SIZE 1024
+
+/*
+** Events on their way from the network threads to a room, as a bounded
+** lock-free multi-producer, single-consumer ring. Any thread can push, and
+** the room's tick drains everything pushed so far in one go.
+**
+** Each slot owns a pooled GameEvent. Pushing copies into it in place, and
+** draining hands out the slot's shared_ptr, so once the game has let go of
+** last tick's events they are filled in again without allocating. If the
+** game is still holding a slot's event when the ring comes back round, the
+** slot just gets a fresh one.
+**
+** A ring that fills up, because its room stalled, spills into an overflow
+** list behind a mutex rather than dropping anything; leave events in
+** particular must always arrive.
+*/
+class EventRing
+{
+public:
+	EventRing(size_t capacity = EVENT_RING_SIZE);
+	~EventRing() {};
+
+	// Copies event into the ring. Safe to call from any thread.
+	void push(const GameEvent & event);
+
+	// Appends every event pushed so far, in the order they were pushed from
+	// each thread. Only one thread may drain at a time.
+	void drain(std::vector<std::shared_ptr<GameEvent>> & events);
+
+	// Drops every event pushed so far. Same rules as drain().
+	void clear();
+
+	// Whether anything is waiting to be drained. Safe to call from any
+	// thread, though it may be out of date by the time it returns.
+	bool isEmpty();
+
+	// Counters since the last call to takeStats(), which resets them
+	struct Stats
+	{
+		uint64_t drained;
+		uint64_t spilled;		// Pushed while the ring was full
+		uint64_t delayTotalNs;	// Time from push to drain, summed
+		uint64_t delayMaxNs;
+	};
+	Stats takeStats();
+
+private:
+	struct Slot
+	{
+		// Equal to the position of the push that may fill this slot next,
+		// or one past it once filled
+		std::atomic<size_t> sequence;
+		std::shared_ptr<GameEvent> event;
+		std::chrono::steady_clock::time_point pushTime;
+	};
+
+	// Adds to the overflow list
+	void spill(const GameEvent & event);
+
+	// Takes a pushed slot's event and frees the slot
+	void take(Slot & slot, size_t position, std::vector<std::shared_ptr<GameEvent>> * events);
+
+	std::unique_ptr<Slot[]> _slots;
+	size_t _mask;
+
+	std::atomic<size_t> _tail;	// Next position to push to
+	std::atomic<size_t> _head;	// Next position to drain; only the consumer writes it
+
+	// Events that did not fit
+	std::vector<std::shared_ptr<GameEvent>> _overflow;
+	std::mutex _overflowMutex;
+	std::atomic<bool> _hasOverflow;
+
+	std::atomic<uint64_t> _drained, _spilled, _delayTotalNs, _delayMaxNs;
+};
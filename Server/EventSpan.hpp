@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+
+#include "Shared/GameEvent.hpp"
+
+/*
+** A view of events owned by someone else, handed to SBaseEntity::update().
+** Only good for the duration of the call, so copy out any event that has to
+** be kept.
+*/
+class EventSpan
+{
+public:
+	EventSpan() : _begin(nullptr), _end(nullptr) {};
+	EventSpan(const std::shared_ptr<GameEvent> * begin, const std::shared_ptr<GameEvent> * end)
+		: _begin(begin), _end(end) {};
+
+	const std::shared_ptr<GameEvent> * begin() const { return _begin; };
+	const std::shared_ptr<GameEvent> * end() const { return _end; };
+
+	size_t size() const { return _end - _begin; };
+	bool empty() const { return _begin == _end; };
+
+	const std::shared_ptr<GameEvent> & operator[](size_t i) const { return _begin[i]; };
+
+private:
+	const std::shared_ptr<GameEvent> * _begin;
+	const std::shared_ptr<GameEvent> * _end;
+};
@@ -9,8 +9,17 @@
 #include "SBoxEntity.hpp"
 #include "GameServer.hpp"
 
-GameServer::GameServer()
+GameServer::GameServer(
+	std::unique_ptr<NetworkInterface> networkInterface,
+	std::string levelPath)
 {
+	_networkInterface = std::move(networkInterface);
+	_levelPath = levelPath;
+	_tick = 0;
+	_timerWheel = std::make_unique<TimerWheel>(_tick);
+
+	_isInLobby = true;
+	_hasPlayers = false;
 }
 
 
@@ -19,10 +28,11 @@ GameServer::~GameServer()
 }
 
 
-void GameServer::start()
+void GameServer::initialize()
 {
-    // Start network server
-    _networkInterface = std::make_unique<NetworkServer>(PORTNUM);
+	// Entities created while loading read game time and may set timers
+	GameClock::setTick(_tick);
+	TimerWheel::setCurrent(_timerWheel.get());
 
 	// Init level parser
 	_levelParser = std::make_unique<GridLevelParser>();
@@ -34,61 +44,36 @@ void GameServer::start()
 	// from the level file, and initializing the gameState struct
 	resetGameState();
 
-	// Server utilization monitor
-	Logger::getInstance()->initUtilizationMonitor();
-
 	// Init collision manager
-	_collisionManager = std::make_unique<CollisionManager>(_structureInfo->entityMap);
+	_collisionManager = std::make_unique<CollisionManager>(_structureInfo);
 
 	// Init event handler
 	_eventManager = std::make_unique<EventManager>(
 		_networkInterface.get(),
 		_structureInfo);
+}
 
-	_isRunning = true;
-	_isFinished = false;
-
-    // Run update loop, keeping each iteration at a minimum of 1 tick
-	while (_isRunning)
-	{
-		auto timerStart = std::chrono::steady_clock::now();
-
-		this->update();
-
-		auto timerEnd = std::chrono::steady_clock::now();
 
-		// Elapsed time in nanoseconds
-		auto elapsed = timerEnd - timerStart;
+void GameServer::update()
+{
+	Profiler::getInstance()->beginTick();
 
-		Logger::getInstance()->storeLoopDuration(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
-		//Logger::getInstance()->debug("Elapsed time: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+	// Game logic on this thread now sees this room's time and timers
+	GameClock::setTick(++_tick);
+	TimerWheel::setCurrent(_timerWheel.get());
 
-		// Warn if server is overloaded
-		if (tick(elapsed).count() > 1)
-		{
-			Logger::getInstance()->warn("Update loop took longer than a tick (" +
-					std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()) +
-					"ms)");
-		}
-		else
-		{
-			// Sleep for the difference
-			std::this_thread::sleep_for(tick(1) - elapsed);
-		}
+	// Fire every timer due this tick
+	{
+		ProfileScope scope(PROFILE_GAME_STATE);
+		_timerWheel->advance(_tick);
 	}
 
-	_isFinished = true;
-}
-
-
-void GameServer::update()
-{
 	// General game state and network updates
 
 	// add new entities from last tick to the entity map
 	for (auto& newEntity : *_structureInfo->newEntities)
 	{
-		_structureInfo->entityMap->insert({newEntity->getState()->id, newEntity});
+		_structureInfo->entities->insert(newEntity);
 	}
 	_structureInfo->newEntities->clear();
 
@@ -103,58 +88,56 @@ void GameServer::update()
 	_collisionManager->handleCollisions();
 
 	// Update general state of the game based on updates and clock
-	updateGameState();
+	{
+		ProfileScope scope(PROFILE_GAME_STATE);
+		updateGameState();
+	}
 
-	// Build update list for clients
-	auto updates = std::vector<std::shared_ptr<BaseState>>();
-	for (auto& entityPair : *_structureInfo->entityMap)
 	{
-		uint32_t id = entityPair.first;
-		std::shared_ptr<SBaseEntity> entity = entityPair.second;
+		ProfileScope scope(PROFILE_SNAPSHOT_BUILD);
 
-		// Add to vector only if there is an update available
-		if (entity->hasChanged)
+		// Build update list for clients from the entities that changed
+		auto updates = std::vector<std::shared_ptr<BaseState>>();
+		for (auto& entity : _structureInfo->entities->getChanged())
 		{
 			updates.push_back(entity->getState());
 		}
+		_structureInfo->entities->clearChanged();
+		Profiler::getInstance()->add(PROFILE_ENTITIES_CHANGED, updates.size());
+
+		// Send out the updates
+		_networkInterface->sendUpdates(updates);
+
+		// Send a copy of the GameState struct if any players are connected.
+		// This is a bit dangerous because if the client is not receiving anything
+		// the network queues could fill up pretty damn fast. It is also mostly a
+		// waste of CPU and bandwidth; we may just want the clients to use their
+		// own clocks for the countdown.
+		if (_gameState->dogs.size() || _gameState->humans.size())
+		{
+			_networkInterface->sendUpdate(_structureInfo->gameState);
+		}
 	}
 
-	// Send out the updates
-	_networkInterface->sendUpdates(updates);
-
-	// Send a copy of the GameState struct if any players are connected.
-	// This is a bit dangerous because if the client is not receiving anything
-	// the network queues could fill up pretty damn fast. It is also mostly a
-	// waste of CPU and bandwidth; we may just want the clients to use their
-	// own clocks for the countdown.
-	if (_gameState->dogs.size() || _gameState->humans.size())
 	{
-		_networkInterface->sendUpdate(_structureInfo->gameState);
-	}
+		ProfileScope scope(PROFILE_CLEANUP);
 
-	// Remove all entities marked for deletion
-	auto deletedEntities = std::vector<uint32_t>();
-
-	// Build list first, otherwise we would break the iteration
-	for (auto& entityPair : *_structureInfo->entityMap)
-	{
-		if (entityPair.second->getState()->isDestroyed)
+		// Remove all entities marked for deletion. Erasing one can destroy
+		// others, which are appended to the list.
+		auto& destroyed = _structureInfo->entities->getDestroyed();
+		for (size_t i = 0; i < destroyed.size(); i++)
 		{
-			deletedEntities.push_back(entityPair.first);
+			_collisionManager->removeEntity(destroyed[i]);
+			_structureInfo->entities->erase(destroyed[i]);
 		}
+		destroyed.clear();
 	}
 
-	// Delete everything in list
-	for (auto& id : deletedEntities)
-	{
-		_structureInfo->entityMap->erase(_structureInfo->entityMap->find(id));
-	}
+	Profiler::getInstance()->add(PROFILE_ENTITIES_TICKED, _eventManager->getTickedCount());
+	Profiler::getInstance()->endTick();
 
-	// Reset hasChanged for all entities
-	for (auto& entityPair : *_structureInfo->entityMap)
-	{
-		entityPair.second->hasChanged = false;
-	}
+	_isInLobby = _gameState->inLobby;
+	_hasPlayers = _gameState->dogs.size() || _gameState->humans.size();
 }
 
 void GameServer::updateGameState()
@@ -164,11 +147,11 @@ void GameServer::updateGameState()
 		_gameState->clientReadyCount >= _gameState->dogs.size() + _gameState->humans.size())
 	{
 		// First check elapsed time
-		auto elapsed = std::chrono::steady_clock::now() - _gameState->_loadedStart;
+		auto elapsed = GameClock::now() - _gameState->_loadedStart;
 		if (elapsed >= LOADING_LENGTH)
 		{
 			_gameState->pregameCountdown = true;
-			_gameState->_pregameStart = std::chrono::steady_clock::now();
+			_gameState->_pregameStart = GameClock::now();
 			_gameState->waitingForClients = false;
 			_gameState->clientReadyCount = 0;
 		}
@@ -179,10 +162,10 @@ void GameServer::updateGameState()
 	for (auto& dogPair : _gameState->dogs)
 	{
 		uint32_t dogId = dogPair.first;
-		auto dog = _structureInfo->entityMap->find(dogId);
-		if (dog != _structureInfo->entityMap->end())
+		auto dog = _structureInfo->entities->find(dogId);
+		if (dog)
 		{
-			dogsCaught &= std::static_pointer_cast<DogState>(dog->second->getState())->isCaught;
+			dogsCaught &= std::static_pointer_cast<DogState>(dog->getState())->isCaught;
 		}
 	}
 
@@ -191,7 +174,7 @@ void GameServer::updateGameState()
 	// Increment pregame countdown timer
 	if (_gameState->pregameCountdown)
 	{
-		auto duration = std::chrono::steady_clock::now() - _gameState->_pregameStart;
+		auto duration = GameClock::now() - _gameState->_pregameStart;
 		_gameState->millisecondsToStart =
 			(long)std::chrono::duration_cast<std::chrono::milliseconds>(
 				std::chrono::duration_cast<std::chrono::nanoseconds>(PREGAME_LENGTH)
@@ -202,14 +185,14 @@ void GameServer::updateGameState()
 		{
 			_gameState->gameStarted = true;
 			_gameState->pregameCountdown = false;
-			_gameState->_gameStart = std::chrono::steady_clock::now();
+			_gameState->_gameStart = GameClock::now();
 		}
 	}
 
 	// Increment game timer if game is started
 	if (_gameState->gameStarted)
 	{
-		_gameState->_gameDuration = std::chrono::steady_clock::now() - _gameState->_gameStart;
+		_gameState->_gameDuration = GameClock::now() - _gameState->_gameStart;
 		_gameState->millisecondsLeft =
 			(long)std::chrono::duration_cast<std::chrono::milliseconds>(
 				std::chrono::duration_cast<std::chrono::nanoseconds>(MAX_GAME_LENGTH)
@@ -224,7 +207,7 @@ void GameServer::updateGameState()
 	// Increment postgame countdown timer and reset the game if necessary
 	if (_gameState->gameOver)
 	{
-		auto duration = std::chrono::steady_clock::now() - _gameState->_endgameStart;
+		auto duration = GameClock::now() - _gameState->_endgameStart;
 		_gameState->millisecondsToLobby =
 			(long)std::chrono::duration_cast<std::chrono::milliseconds>(
 				std::chrono::duration_cast<std::chrono::nanoseconds>(POSTGAME_LENGTH)
@@ -243,16 +226,16 @@ void GameServer::updateGameState()
 		_gameState->gameStarted = false;
 		_gameState->gameOver = true;
 		_gameState->winner = ENTITY_HUMAN;
-		_gameState->_endgameStart = std::chrono::steady_clock::now();
-		Logger::getInstance()->debug("Humans won!");
+		_gameState->_endgameStart = GameClock::now();
+		LOG_DEBUG("Humans won!");
 	}
 	else if (_gameState->gameStarted && _gameState->_gameDuration >= MAX_GAME_LENGTH)
 	{
 		_gameState->gameStarted = false;
 		_gameState->gameOver = true;
 		_gameState->winner = ENTITY_DOG;
-		_gameState->_endgameStart = std::chrono::steady_clock::now();
-		Logger::getInstance()->debug("Dogs won!");
+		_gameState->_endgameStart = GameClock::now();
+		LOG_DEBUG("Dogs won!");
 	}
 }
 
@@ -290,9 +273,16 @@ void GameServer::resetGameState()
 	_gameState->millisecondsToLobby = 0;
 
 	// Map initialization
-	_levelParser->parseLevelFromFile("Levels/map.dat", _structureInfo);
+	_levelParser->parseLevelFromFile(_levelPath, _structureInfo);
 
-	Logger::getInstance()->debug("Parsed " + std::to_string(_structureInfo->entityMap->size()) + " entities from file.");
+	// The first load happens before the collision manager exists, which
+	// builds its static geometry on construction instead
+	if (_collisionManager)
+	{
+		_collisionManager->loadStaticGeometry();
+	}
+
+	LOG_DEBUG("Parsed " + std::to_string(_structureInfo->entities->size()) + " entities from file.");
 
 	// Ensure at least one human spawn, dog spawn, and jail
 	if (!_structureInfo->jails->size())
@@ -318,16 +308,6 @@ void GameServer::resetGameState()
 
 void GameServer::shutdown()
 {
-	Logger::getInstance()->info("Shutting down server");
-
-	// Signal main thread to stop and wait for it to finish
-	_isRunning = false;
-
-	while (!_isFinished)
-	{
-		std::this_thread::sleep_for(tick(1));
-	}
-
 	// Disconnect all clients gracefully first
 	// If a message is to be shown to players on server shutdown, send it here
 	if (_networkInterface)
@@ -339,8 +319,8 @@ void GameServer::shutdown()
 	}
 
 	// Deallocate state structures
-	_structureInfo->entityMap->clear();
-	delete _structureInfo->entityMap;
+	_structureInfo->entities->clear();
+	delete _structureInfo->entities;
 
 	_structureInfo->newEntities->clear();
 	delete _structureInfo->newEntities;
@@ -8,32 +8,53 @@
 #include "Shared/Logger.hpp"
 #include "Shared/QuadTree.hpp"
 #include "Shared/GameState.hpp"
-#include "NetworkServer.hpp"
+#include "NetworkInterface.hpp"
 #include "SBaseEntity.hpp"
 #include "LevelParser.hpp"
 #include "CollisionManager.hpp"
 #include "EventManager.hpp"
 #include "StructureInfo.hpp"
+#include "TimerWheel.hpp"
+#include "Profiler.hpp"
 
 using tick = std::chrono::duration<double, std::ratio<1, TICKS_PER_SEC>>;
 
+#define DEFAULT_LEVEL_PATH "Levels/map.dat"
+
 struct PairHash;	// Forward declaration
 
+/*
+** A single match: one game state, entity map and set of managers, talking to
+** its players through networkInterface. The RoomManager runs many of these
+** side by side, calling update() once per tick on each.
+*/
 class GameServer
 {
 public:
-	GameServer();
+	// levelPath is parsed every time the game is reset
+	GameServer(
+		std::unique_ptr<NetworkInterface> networkInterface,
+		std::string levelPath = DEFAULT_LEVEL_PATH);
 	~GameServer();
 
-    // Setup components and start main loop
-    void start();
+	// Setup components
+	void initialize();
 
-    // Main update loop
+    // Runs a single tick, moving game time forward by exactly one tick
     void update();
 
-	// Shutdown the server
+	// Disconnect players and free game state
 	void shutdown();
 
+	// Whether players can join right now. Safe to call from any thread.
+	bool isInLobby() { return _isInLobby; };
+
+	// Whether the game has any players, even ones that have disconnected but
+	// not been handled yet. Safe to call from any thread.
+	bool hasPlayers() { return _hasPlayers; };
+
+	StructureInfo * getStructureInfo() { return _structureInfo; };
+
 private:
 	/** Functions **/
 
@@ -45,11 +66,23 @@ private:
 	void resetGameState();
 
 	/** Variables **/
-	std::atomic<bool> _isRunning;
-	std::atomic<bool> _isFinished;
+
+	// Copies of game state flags for other threads, set after every tick
+	std::atomic<bool> _isInLobby;
+	std::atomic<bool> _hasPlayers;
 
     // Interface for client communication
-    std::unique_ptr<NetworkServer> _networkInterface;
+    std::unique_ptr<NetworkInterface> _networkInterface;
+
+	// Level file to load on reset
+	std::string _levelPath;
+
+	// Ticks run so far. This is the room's game time; see GameClock.
+	uint64_t _tick;
+
+	// Entity timers, fired at the start of each tick. Entities cancel theirs
+	// when destroyed, so this is declared before anything that holds them.
+	std::unique_ptr<TimerWheel> _timerWheel;
 
 	// Parser for text or JSON level files
 	std::unique_ptr<LevelParser> _levelParser;
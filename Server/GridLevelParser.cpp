@@ -28,10 +28,10 @@ void GridLevelParser::parseLevelFromFile(
 	StructureInfo* structureInfo)
 {
 	// Reset state structures if they exist, else allocate them
-	if (structureInfo->entityMap)
+	if (structureInfo->entities)
 	{
-		Logger::getInstance()->debug("Resetting gameState structures");
-		structureInfo->entityMap->clear();
+		LOG_DEBUG("Resetting gameState structures");
+		structureInfo->entities->clear();
 		structureInfo->newEntities->clear();
 		structureInfo->jailsPos->clear();
 
@@ -44,7 +44,7 @@ void GridLevelParser::parseLevelFromFile(
 	}
 	else
 	{
-		structureInfo->entityMap = new std::unordered_map<uint32_t, std::shared_ptr<SBaseEntity>>();
+		structureInfo->entities = new EntityStore();
 		structureInfo->newEntities = new std::vector<std::shared_ptr<SBaseEntity>>();
 		structureInfo->jailsPos = new std::vector<glm::vec2>();
 		structureInfo->humanSpawns = new std::queue<glm::vec2>();
@@ -85,6 +85,7 @@ void GridLevelParser::parseLevelFromFile(
 
 	int width = (int)sr;
 	float tileWidth = MAP_WIDTH / (float)width;
+	structureInfo->gridWidth = width;
 
 	// Create 2D array of tiles
 	Tile*** tiles = new Tile**[width];
@@ -318,13 +319,13 @@ void GridLevelParser::parseLevelFromFile(
 					}
 
 					// Add entity to map
-					structureInfo->entityMap->insert({ entity->getState()->id, entity });
+					structureInfo->entities->insert(entity);
 
 					// Add children to map
 					auto children = entity->getChildren();
 					for (auto& child : entity->getChildren())
 					{
-						structureInfo->entityMap->insert({ child->getState()->id, child });
+						structureInfo->entities->insert(child);
 					}
 				}
 			}
@@ -336,7 +337,7 @@ void GridLevelParser::parseLevelFromFile(
 				zIndex,
 				tileWidth,
 				tile->isClaimed);
-			structureInfo->entityMap->insert({ floorTile->getState()->id, floorTile });
+			structureInfo->entities->insert(floorTile);
 		}
 	}
 }
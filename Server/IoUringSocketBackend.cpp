@@ -0,0 +1,260 @@
+#include "IoUringSocketBackend.hpp"
+
+#if defined(__linux__) && defined(SOCKET_BACKEND_USE_IO_URING)
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+// Player IDs are never zero, so zero identifies the wakeup eventfd
+#define IO_URING_WAKE_ID 0
+
+// Completions of poll-remove requests are tagged so they can be skipped
+#define IO_URING_REMOVE_TAG (1ull << 32)
+
+// POLLOUT requests are tagged to tell them apart from the read polls
+#define IO_URING_WRITE_TAG (1ull << 33)
+
+IoUringSocketBackend::IoUringSocketBackend()
+{
+	_isValid = false;
+	_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_wakeFd == -1)
+	{
+		return;
+	}
+
+	if (io_uring_queue_init(IO_URING_QUEUE_DEPTH, &_ring, 0) < 0)
+	{
+		close(_wakeFd);
+		_wakeFd = -1;
+		return;
+	}
+
+	_isValid = true;
+
+	// Watch the eventfd like any other socket
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	armPoll(_wakeFd, IO_URING_WAKE_ID);
+	io_uring_submit(&_ring);
+}
+
+
+IoUringSocketBackend::~IoUringSocketBackend()
+{
+	if (_isValid)
+	{
+		io_uring_queue_exit(&_ring);
+		close(_wakeFd);
+	}
+}
+
+
+bool IoUringSocketBackend::addSocket(SOCKET socket, uint32_t playerId)
+{
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	_sockets[playerId] = socket;
+	_pendingArms.push_back(playerId);
+	lock.unlock();
+
+	wake();
+	return true;
+}
+
+
+void IoUringSocketBackend::removeSocket(SOCKET, uint32_t playerId)
+{
+	// Erasing here means the socket will never be re-armed, even if its
+	// descriptor is reused before wait() gets around to cancelling the poll
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	_sockets.erase(playerId);
+	_pendingRemoves.push_back(playerId);
+	lock.unlock();
+
+	wake();
+}
+
+
+void IoUringSocketBackend::setWriteInterest(SOCKET, uint32_t playerId, bool isInterested)
+{
+	// Requests are one-shot, so losing interest just means not re-arming
+	if (!isInterested)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	if (!_sockets.count(playerId) || !_writeArmed.insert(playerId).second)
+	{
+		return;
+	}
+	_pendingWriteArms.push_back(playerId);
+	lock.unlock();
+
+	wake();
+}
+
+
+int IoUringSocketBackend::wait(std::vector<SocketEvent> & events, int timeoutMs)
+{
+	// Apply changes queued by other threads. The lock is held until the
+	// requests are submitted, so removeSocket() cannot race with a socket
+	// being closed and its descriptor reused.
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	for (auto& playerId : _pendingArms)
+	{
+		auto result = _sockets.find(playerId);
+		if (result != _sockets.end())
+		{
+			armPoll(result->second, playerId);
+		}
+	}
+	_pendingArms.clear();
+
+	for (auto& playerId : _pendingWriteArms)
+	{
+		auto result = _sockets.find(playerId);
+		if (result != _sockets.end())
+		{
+			armWritePoll(result->second, playerId);
+		}
+	}
+	_pendingWriteArms.clear();
+
+	for (auto& playerId : _pendingRemoves)
+	{
+		struct io_uring_sqe * sqe = getSqe();
+		io_uring_prep_poll_remove(sqe, (__u64)playerId);
+		io_uring_sqe_set_data64(sqe, IO_URING_REMOVE_TAG | playerId);
+
+		if (_writeArmed.erase(playerId))
+		{
+			sqe = getSqe();
+			io_uring_prep_poll_remove(sqe, IO_URING_WRITE_TAG | playerId);
+			io_uring_sqe_set_data64(sqe, IO_URING_REMOVE_TAG | IO_URING_WRITE_TAG | playerId);
+		}
+	}
+	_pendingRemoves.clear();
+
+	io_uring_submit(&_ring);
+	lock.unlock();
+
+	// Block until at least one completion arrives
+	struct __kernel_timespec timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_nsec = (long long)(timeoutMs % 1000) * 1000000;
+
+	struct io_uring_cqe * cqe;
+	int res = io_uring_wait_cqe_timeout(&_ring, &cqe, &timeout);
+	if (res == -ETIME || res == -EINTR)
+	{
+		return 0;
+	}
+	else if (res < 0)
+	{
+		return -1;
+	}
+
+	// Reap everything that is ready, re-arming one-shot polls as we go
+	int eventCount = 0;
+	unsigned head;
+	unsigned seen = 0;
+
+	lock.lock();
+	io_uring_for_each_cqe(&_ring, head, cqe)
+	{
+		seen++;
+		__u64 data = io_uring_cqe_get_data64(cqe);
+
+		if (data & IO_URING_REMOVE_TAG)
+		{
+			continue;
+		}
+
+		uint32_t playerId = (uint32_t)data;
+
+		// One-shot write poll; report it but do not re-arm
+		if (data & IO_URING_WRITE_TAG)
+		{
+			if (_writeArmed.erase(playerId) && cqe->res != -ECANCELED)
+			{
+				events.push_back({ playerId, false, cqe->res >= 0, cqe->res < 0 });
+				eventCount++;
+			}
+			continue;
+		}
+
+		// Drain and re-arm the wakeup eventfd
+		if (playerId == IO_URING_WAKE_ID)
+		{
+			eventfd_t value;
+			eventfd_read(_wakeFd, &value);
+			armPoll(_wakeFd, IO_URING_WAKE_ID);
+			continue;
+		}
+
+		// Socket was removed while its poll was in flight
+		auto result = _sockets.find(playerId);
+		if (result == _sockets.end() || cqe->res == -ECANCELED)
+		{
+			continue;
+		}
+
+		if (cqe->res < 0)
+		{
+			events.push_back({ playerId, false, false, true });
+		}
+		else
+		{
+			events.push_back({
+				playerId,
+				(cqe->res & (POLLIN | POLLRDHUP | POLLHUP)) != 0,
+				false,
+				(cqe->res & POLLERR) != 0 });
+		}
+		eventCount++;
+
+		armPoll(result->second, playerId);
+	}
+	io_uring_cq_advance(&_ring, seen);
+
+	io_uring_submit(&_ring);
+	lock.unlock();
+
+	return eventCount;
+}
+
+
+void IoUringSocketBackend::armPoll(SOCKET socket, uint32_t playerId)
+{
+	struct io_uring_sqe * sqe = getSqe();
+	io_uring_prep_poll_add(sqe, socket, POLLIN | POLLRDHUP);
+	io_uring_sqe_set_data64(sqe, playerId);
+}
+
+
+void IoUringSocketBackend::armWritePoll(SOCKET socket, uint32_t playerId)
+{
+	struct io_uring_sqe * sqe = getSqe();
+	io_uring_prep_poll_add(sqe, socket, POLLOUT);
+	io_uring_sqe_set_data64(sqe, IO_URING_WRITE_TAG | playerId);
+}
+
+
+struct io_uring_sqe * IoUringSocketBackend::getSqe()
+{
+	struct io_uring_sqe * sqe = io_uring_get_sqe(&_ring);
+	while (!sqe)
+	{
+		io_uring_submit(&_ring);
+		sqe = io_uring_get_sqe(&_ring);
+	}
+	return sqe;
+}
+
+
+void IoUringSocketBackend::wake()
+{
+	eventfd_write(_wakeFd, 1);
+}
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "SocketBackend.hpp"
+
+#if defined(__linux__) && defined(SOCKET_BACKEND_USE_IO_URING)
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <liburing.h>
+
+// Number of submission queue entries in the ring
+#define IO_URING_QUEUE_DEPTH 256
+
+/*
+** Opt-in io_uring backend. Each socket has a one-shot poll request in flight
+** that is re-armed after it completes, so readiness is delivered through the
+** completion queue without any epoll_ctl or select() calls per wakeup. Write
+** interest arms a separate one-shot POLLOUT request that is not re-armed.
+**
+** Only the thread calling wait() touches the submission queue. Other threads
+** queue up their changes and poke an eventfd to wake the ring up. Requires
+** liburing 2.2+ and Linux 5.6+; define SOCKET_BACKEND_USE_IO_URING and link
+** against liburing to build it.
+*/
+class IoUringSocketBackend : public SocketBackend
+{
+public:
+	IoUringSocketBackend();
+	~IoUringSocketBackend();
+
+	bool addSocket(SOCKET socket, uint32_t playerId) override;
+
+	void removeSocket(SOCKET socket, uint32_t playerId) override;
+
+	void setWriteInterest(SOCKET socket, uint32_t playerId, bool isInterested) override;
+
+	int wait(std::vector<SocketEvent> & events, int timeoutMs) override;
+
+	const char * getName() override { return "io_uring"; }
+
+	// Whether the ring was set up successfully
+	bool isValid() { return _isValid; }
+
+private:
+	// Queues a poll request for a socket. _socketMutex must be held.
+	void armPoll(SOCKET socket, uint32_t playerId);
+
+	// Queues a one-shot POLLOUT request for a socket. _socketMutex must be held.
+	void armWritePoll(SOCKET socket, uint32_t playerId);
+
+	// Gets a free submission entry, flushing the queue if it is full
+	struct io_uring_sqe * getSqe();
+
+	// Wakes up a thread blocked in wait()
+	void wake();
+
+	struct io_uring _ring;
+	bool _isValid;
+
+	// eventfd used to interrupt wait() when other threads queue changes
+	int _wakeFd;
+
+	// Watched sockets, keyed by player ID
+	std::unordered_map<uint32_t, SOCKET> _sockets;
+
+	// Sockets with a POLLOUT request queued or in flight
+	std::unordered_set<uint32_t> _writeArmed;
+
+	// Changes queued by other threads, applied at the start of wait()
+	std::vector<uint32_t> _pendingArms;
+	std::vector<uint32_t> _pendingWriteArms;
+	std::vector<uint32_t> _pendingRemoves;
+
+	std::mutex _socketMutex;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "Shared/BaseState.hpp"
+#include "Shared/GameEvent.hpp"
+
+/*
+** Everything the game logic needs from the network: events in from players,
+** states out to them, all within a single room. RoomNetwork is the real
+** implementation, passing each call on to the NetworkServer; see it for the
+** details of each call. ScriptedNetwork stands in for it when the server runs
+** headless.
+*/
+class NetworkInterface
+{
+public:
+	virtual ~NetworkInterface() {};
+
+	// Active player IDs in the room
+	virtual std::vector<uint32_t> getPlayerList() = 0;
+
+	// Disconnects a player
+	virtual void closePlayerSession(uint32_t playerId) = 0;
+
+	// Drops anything queued in either direction
+	virtual void clearQueues() = 0;
+
+	// Removes every event received since the last call and appends them to
+	// events
+	virtual void receiveEvents(std::vector<std::shared_ptr<GameEvent>> & events) = 0;
+
+	// Sends updates to every player in the room
+	virtual void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates) = 0;
+	virtual void sendUpdate(std::shared_ptr<BaseState> update) = 0;
+
+	// Sends updates to a single player
+	virtual void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId) = 0;
+	virtual void sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId) = 0;
+};
@@ -2,15 +2,54 @@
 #include <cereal/types/string.hpp>
 #include <cereal/types/memory.hpp>
 #include <algorithm>
+#include <streambuf>
+#include <istream>
+#include <sstream>
+#include <iomanip>
 
 #include "Shared/Logger.hpp"
 #include "NetworkServer.hpp"
 
-NetworkServer::NetworkServer(std::string port)
+/*
+** Input stream buffer over a block of memory, so events can be decoded
+** straight out of a session's read buffer.
+*/
+class ArrayStreamBuf : public std::streambuf
 {
+public:
+	ArrayStreamBuf(char * data, size_t length)
+	{
+		setg(data, data, data + length);
+	};
+};
+
+NetworkServer::NetworkServer(
+		std::string port,
+		RoomAssigner roomAssigner,
+		SocketBackendType backendType)
+{
+	_roomAssigner = roomAssigner;
+
+	// Init socket library (Winsock on Windows, no-op elsewhere)
+	int res = initSocketLibrary();
+	if (res)
+	{
+		Logger::getInstance()->fatal("Socket library startup failed with error: " +
+				std::to_string(res));
+		fgetc(stdin);
+		exit(1);
+	}
+
+	// Readiness notification for player sockets
+	_socketBackend = SocketBackend::create(backendType);
+	Logger::getInstance()->info("Using " + std::string(_socketBackend->getName()) +
+			" socket backend");
+
 	// Initialize queues
-	_updateQueue = std::make_unique<BlockingQueue<std::pair<uint32_t, std::shared_ptr<BaseState>>>>();
-	_eventQueue = std::make_unique<std::queue<std::shared_ptr<GameEvent>>>();
+	_updateQueue = std::make_unique<BlockingQueue<QueuedUpdate>>();
+	_readTime = std::chrono::nanoseconds(0);
+	_maxReadTime = std::chrono::nanoseconds(0);
+	_lastInputReport = std::chrono::steady_clock::now();
 
 	_sessions = std::unordered_map<uint32_t, SocketState>();
 
@@ -41,10 +80,8 @@ NetworkServer::~NetworkServer()
 
 void NetworkServer::connectionListener(
 		std::string port,
-		uint8_t maxConnections)
+		size_t maxConnections)
 {
-	WSADATA wsaData;
-
 	// Listen socket for new connections, temp socket for new clients
 	SOCKET listenSock, tempSock;
 	listenSock = tempSock = INVALID_SOCKET;
@@ -53,30 +90,20 @@ void NetworkServer::connectionListener(
 	struct addrinfo * result = NULL;
 	struct addrinfo hints;
 
-	// Init winsock
-	int res = WSAStartup(MAKEWORD(2, 2), &wsaData);
-	if (res)
-	{
-		Logger::getInstance()->fatal("WSAStartup failed with error: " +
-				std::to_string(res));
-		fgetc(stdin);
-		exit(1);
-	}
-
 	// Fill addr info struct
-	ZeroMemory(&hints, sizeof(hints));
+	memset(&hints, 0, sizeof(hints));
 	hints.ai_family = AF_INET;
 	hints.ai_socktype = SOCK_STREAM;
 	hints.ai_protocol = IPPROTO_TCP;
 	hints.ai_flags = AI_PASSIVE;
 
 	// Get address info from hints
-	res = getaddrinfo(NULL, port.c_str(), &hints, &result);
+	int res = getaddrinfo(NULL, port.c_str(), &hints, &result);
 	if (res)
 	{
 		Logger::getInstance()->fatal("getaddrinfo failed with error: " +
 				std::to_string(res));
-		WSACleanup();
+		cleanupSocketLibrary();
 		fgetc(stdin);
 		exit(1);
 	}
@@ -87,9 +114,9 @@ void NetworkServer::connectionListener(
 	if (listenSock == INVALID_SOCKET)
 	{
 		Logger::getInstance()->fatal("Failed to create socket with error: " +
-				std::to_string(WSAGetLastError()));
+				std::to_string(getLastSocketError()));
 		freeaddrinfo(result);
-		WSACleanup();
+		cleanupSocketLibrary();
 		fgetc(stdin);
 		exit(1);
 	}
@@ -100,10 +127,10 @@ void NetworkServer::connectionListener(
 	if (res == SOCKET_ERROR)
 	{
 		Logger::getInstance()->fatal("Failed to bind socket with error: " +
-				std::to_string(WSAGetLastError()));
+				std::to_string(getLastSocketError()));
 		freeaddrinfo(result);
-		closesocket(listenSock);
-		WSACleanup();
+		closeSocket(listenSock);
+		cleanupSocketLibrary();
 		fgetc(stdin);
 		exit(1);
 	}
@@ -114,9 +141,9 @@ void NetworkServer::connectionListener(
 	if (res == SOCKET_ERROR)
 	{
 		Logger::getInstance()->fatal("Failed to put socket in listening mode " +
-				std::string("with error: ") + std::to_string(WSAGetLastError()));
-		closesocket(listenSock);
-		WSACleanup();
+				std::string("with error: ") + std::to_string(getLastSocketError()));
+		closeSocket(listenSock);
+		cleanupSocketLibrary();
 		fgetc(stdin);
 		exit(1);
 	}
@@ -136,39 +163,54 @@ void NetworkServer::connectionListener(
 		if (_sessions.size() >= maxConnections)
 		{
 			Logger::getInstance()->info("Rejecting new connection, server is full");
-			closesocket(tempSock);
+			closeSocket(tempSock);
 			continue;
 		}
 		lock.unlock();
 
-		// Otherwise create a player session for the new socket
+		// Otherwise find a room and create a player session for the new socket
 		if (tempSock != INVALID_SOCKET)
 		{
-			char one = 1;
-			setsockopt(tempSock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			uint32_t roomId = 0;
+			if (_roomAssigner && !_roomAssigner(roomId))
+			{
+				Logger::getInstance()->info("Rejecting new connection, every room is full");
+				closeSocket(tempSock);
+				continue;
+			}
+
+			setNoDelay(tempSock);
 			SocketState clientState =
 			{
 				IdGenerator::getInstance()->getNextId(), // create a new player id
+				roomId, // room id
+				getEventRing(roomId), // room's event ring
 				tempSock, // socket
 				(char*)calloc(1, RECV_BUFSIZE), // read buffer
 				false, // is reading
 				0, // length (bytes to read)
 				0, // bytes read
-				std::vector<char>() // write buffer
+				new SendQueue(SEND_BUFSIZE, SEND_HIGH_WATER_MARK, SEND_MAX_BACKLOG),
+				false, // is write blocked
+				false, // is congested
+				false // is overflowed
 			};
 
 			Logger::getInstance()->info("Accepting new connection with playerId: " +
-					std::to_string(clientState.playerId));
+					std::to_string(clientState.playerId) + " into room " +
+					std::to_string(roomId));
 
-			// Send player ID (4 bytes) at the beginning of connection
+			// Send player ID (4 bytes) at the beginning of connection, followed
+			// by the wire formats the client can pick from (4 bytes)
+			uint32_t handshake[2] = { clientState.playerId, SUPPORTED_WIRE_FORMATS };
 			int bytesSent = 0;
-			while (bytesSent != sizeof(uint32_t))
+			while (bytesSent != sizeof(handshake))
 			{
 				int sendResult = send(
 						tempSock,
-						(char*)(&(clientState.playerId)) + bytesSent,
-						sizeof(uint32_t) - bytesSent,
-						0);
+						(char*)handshake + bytesSent,
+						sizeof(handshake) - bytesSent,
+						SEND_FLAGS);
 
 				if (sendResult > 0)
 				{
@@ -176,43 +218,57 @@ void NetworkServer::connectionListener(
 				}
 				else if (!sendResult || sendResult == SOCKET_ERROR)
 				{
-					Logger::getInstance()->error("Failed to send player ID to new client");
+					Logger::getInstance()->error("Failed to send handshake to new client");
 					free(clientState.readBuf);
-					closesocket(tempSock);
+					delete clientState.sendQueue;
+					closeSocket(tempSock);
 					tempSock = INVALID_SOCKET;
-					continue;
+					break;
 				}
 			}
 
-			// Set socket as non-blocking
-			u_long socketMode = 1;
-			res = ioctlsocket(tempSock, FIONBIO, &socketMode);
+			if (tempSock == INVALID_SOCKET)
+			{
+				continue;
+			}
 
-			// Check if error setting as non-blocking
-			if (res == SOCKET_ERROR)
+			// Set socket as non-blocking, and check for errors
+			if (!setNonBlocking(tempSock))
 			{
 				Logger::getInstance()->fatal(
 						"Failed to set socket as non-blocking. Error code: " +
-						std::to_string(res));
+						std::to_string(getLastSocketError()));
 				free(clientState.readBuf);
-				closesocket(tempSock);
-				WSACleanup();
+				delete clientState.sendQueue;
+				closeSocket(tempSock);
+				cleanupSocketLibrary();
 				exit(1);
 			}
 
 			// unlocks when out of scope
 			std::unique_lock<std::shared_mutex> lock(_sessionMutex);
 
-			// Add to session map
+			// Add to session map, then start watching the socket. The session
+			// must exist before the read thread can hear about it.
 			_sessions.insert({clientState.playerId, clientState});
 
+			if (!_socketBackend->addSocket(tempSock, clientState.playerId))
+			{
+				Logger::getInstance()->error("Failed to watch socket for player " +
+						std::to_string(clientState.playerId));
+				_sessions.erase(clientState.playerId);
+				free(clientState.readBuf);
+				delete clientState.sendQueue;
+				closeSocket(tempSock);
+			}
+
 			tempSock = INVALID_SOCKET;
 		}
 		else
 		{
 			Logger::getInstance()->error(
 					"Client connection failed with error: " +
-					std::to_string(WSAGetLastError()));
+					std::to_string(getLastSocketError()));
 		}
 	}
 }
@@ -220,156 +276,207 @@ void NetworkServer::connectionListener(
 
 void NetworkServer::socketReadHandler()
 {
-	// Read socket set for select()
-	FD_SET readSet;
-	FD_SET exceptSet;
-
-	// String stream for reading from sockets
-	std::stringstream ss;
+	// Socket activity, filled in by the backend
+	std::vector<SocketEvent> events;
+	events.reserve(SOCKET_MAX_EVENTS);
 
 	// List of dead sockets to kill
 	std::queue<uint32_t> sessionsToKill = std::queue<uint32_t>();
 
-	// Timeval struct for timeout
-	TIMEVAL * timeout = (TIMEVAL *)calloc(1, sizeof(timeout));
-	timeout->tv_sec = SELECT_TIMEOUT_SEC;
-
 	while (true)
 	{
-		// Reset readSet and add sockets from session map
-		FD_ZERO(&readSet);
-		FD_ZERO(&exceptSet);
-		std::shared_lock<std::shared_mutex> lock(_sessionMutex);
-
-		// If no active sessions, sleep and restart the loop
-		if (!_sessions.size())
+		// Wait for read activity. The backend sleeps for the timeout if
+		// there are no sessions.
+		events.clear();
+		if (_socketBackend->wait(events, SOCKET_WAIT_TIMEOUT_MS) < 0)
 		{
-			lock.unlock();
-			std::this_thread::sleep_for(std::chrono::seconds(SELECT_TIMEOUT_SEC));
+			Logger::getInstance()->warn(
+					"Socket backend returned error in read thread: " +
+					std::to_string(getLastSocketError()));
 			continue;
 		}
 
-		// Set read and except FDs
-		for (auto& pair : _sessions)
+		auto readStart = std::chrono::steady_clock::now();
+
+		// Only visit the sessions that actually have activity. The session
+		// lock is taken per session rather than for the whole pass, so
+		// closing a session never waits on more than one being read.
+		for (auto& event : events)
 		{
-			FD_SET(pair.second.socket, &readSet);
-			FD_SET(pair.second.socket, &exceptSet);
+			std::shared_lock<std::shared_mutex> lock(_sessionMutex);
+			auto result = _sessions.find(event.playerId);
+
+			// Session may have been closed since the event was queued
+			if (result == _sessions.end())
+			{
+				continue;
+			}
+
+			SocketState * session = &(result->second);
+
+			// If readable, recv and push to buffer. Errored sockets are still
+			// read so that we log the actual error code.
+			if ((event.isReadable || event.isError) && !readSession(session))
+			{
+				sessionsToKill.push(session->playerId);
+				continue;
+			}
+
+			// If writable, send whatever the write thread could not
+			if (event.isWritable)
+			{
+				std::unique_lock<std::mutex> writeLock(session->sendQueue->getMutex());
+				if (flushSession(session) == FLUSH_ERROR)
+				{
+					sessionsToKill.push(session->playerId);
+				}
+			}
 		}
 
-		// Unlock and wait for read activity
-		lock.unlock();
+		auto readEnd = std::chrono::steady_clock::now();
+		_readTime += readEnd - readStart;
+		_maxReadTime = std::max(_maxReadTime,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(readEnd - readStart));
 
-		if (select(0, &readSet, NULL, &exceptSet, timeout) == SOCKET_ERROR)
+		// Kill sessions marked for death
+		while (!sessionsToKill.empty())
 		{
-			Logger::getInstance()->warn(
-					"select() returned error in read thread: " +
-					std::to_string(WSAGetLastError()));
+			closePlayerSession(sessionsToKill.front());
+			sessionsToKill.pop();
 		}
-		else
+
+		if (readEnd - _lastInputReport >= INPUT_REPORT_INTERVAL)
 		{
-			std::shared_lock<std::shared_mutex> lock(_sessionMutex);
+			reportInput();
+			_lastInputReport = readEnd;
+		}
+	}
+}
 
-			// Iterate over sessions
-			for (auto& pair : _sessions)
+
+bool NetworkServer::readSession(SocketState * session)
+{
+	// Backends may be edge-triggered, so keep reading until recv() would block
+	while (true)
+	{
+		// A single event larger than the buffer can never be read
+		if (session->bytesRead >= RECV_BUFSIZE)
+		{
+			Logger::getInstance()->info(
+					"Read buffer overflow for player " +
+					std::to_string(session->playerId));
+			return false;
+		}
+
+		int recvResult = recv(
+				session->socket,
+				session->readBuf + session->bytesRead,
+				RECV_BUFSIZE - session->bytesRead,
+				0);
+
+		// If zero, we had a clean disconnect, so mark as dead
+		if (!recvResult)
+		{
+			return false;
+		}
+		else if (recvResult == SOCKET_ERROR)
+		{
+			// Nothing more to read for now
+			int error = getLastSocketError();
+			if (isWouldBlock(error))
 			{
-				SocketState * session = &(pair.second);
+				return true;
+			}
+
+			// Otherwise we had a miscellaneous error. Mark as dead.
+			Logger::getInstance()->info(
+					"Encountered error while reading socket for player " +
+					std::to_string(session->playerId) + " with code " +
+					std::to_string(error));
+			return false;
+		}
 
-				// If in the read set, recv and push to buffer
-				if (FD_ISSET(session->socket, &readSet))
+		session->bytesRead += recvResult;
+
+		while ((session->isReading && (session->length + sizeof(uint32_t)) <= session->bytesRead) ||
+				(!session->isReading && session->bytesRead >= sizeof(uint32_t)))
+		{
+			// If we're not in reading mode and received at least
+			// four bytes, store length and go into reading mode.
+			if (!session->isReading && session->bytesRead >= sizeof(uint32_t))
+			{
+				// Get the first four bytes and store as length
+				memcpy(&(session->length), session->readBuf, sizeof(uint32_t));
+				session->isReading = true;
+			}
+
+			// Deserialize object
+			if (session->isReading && session->bytesRead >= (session->length + sizeof(uint32_t)))
+			{
+				// Clients send a shared_ptr, which is an ID followed by the
+				// object itself the first time. Decoding the object in place
+				// saves allocating one per event.
+				ArrayStreamBuf streamBuf(session->readBuf + sizeof(uint32_t), session->length);
+				std::istream stream(&streamBuf);
+				cereal::BinaryInputArchive iarchive(stream);
+				uint32_t pointerId = 0;
+				iarchive(pointerId);
+				if (!(pointerId & cereal::detail::msb_32bit))
 				{
-					int recvResult = recv(
-							session->socket,
-							session->readBuf + session->bytesRead,
-							RECV_BUFSIZE - session->bytesRead,
-							0);
-
-					// If zero, we had a clean disconnect, so mark as dead
-					if (!recvResult)
-					{
-						// Mark socket as dead
-						sessionsToKill.push(session->playerId);
-					}
-					else if (recvResult != SOCKET_ERROR)
-					{
-						session->bytesRead += recvResult;
-
-						while ((session->isReading && (session->length + sizeof(uint32_t)) <= session->bytesRead) ||
-								(!session->isReading && session->bytesRead >= sizeof(uint32_t)))
-						{
-							// If we're not in reading mode and received at least
-							// four bytes, store length and go into reading mode.
-							if (!session->isReading && session->bytesRead >= sizeof(uint32_t))
-							{
-								// Get the first four bytes and store as length
-								memcpy(&(session->length), session->readBuf, sizeof(uint32_t));
-								session->isReading = true;
-							}
-
-							// Deserialize object
-							if (session->isReading && session->bytesRead >= (session->length + sizeof(uint32_t)))
-							{
-								ss.write(session->readBuf + sizeof(uint32_t), session->length);
-								cereal::BinaryInputArchive iarchive(ss);
-								std::shared_ptr<GameEvent> eventPtr;
-								iarchive(eventPtr);
-
-								// Enforce correct player ID
-								eventPtr->playerId = session->playerId;
-
-								// Lock and add to queue
-								std::unique_lock<std::mutex> eventLock(_eventMutex);
-								_eventQueue->push(eventPtr);
-								eventLock.unlock();
-
-								// reset state
-								session->bytesRead -= (session->length + sizeof(uint32_t));
-								session->isReading = false;
-
-								// Effectively "remove" length and item from buffer
-								memmove(
-										session->readBuf,
-										session->readBuf + session->length + sizeof(uint32_t), 
-										RECV_BUFSIZE - (session->length + sizeof(uint32_t)));
-							}
-						}
-					}
-					else
-					{
-						// Otherwise we had a miscellaneous error. Mark as dead.
-						if (WSAGetLastError() != WSAEWOULDBLOCK)
-						{
-							Logger::getInstance()->info(
-									"Encountered error while reading socket for player " +
-									std::to_string(session->playerId) + " with code " +
-									std::to_string(WSAGetLastError()));
-
-							sessionsToKill.push(session->playerId);
-						}
-					}
+					Logger::getInstance()->info(
+							"Player " + std::to_string(session->playerId) +
+							" sent an empty event");
+					return false;
 				}
 
-				// If in the exception set, mark session as dead.
-				if (FD_ISSET(session->socket, &exceptSet))
+				GameEvent * eventPtr = &_readEvent;
+				iarchive(*eventPtr);
+
+				// Enforce correct player ID
+				eventPtr->playerId = session->playerId;
+
+				if (eventPtr->type == EVENT_SNAPSHOT_ACK)
+				{
+					// Acks move the delta baselines forward; the game never
+					// needs to see them
+					std::unique_lock<std::mutex> writeLock(session->sendQueue->getMutex());
+					session->sendQueue->acknowledge(eventPtr->sequence);
+				}
+				else if (eventPtr->type == EVENT_SET_WIRE_FORMAT)
 				{
-					// Mark socket as dead 
-					if (WSAGetLastError() != WSAEWOULDBLOCK)
+					if (eventPtr->wireFormat >= WIRE_FORMAT_COUNT ||
+						!(SUPPORTED_WIRE_FORMATS & WIRE_FORMAT_BIT(eventPtr->wireFormat)))
 					{
 						Logger::getInstance()->info(
-								"Encountered error while reading socket for player " +
-								std::to_string(session->playerId) + " with code " +
-								std::to_string(WSAGetLastError()));
+								"Player " + std::to_string(session->playerId) +
+								" asked for unknown wire format " +
+								std::to_string(eventPtr->wireFormat));
+						return false;
+					}
 
-						sessionsToKill.push(session->playerId);
+					// Anything queued while the client was deciding can go
+					// out now
+					std::unique_lock<std::mutex> writeLock(session->sendQueue->getMutex());
+					session->sendQueue->setWireFormat(eventPtr->wireFormat);
+					if (flushSession(session) == FLUSH_ERROR)
+					{
+						return false;
 					}
 				}
-			}
+				else
+				{
+					session->eventRing->push(*eventPtr);
+				}
 
-			// Kill sessions marked for death
-			lock.unlock();
-			while (!sessionsToKill.empty())
-			{
-				closePlayerSession(sessionsToKill.front());
-				sessionsToKill.pop();
+				// reset state
+				session->bytesRead -= (session->length + sizeof(uint32_t));
+				session->isReading = false;
+
+				// Effectively "remove" length and item from buffer
+				memmove(
+						session->readBuf,
+						session->readBuf + session->length + sizeof(uint32_t),
+						RECV_BUFSIZE - (session->length + sizeof(uint32_t)));
 			}
 		}
 	}
@@ -378,12 +485,16 @@ void NetworkServer::socketReadHandler()
 
 void NetworkServer::socketWriteHandler()
 {
-	// Set of write sockets; written to by the select() system call
-	FD_SET writeSet;
-
 	// List of dead sockets to kill
 	std::queue<uint32_t> sessionsToKill = std::queue<uint32_t>();
 
+	// Sessions that were handed new data this batch
+	std::vector<uint32_t> sessionsToFlush;
+
+	// Items taken off the update queue this batch
+	std::vector<QueuedUpdate> items;
+	items.reserve(SEND_MAX_BATCH);
+
 	while (true)
 	{
 		// If no clients, sleep and restart the loop
@@ -391,103 +502,108 @@ void NetworkServer::socketWriteHandler()
 		if (!_sessions.size())
 		{
 			preLock.unlock();
-			std::this_thread::sleep_for(std::chrono::seconds(SELECT_TIMEOUT_SEC));
+			std::this_thread::sleep_for(std::chrono::milliseconds(SOCKET_WAIT_TIMEOUT_MS));
 			continue;
 		}
 		preLock.unlock();
 
 		// Retreive next item from queue. This will block until an item appears
 		// on the queue.
-		std::pair<uint32_t, std::shared_ptr<BaseState>> nextPair;
-		_updateQueue->pop(nextPair);
+		items.resize(1);
+		_updateQueue->pop(items[0]);
 
-		// Grab player ID and shared pointer from pair
-		uint32_t playerId = nextPair.first;
-		std::shared_ptr<BaseState> nextItem = nextPair.second;
-
-		// Create an output archive and serialize the object from the queue
-		std::stringstream ss;
-		cereal::BinaryOutputArchive oarchive(ss);
-		oarchive(nextItem);
-
-		// Get size of serialized object
-		ss.seekg(0, std::ios::end);
-		uint32_t size = (uint32_t)ss.tellg();
-		ss.seekg(0, std::ios::beg);
-
-		// Copy into char buffer
-		char * databuf = (char*)malloc(size + sizeof(uint32_t));
-
-		// Size of serialized object first, then object itself
-		memcpy(databuf, &size, sizeof(uint32_t));
-		ss.read(databuf + sizeof(uint32_t), size);
-
-		// Reset writeSet first
-		FD_ZERO(&writeSet);
+		// Take everything that is already waiting
+		QueuedUpdate nextItem;
+		while (items.size() < SEND_MAX_BATCH && _updateQueue->tryPop(nextItem))
+		{
+			items.push_back(std::move(nextItem));
+		}
 
 		// Lock and iterate over player sessions
 		std::shared_lock<std::shared_mutex> lock(_sessionMutex);
 
-		// Add sockets to writeSet
-		for (auto& pair : _sessions)
+		// Items for the same target (usually a tick's updates followed by the
+		// GameState) are folded into a single packet. Rooms tick in parallel,
+		// so a room's items are not necessarily next to each other.
+		for (size_t i = 0; i < items.size(); i++)
 		{
-			FD_SET(pair.second.socket, &writeSet);
-		}
+			if (items[i].isFolded)
+			{
+				continue;
+			}
 
-		// Call select() without a timeout to see which sockets are
-		// writable. This should not block.
-		if (select(0, NULL, &writeSet, NULL, NULL) == SOCKET_ERROR)
-		{
-			Logger::getInstance()->warn(
-				"select() returned error in write thread: " +
-				std::to_string(WSAGetLastError()));
-		}
+			uint32_t roomId = items[i].roomId;
+			uint32_t playerId = items[i].playerId;
+			std::shared_ptr<UpdateBatch> batch = getFreeBatch();
 
-		for (auto& pair : _sessions)
-		{
-			SocketState session = pair.second;
+			for (size_t j = i; j < items.size(); j++)
+			{
+				QueuedUpdate & item = items[j];
+				if (!item.isFolded && item.roomId == roomId && item.playerId == playerId)
+				{
+					batch->states.insert(
+							batch->states.end(),
+							item.states.begin(),
+							item.states.end());
+					item.isFolded = true;
+				}
+			}
+
+			// Serialized once per wire format, on first push, then shared by
+			// every session's send queue
+			SendFrame frame = batch;
 
-			// Only send the data if this is the correct playerId or if no
-			// playerId was specified, AND the socket is writable
-			if ((!playerId || session.playerId == playerId) &&
-				FD_ISSET(session.socket, &writeSet))
+			for (auto& pair : _sessions)
 			{
-				std::copy(
-					databuf,
-					databuf + size + sizeof(uint32_t),
-					std::back_inserter(session.writeBuf));
+				SocketState * session = &(pair.second);
 
-				// Loop until write buffer is empty
-				while (session.writeBuf.size())
+				// Only queue the data if the session is in the room, and this
+				// is the correct playerId or no playerId was specified
+				if (session->roomId != roomId ||
+					(playerId && session->playerId != playerId))
 				{
-					int sendResult = send(
-						session.socket,
-						session.writeBuf.data(),
-						(int)session.writeBuf.size(),
-						0);
-
-					// If no error, shrink buffer
-					if (sendResult > 0)
-					{
-						session.writeBuf.erase(
-							session.writeBuf.begin(),
-							session.writeBuf.begin() + sendResult);
-					}
-					else if (sendResult == SOCKET_ERROR && WSAGetLastError() != WSAEWOULDBLOCK)
-					{
-						// Debug
-						Logger::getInstance()->info(
-								"Encountered error while writing socket for player " +
-								std::to_string(session.playerId) + " with code " +
-								std::to_string(WSAGetLastError()));
+					continue;
+				}
 
-						sessionsToKill.push(session.playerId);
-						break;
-					}
+				std::unique_lock<std::mutex> writeLock(session->sendQueue->getMutex());
+				if (session->isOverflowed)
+				{
+					continue;
+				}
+				else if (!session->sendQueue->push(frame))
+				{
+					Logger::getInstance()->info(
+							"Send backlog overflow for player " +
+							std::to_string(session->playerId));
+					session->isOverflowed = true;
+					sessionsToKill.push(session->playerId);
+					continue;
 				}
+				writeLock.unlock();
+
+				if (std::find(sessionsToFlush.begin(), sessionsToFlush.end(),
+						session->playerId) == sessionsToFlush.end())
+				{
+					sessionsToFlush.push_back(session->playerId);
+				}
+			}
+		}
+		items.clear();
+
+		// Send as much as each socket will take. Anything left over is sent by
+		// the read thread when the socket becomes writable, so a slow client
+		// never holds up the others.
+		for (auto& playerId : sessionsToFlush)
+		{
+			SocketState * session = &(_sessions.find(playerId)->second);
+
+			std::unique_lock<std::mutex> writeLock(session->sendQueue->getMutex());
+			if (!session->isOverflowed && flushSession(session) == FLUSH_ERROR)
+			{
+				sessionsToKill.push(session->playerId);
 			}
 		}
-		free(databuf);
+		sessionsToFlush.clear();
 
 		// Kill sessions marked for death
 		lock.unlock();
@@ -501,7 +617,72 @@ void NetworkServer::socketWriteHandler()
 }
 
 
-std::vector<uint32_t> NetworkServer::getPlayerList()
+std::shared_ptr<UpdateBatch> NetworkServer::getFreeBatch()
+{
+	// A batch only referenced by the pool has been sent everywhere
+	for (auto& batch : _batchPool)
+	{
+		if (batch.use_count() == 1)
+		{
+			batch->clear();
+			return batch;
+		}
+	}
+
+	auto batch = std::make_shared<UpdateBatch>();
+	if (_batchPool.size() < SEND_BATCH_POOL_SIZE)
+	{
+		_batchPool.push_back(batch);
+	}
+	return batch;
+}
+
+
+FlushResult NetworkServer::flushSession(SocketState * session)
+{
+	FlushResult result = session->sendQueue->flush(session->socket);
+
+	if (result == FLUSH_ERROR)
+	{
+		// Debug
+		Logger::getInstance()->info(
+				"Encountered error while writing socket for player " +
+				std::to_string(session->playerId) + " with code " +
+				std::to_string(getLastSocketError()));
+		return result;
+	}
+
+	// Only listen for writability while there is something left to send.
+	// Some backends are one-shot, so interest is renewed every time.
+	if (result == FLUSH_BLOCKED)
+	{
+		_socketBackend->setWriteInterest(session->socket, session->playerId, true);
+		session->isWriteBlocked = true;
+	}
+	else if (session->isWriteBlocked)
+	{
+		_socketBackend->setWriteInterest(session->socket, session->playerId, false);
+		session->isWriteBlocked = false;
+	}
+
+	// Log when a client starts and stops falling behind
+	bool isCongested = session->sendQueue->isCongested();
+	if (isCongested != session->isCongested)
+	{
+		session->isCongested = isCongested;
+		Logger::getInstance()->info(isCongested ?
+				"Player " + std::to_string(session->playerId) +
+				" is falling behind, coalescing updates" :
+				"Player " + std::to_string(session->playerId) +
+				" caught up, " + std::to_string(session->sendQueue->getCoalescedCount()) +
+				" updates coalesced so far");
+	}
+
+	return result;
+}
+
+
+std::vector<uint32_t> NetworkServer::getPlayerList(uint32_t roomId)
 {
 	auto list = std::vector<uint32_t>();
 
@@ -509,13 +690,33 @@ std::vector<uint32_t> NetworkServer::getPlayerList()
 	std::shared_lock<std::shared_mutex> lock(_sessionMutex);
 	for (auto& session : _sessions)
 	{
-		list.push_back(session.first);
+		if (session.second.roomId == roomId)
+		{
+			list.push_back(session.first);
+		}
 	}
 
 	return list;
 }
 
 
+size_t NetworkServer::getPlayerCount(uint32_t roomId)
+{
+	std::shared_lock<std::shared_mutex> lock(_sessionMutex);
+	return std::count_if(_sessions.begin(), _sessions.end(),
+		[roomId](const std::pair<const uint32_t, SocketState> & session)
+		{
+			return session.second.roomId == roomId;
+		});
+}
+
+
+bool NetworkServer::hasEvents(uint32_t roomId)
+{
+	return !getEventRing(roomId)->isEmpty();
+}
+
+
 void NetworkServer::closePlayerSession(uint32_t playerId)
 {
 	std::unique_lock<std::shared_mutex> lock(_sessionMutex);
@@ -530,18 +731,21 @@ void NetworkServer::closePlayerSession(uint32_t playerId)
 				"Closing session for player " +
 				std::to_string(playerId));
 
+		EventRing * eventRing = result->second.eventRing;
+
+		// Stop watching the socket before closing it
+		_socketBackend->removeSocket(result->second.socket, playerId);
+
 		free(result->second.readBuf);
-		closesocket(result->second.socket);
+		delete result->second.sendQueue;
+		closeSocket(result->second.socket);
 		_sessions.erase(result);
 
 		// Create a PLAYER_LEAVE event for the person that was DC'd
-		auto leaveEvent = std::make_shared<GameEvent>();
-		leaveEvent->playerId = playerId;
-		leaveEvent->type = EVENT_PLAYER_LEAVE;
-
-		// Lock and push to event queue
-		std::unique_lock<std::mutex> eventLock(_eventMutex);
-		_eventQueue->push(leaveEvent);
+		GameEvent leaveEvent = GameEvent();
+		leaveEvent.playerId = playerId;
+		leaveEvent.type = EVENT_PLAYER_LEAVE;
+		eventRing->push(leaveEvent);
 	}
 	else
 	{
@@ -552,71 +756,102 @@ void NetworkServer::closePlayerSession(uint32_t playerId)
 }
 
 
-void NetworkServer::clearQueues()
+void NetworkServer::clearQueues(uint32_t roomId)
 {
-	// Event queue first
-	std::unique_lock<std::mutex> eventLock(_eventMutex);
-	while (!_eventQueue->empty())
-	{
-		_eventQueue->pop();
-	}
-	eventLock.unlock();
+	// Event ring first
+	getEventRing(roomId)->clear();
 
 	// Update queue next. The blocking queue is internally
 	// mutexed, so no need for external locks
-	while (!_updateQueue->isEmpty())
+	_updateQueue->removeIf([roomId](const QueuedUpdate & item)
+		{
+			return item.roomId == roomId;
+		});
+}
+
+
+void NetworkServer::receiveEvents(uint32_t roomId, std::vector<std::shared_ptr<GameEvent>> & events)
+{
+	getEventRing(roomId)->drain(events);
+}
+
+
+EventRing * NetworkServer::getEventRing(uint32_t roomId)
+{
+	std::unique_lock<std::mutex> lock(_eventMutex);
+	auto& eventRing = _eventRings[roomId];
+	if (!eventRing)
 	{
-		std::pair<uint32_t, std::shared_ptr<BaseState>> garbage;
-		_updateQueue->pop(garbage);
+		eventRing = std::make_unique<EventRing>();
 	}
+	return eventRing.get();
 }
 
 
-std::vector<std::shared_ptr<GameEvent>> NetworkServer::receiveEvents()
+void NetworkServer::reportInput()
 {
-	auto eventList = std::vector<std::shared_ptr<GameEvent>>();
+	EventRing::Stats total = EventRing::Stats();
 
-	// Lock and build events from queue
 	std::unique_lock<std::mutex> lock(_eventMutex);
-	while (!_eventQueue->empty())
+	for (auto& eventRing : _eventRings)
 	{
-		eventList.push_back(_eventQueue->front());
-		_eventQueue->pop();
+		auto stats = eventRing.second->takeStats();
+		total.drained += stats.drained;
+		total.spilled += stats.spilled;
+		total.delayTotalNs += stats.delayTotalNs;
+		total.delayMaxNs = std::max(total.delayMaxNs, stats.delayMaxNs);
 	}
+	lock.unlock();
+
+	auto readTime = _readTime;
+	auto maxReadTime = _maxReadTime;
+	_readTime = std::chrono::nanoseconds(0);
+	_maxReadTime = std::chrono::nanoseconds(0);
 
-	return eventList;
+	if (!total.drained)
+	{
+		return;
+	}
+
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(1) <<
+		"Input over " << total.drained << " events: " <<
+		std::chrono::duration<double, std::micro>(readTime).count() / total.drained << "us to read each, " <<
+		"waited avg " << total.delayTotalNs / 1000.0 / total.drained << "us, " <<
+		"max " << total.delayMaxNs / 1000.0 << "us for a tick; " <<
+		"longest read pass " << std::chrono::duration<double, std::micro>(maxReadTime).count() << "us, " <<
+		total.spilled << " spilled";
+	Logger::getInstance()->info(line.str());
 }
 
 
-void NetworkServer::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates)
+void NetworkServer::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t roomId)
 {
-	for (auto& update : updates)
-	{
-		sendUpdate(update);
-	}
+	sendUpdates(updates, roomId, 0);
 }
 
 
-void NetworkServer::sendUpdate(std::shared_ptr<BaseState> update)
+void NetworkServer::sendUpdate(std::shared_ptr<BaseState> update, uint32_t roomId)
 {
-	// We are sending to all players, so use 0 as playerId
-	std::pair<uint32_t, std::shared_ptr<BaseState>> updatePair = std::make_pair(0, update);
-	_updateQueue->push(updatePair);
+	// We are sending to all players in the room, so use 0 as playerId
+	sendUpdate(update, roomId, 0);
 }
 
 
-void NetworkServer::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId)
+void NetworkServer::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t roomId, uint32_t playerId)
 {
-	for (auto& update : updates)
+	if (updates.empty())
 	{
-		sendUpdate(update, playerId);
+		return;
 	}
+
+	// The whole list goes out as a single packet
+	QueuedUpdate item = { roomId, playerId, std::move(updates), false };
+	_updateQueue->push(item);
 }
 
 
-void NetworkServer::sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId)
+void NetworkServer::sendUpdate(std::shared_ptr<BaseState> update, uint32_t roomId, uint32_t playerId)
 {
-	// We are sending to just one player
-	std::pair<uint32_t, std::shared_ptr<BaseState>> updatePair = std::make_pair(playerId, update);
-	_updateQueue->push(updatePair);
+	sendUpdates(std::vector<std::shared_ptr<BaseState>>({ update }), roomId, playerId);
 }
@@ -2,28 +2,66 @@
 
 #include <vector>
 #include <memory>
-#include <winsock2.h>
-#include <WS2tcpip.h>
+#include <queue>
+#include <unordered_map>
 #include <thread>
 #include <chrono>
 #include <iostream>
 #include <shared_mutex>
-#include <utility>
+#include <functional>
 
 #include "Shared/BaseState.hpp"
 #include "Shared/GameEvent.hpp"
 #include "Shared/BlockingQueue.hpp"
 #include "IdGenerator.hpp"
+#include "SocketCompat.hpp"
+#include "SocketBackend.hpp"
+#include "SendQueue.hpp"
+#include "EventRing.hpp"
 
-#define MAX_CONNECTIONS 50
-#define SELECT_TIMEOUT_SEC 1   // Timeout for the select() syscall
+#define MAX_CONNECTIONS 512
 #define RECV_BUFSIZE 8192
-#define SEND_BUFSIZE 8192
+
+// Per-session send ring size
+#define SEND_BUFSIZE 65536
+
+// Once this many bytes are backed up behind a session's send ring, updates
+// for the same entity start replacing each other instead of piling up
+#define SEND_HIGH_WATER_MARK 32768
+
+// A session backed up past this point is disconnected
+#define SEND_MAX_BACKLOG (4 * 1024 * 1024)
+
+// Max number of queued update lists the write thread takes before flushing
+#define SEND_MAX_BATCH 256
+
+// Number of serialized batches kept around for their buffers to be reused.
+// Batches stay in use until every client has acked them.
+#define SEND_BATCH_POOL_SIZE 64
+
+// How often the read thread logs input stats
+#define INPUT_REPORT_INTERVAL std::chrono::seconds(10)
+
+/*
+** Picks the room a new player session goes in. Returns false if there is no
+** room for it, in which case the connection is refused. Called from the
+** listener thread.
+*/
+typedef std::function<bool(uint32_t & roomId)> RoomAssigner;
 
 /*
 ** Class to interact with clients over the network. Public documentation marked
 ** with "API".
 **
+** Every session belongs to a room, picked by the RoomAssigner when it
+** connects. Events are queued per room, and updates only go to sessions in
+** the room they were sent to, so each room can run its own game without
+** seeing the others. Rooms talk to this through a RoomNetwork.
+**
+** Events reach their room through its EventRing, without taking a lock. How
+** long they wait there, and how long the read thread spends decoding them,
+** is logged every INPUT_REPORT_INTERVAL.
+**
 ** Note that there is currently no conversion of endianness to network byte
 ** order (and vice versa), because it would be more overhead for little gain.
 ** x86 is little endian, and we will not be working with big endian machines.
@@ -36,12 +74,15 @@ class NetworkServer
 public:
 	/*
 	** API: This will initialize the network server and start listening for new
-	** connections.
+	** connections. Without a roomAssigner, every session goes in room 0.
 	**
-	** Internal: Initialize queues, spawn a thread with connectionListener()
-	** to listen for new player connections.
+	** Internal: Initialize queues and the socket backend, spawn a thread with
+	** connectionListener() to listen for new player connections.
 	*/
-	NetworkServer(std::string port);
+	NetworkServer(
+			std::string port,
+			RoomAssigner roomAssigner = nullptr,
+			SocketBackendType backendType = DEFAULT_SOCKET_BACKEND);
 
 	/*
 	** Internal: Close connections and destroy queues.
@@ -49,51 +90,64 @@ public:
 	~NetworkServer();
 
 	/*
-	** API: Returns a vector of active player IDs. Synchronous.
+	** API: Returns a vector of active player IDs in a room. Synchronous.
+	*/
+	std::vector<uint32_t> getPlayerList(uint32_t roomId);
+
+	/*
+	** API: Returns the number of active players in a room. Synchronous.
+	*/
+	size_t getPlayerCount(uint32_t roomId);
+
+	/*
+	** API: Returns whether a room has events waiting to be received.
+	** Synchronous.
 	*/
-	std::vector<uint32_t> getPlayerList();
-	
+	bool hasEvents(uint32_t roomId);
+
 	/*
 	** API: Forcefully disconnects a player from the server. Synchronous.
 	**
 	** Throws: runtime_exception if the playerId could not be found.
 	**
-	** Internal: Removes player session with playerId from _sessions.
+	** Internal: Removes player session with playerId from _sessions, and
+	** queues a PLAYER_LEAVE event for its room.
 	*/
 	void closePlayerSession(uint32_t playerId);
 
-	// Reset all queues completely
-	void clearQueues();
+	// Drop every event and update queued for a room
+	void clearQueues(uint32_t roomId);
 
 	/*
-	** API: receive events from all clients. No guarantees on client order, but
-	** events should be received in order on a per-client basis. Synchronous
-	** for the calling thread; asynchronous with respect to the network. Note
-	** that player ID's inside the GameEvent struct are overwritten based on
-	** the player's socket, so it is safe to send any kind of event from the
-	** client side.
+	** API: receive events from all clients in a room, appending them to
+	** events. No guarantees on client order, but events should be received in
+	** order on a per-client basis. Synchronous for the calling thread;
+	** asynchronous with respect to the network. Note that player ID's inside
+	** the GameEvent struct are overwritten based on the player's socket, so it
+	** is safe to send any kind of event from the client side.
 	**
-	** Internal: Returns the contents of the _eventQueue, removing them from
-	** the queue.
+	** Internal: Drains the room's event ring. Must only be called by the
+	** room's own tick.
 	*/
-	std::vector<std::shared_ptr<GameEvent>> receiveEvents();
+	void receiveEvents(uint32_t roomId, std::vector<std::shared_ptr<GameEvent>> & events);
 
 	/*
-	** API: Send updates to all clients. No guarantees on client order, but
-	** updates will be sent in order on a per-client basis. Try to avoid
-	** calling this function when no clients are connected, as updates will
-	** fill an internal queue. Synchronous for the calling thread;
+	** API: Send updates to all clients in a room. No guarantees on client
+	** order, but updates will be sent in order on a per-client basis. Try to
+	** avoid calling this function when no clients are connected, as updates
+	** will fill an internal queue. Synchronous for the calling thread;
 	** asynchronous with respect to the network.
 	**
-	** Internal: Add updates to the _updateQueue, to be sent by
-	** socketHandler(). PlayerID is set to 0 in the pairs added to the queue.
+	** Internal: Add updates to the _updateQueue as a single item, to be sent
+	** by socketWriteHandler() as one packet. PlayerID is set to 0 in the item
+	** added to the queue.
 	*/
-	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates);
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t roomId);
 
 	/*
 	** Same as above, except it sends a single update only.
 	*/
-	void sendUpdate(std::shared_ptr<BaseState> update);
+	void sendUpdate(std::shared_ptr<BaseState> update, uint32_t roomId);
 
 	/*
 	** API: Send updates to a particular client. Use this if updates need to be
@@ -101,15 +155,15 @@ public:
 	** above for other details. Note that if there is no player with the
 	** specified ID, the updates will be lost.
 	**
-	** Internal: Works the same way as above, except PlayerIDs in the pairs are
+	** Internal: Works the same way as above, except PlayerIDs in the items are
 	** set to the value that is passed to this function.
 	**/
-	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId);
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t roomId, uint32_t playerId);
 
 	/*
 	** Same as above, except it sends a single update only.
 	*/
-	void sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId);
+	void sendUpdate(std::shared_ptr<BaseState> update, uint32_t roomId, uint32_t playerId);
 
 
 private:
@@ -119,29 +173,63 @@ private:
 	*/
 	void connectionListener(
 			std::string port,
-			uint8_t maxConnections);
+			size_t maxConnections);
 
 	/*
-	** Pulls from player sockets and adds to the _eventQueue. Handles all
+	** Pulls from player sockets and adds to the event queues. Handles all
 	** active player connections. Inactive sockets are handled in this thread.
 	*/
 	void socketReadHandler();
 
 	/*
-	** Sends to player sockets and removes from the _updateQueue. Handles all
-	** active player connections. Does NOT handle dead connections.
+	** Removes from the _updateQueue, folds the items for each target into one
+	** UpdateBatch, in the order they were sent, serializes it once and queues
+	** it on the send queue of every session it is meant for, then flushes
+	** those queues without blocking. Whatever a socket cannot take right now
+	** is flushed by the read thread once the socket is writable again.
 	*/
 	void socketWriteHandler();
 
-	// Event queue and mutex
-	std::unique_ptr<std::queue<std::shared_ptr<GameEvent>>> _eventQueue;
+	/*
+	** Returns an empty batch, reusing the buffers of a pooled one that no
+	** session holds anymore if possible. Only used by the write thread.
+	*/
+	std::shared_ptr<UpdateBatch> getFreeBatch();
+
+	/*
+	** Updates sent by a room. If the playerID is zero, the updates are sent to
+	** all clients in the room; otherwise, they are sent to the socket mapped
+	** to that playerID.
+	*/
+	struct QueuedUpdate
+	{
+		uint32_t roomId;
+		uint32_t playerId;
+		std::vector<std::shared_ptr<BaseState>> states;
+		bool isFolded;	// Already added to a batch by the write thread
+	};
+
+	RoomAssigner _roomAssigner;
+
+	// Event rings by room ID. The mutex only guards the map; rooms are never
+	// removed, so rings live as long as the server.
+	std::unordered_map<uint32_t, std::unique_ptr<EventRing>> _eventRings;
 	std::mutex _eventMutex;
 
-	// Blocking update queue. Stores pairs of playerIDs and BaseState pointers.
-	// If the playerID is zero, the update is sent to all clients; otherwise,
-	// it is sent to the socket mapped to that playerID.
-	std::unique_ptr<BlockingQueue<std::pair<uint32_t, std::shared_ptr<BaseState>>>> _updateQueue;
-	
+	// Decoded event, reused by the read thread
+	GameEvent _readEvent;
+
+	// Time the read thread spent reading and decoding since the last report
+	std::chrono::nanoseconds _readTime;
+	std::chrono::nanoseconds _maxReadTime;	// In a single pass
+	std::chrono::steady_clock::time_point _lastInputReport;
+
+	// Blocking update queue, shared by every room
+	std::unique_ptr<BlockingQueue<QueuedUpdate>> _updateQueue;
+
+	// Batches whose buffers are recycled by the write thread
+	std::vector<std::shared_ptr<UpdateBatch>> _batchPool;
+
 	// I/O threads
 	std::thread _listenerThread, _readThread, _writeThread;
 
@@ -152,6 +240,8 @@ private:
 	struct SocketState
 	{
 		uint32_t playerId;
+		uint32_t roomId;
+		EventRing * eventRing;	// The room's
 		SOCKET socket;
 
 		// Read stuff
@@ -160,12 +250,38 @@ private:
 		uint32_t length;
 		uint32_t bytesRead;
 
-		// Write stuff
-		std::vector<char> writeBuf;
+		// Write stuff. The queue's mutex guards the rest of these fields.
+		SendQueue * sendQueue;
+		bool isWriteBlocked;	// Waiting for the socket to become writable
+		bool isCongested;		// Send backlog is over the high-water mark
+		bool isOverflowed;		// Send backlog hit the hard limit; session is dying
 	};
 
+	/*
+	** Reads from a session's socket until it would block, pushing every
+	** complete event onto its room's event ring. Returns false if the session is
+	** dead and should be closed. Called by socketReadHandler().
+	*/
+	bool readSession(SocketState * session);
+
+	// Returns the event ring for a room, creating it the first time
+	EventRing * getEventRing(uint32_t roomId);
+
+	// Logs and clears the input stats. Called by socketReadHandler().
+	void reportInput();
+
+	/*
+	** Sends as much of a session's send queue as the socket will take, and
+	** asks the socket backend for a writable event if it could not all go.
+	** The session's send queue mutex must be held.
+	*/
+	FlushResult flushSession(SocketState * session);
+
 	// Client session state map from player id to session
 	std::unordered_map<uint32_t, SocketState> _sessions;
 	mutable std::shared_mutex _sessionMutex;
+
+	// Readiness notification for player sockets (select, epoll or io_uring)
+	std::unique_ptr<SocketBackend> _socketBackend;
 };
 
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "Shared/Common.hpp"
+#include "Shared/Logger.hpp"
+#include "Profiler.hpp"
+
+// The tick being added up on this thread, if any
+static thread_local Profiler::Tick currentTick;
+static thread_local Profiler::Tick lastTick;
+static thread_local bool isInTick = false;
+static thread_local std::chrono::steady_clock::time_point tickStart;
+
+Histogram::Histogram()
+{
+	for (auto& bucket : _buckets)
+	{
+		bucket = 0;
+	}
+	_sum = 0;
+	_max = 0;
+}
+
+size_t Histogram::getBucket(uint64_t value)
+{
+	if (value < HISTOGRAM_SUB_BUCKETS)
+	{
+		return (size_t)value;
+	}
+
+	size_t highBit = 0;
+	for (uint64_t rest = value >> 1; rest; rest >>= 1)
+	{
+		highBit++;
+	}
+
+	// The bits under the highest one pick the sub-bucket
+	size_t shift = highBit - HISTOGRAM_SUB_BITS;
+	return shift * HISTOGRAM_SUB_BUCKETS + (size_t)(value >> shift);
+}
+
+uint64_t Histogram::getBucketEnd(size_t bucket)
+{
+	if (bucket < 2 * HISTOGRAM_SUB_BUCKETS)
+	{
+		return bucket + 1;
+	}
+
+	// Wraps to 0 for the last bucket, which has no end
+	size_t shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+	uint64_t leading = bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS;
+	return (leading + 1) << shift;
+}
+
+void Histogram::record(uint64_t value)
+{
+	_buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t max = _max.load(std::memory_order_relaxed);
+	while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+void Histogram::takeSnapshot(Snapshot & snapshot)
+{
+	snapshot.count = 0;
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		snapshot.buckets[i] = _buckets[i].exchange(0, std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[i];
+	}
+	snapshot.sum = _sum.exchange(0, std::memory_order_relaxed);
+	snapshot.max = _max.exchange(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::Snapshot::percentile(double percent) const
+{
+	uint64_t seen = 0;
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		seen += buckets[i];
+		if (seen && seen >= count * percent / 100)
+		{
+			return std::min(getBucketEnd(i) - 1, max);
+		}
+	}
+	return max;
+}
+
+void Profiler::add(ProfileMetric metric, uint64_t value)
+{
+	if (isInTick)
+	{
+		currentTick.values[metric] += value;
+		currentTick.touched |= 1u << metric;
+	}
+	else
+	{
+		_histograms[metric].record(value);
+	}
+}
+
+void Profiler::beginTick()
+{
+	currentTick.values.fill(0);
+	currentTick.touched = 0;
+	isInTick = true;
+	tickStart = std::chrono::steady_clock::now();
+}
+
+void Profiler::endTick()
+{
+	auto elapsed = std::chrono::steady_clock::now() - tickStart;
+	isInTick = false;
+
+	currentTick.values[PROFILE_ROOM_TICK] =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	currentTick.touched |= 1u << PROFILE_ROOM_TICK;
+
+	for (size_t i = 0; i < PROFILE_METRIC_COUNT; i++)
+	{
+		if (currentTick.touched & (1u << i))
+		{
+			_histograms[i].record(currentTick.values[i]);
+		}
+	}
+
+	lastTick = currentTick;
+}
+
+const Profiler::Tick & Profiler::getLastTick()
+{
+	return lastTick;
+}
+
+void Profiler::startExporter(std::string path)
+{
+	Logger::getInstance()->info("Exporting metrics to " + path);
+	std::thread(&Profiler::exportLoop, this, path).detach();
+}
+
+const char * Profiler::getName(ProfileMetric metric)
+{
+	static const char * names[] = {
+		"tick",
+		"room_tick",
+		"event_ingest",
+		"entity_update",
+		"broad_phase",
+		"narrow_phase",
+		"game_state",
+		"snapshot_build",
+		"serialization",
+		"cleanup",
+		"ticked",
+		"changed",
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == PROFILE_METRIC_COUNT,
+		"Every metric needs a name");
+
+	return names[metric];
+}
+
+void Profiler::exportLoop(std::string path)
+{
+	while (true)
+	{
+		std::this_thread::sleep_for(PROFILE_EXPORT_INTERVAL);
+
+		for (size_t i = 0; i < PROFILE_METRIC_COUNT; i++)
+		{
+			_histograms[i].takeSnapshot(_snapshots[i]);
+			_totalCounts[i] += _snapshots[i].count;
+			_totalSums[i] += _snapshots[i].sum;
+		}
+
+		writeMetrics(path);
+		logSummary();
+	}
+}
+
+void Profiler::writeMetrics(const std::string & path)
+{
+	std::ostringstream out;
+
+	// Summaries: quantiles over the last interval, with sums and counts
+	// since startup, and the max of the last interval on the side
+	auto writeMetric = [this, &out](const char * name, const char * label, double scale,
+		size_t begin, size_t end)
+	{
+		out << "# TYPE " << name << " summary\n";
+		for (size_t i = begin; i < end; i++)
+		{
+			auto& snapshot = _snapshots[i];
+			std::string labels = std::string(label) + "=\"" + getName((ProfileMetric)i) + "\"";
+			for (double quantile : { 0.5, 0.99 })
+			{
+				out << name << "{" << labels << ",quantile=\"" << quantile << "\"} ";
+				if (snapshot.count)
+					out << snapshot.percentile(quantile * 100) * scale << "\n";
+				else
+					out << "NaN\n";
+			}
+			out << name << "_sum{" << labels << "} " << _totalSums[i] * scale << "\n";
+			out << name << "_count{" << labels << "} " << _totalCounts[i] << "\n";
+		}
+
+		out << "# TYPE " << name << "_max gauge\n";
+		for (size_t i = begin; i < end; i++)
+		{
+			out << name << "_max{" << label << "=\"" << getName((ProfileMetric)i) << "\"} " <<
+				_snapshots[i].max * scale << "\n";
+		}
+	};
+
+	out << "# HELP server_phase_seconds Time spent in each part of the server\n";
+	writeMetric("server_phase_seconds", "phase", 1e-9, 0, PROFILE_ENTITIES_TICKED);
+	out << "# HELP server_room_entities Entities per room tick\n";
+	writeMetric("server_room_entities", "kind", 1, PROFILE_ENTITIES_TICKED, PROFILE_METRIC_COUNT);
+
+	auto tempPath = path + ".tmp";
+	std::ofstream file(tempPath, std::ios::trunc);
+	file << out.str();
+	file.close();
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (!file || error)
+	{
+		Logger::getInstance()->warn("Could not write metrics to " + path);
+	}
+}
+
+void Profiler::logSummary()
+{
+	auto& ticks = _snapshots[PROFILE_SERVER_TICK];
+	if (!ticks.count)
+	{
+		return;
+	}
+
+	auto microseconds = [this](ProfileMetric metric, double percent)
+	{
+		return _snapshots[metric].percentile(percent) / 1000;
+	};
+	uint64_t budget = 1000000 / TICKS_PER_SEC;
+
+	std::ostringstream line;
+	line << "Tick over " << ticks.count << " ticks: p50 " << microseconds(PROFILE_SERVER_TICK, 50) <<
+		"us, p99 " << microseconds(PROFILE_SERVER_TICK, 99) <<
+		"us (" << microseconds(PROFILE_SERVER_TICK, 99) * 100 / budget << "% of budget), max " <<
+		ticks.max / 1000 << "us";
+
+	if (_snapshots[PROFILE_ROOM_TICK].count)
+	{
+		line << "; room p99";
+		for (int i = PROFILE_EVENT_INGEST; i < PROFILE_ENTITIES_TICKED; i++)
+		{
+			auto metric = (ProfileMetric)i;
+			if (metric != PROFILE_SERIALIZATION)
+			{
+				line << " " << getName(metric) << " " << microseconds(metric, 99) << "us";
+			}
+		}
+		line << "; " << _snapshots[PROFILE_ENTITIES_TICKED].percentile(50) << " entities ticked and " <<
+			_snapshots[PROFILE_ENTITIES_CHANGED].percentile(50) << " changed per room tick";
+	}
+
+	if (_snapshots[PROFILE_SERIALIZATION].count)
+	{
+		line << "; serialization p99 " << microseconds(PROFILE_SERIALIZATION, 99) << "us";
+	}
+
+	Logger::getInstance()->info(line.str());
+}
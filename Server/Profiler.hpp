@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <stdint.h>
+
+// How often metrics are exported and summarized in the log
+#define PROFILE_EXPORT_INTERVAL std::chrono::seconds(10)
+
+// Metrics file in the Prometheus text format, rewritten every export, for a
+// node exporter's textfile collector or anything else that reads it
+#define PROFILE_EXPORT_PATH "metrics.prom"
+
+// Histogram buckets per power of two, as a power of two. Each bucket is at
+// most 1/8th wider than the values in it.
+#define HISTOGRAM_SUB_BITS 3
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+// Enough buckets for any 64-bit value
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+// What the profiler measures. Durations are in nanoseconds.
+enum ProfileMetric
+{
+	PROFILE_SERVER_TICK,		// Every room, start to finish
+	PROFILE_ROOM_TICK,			// One room's GameServer::update()
+	PROFILE_EVENT_INGEST,		// Receiving, handling and sorting events
+	PROFILE_ENTITY_UPDATE,		// update() on every awake entity
+	PROFILE_BROAD_PHASE,		// Sweep upkeep, finding pairs and static lookups
+	PROFILE_NARROW_PHASE,		// Checking pairs and resolving contacts
+	PROFILE_GAME_STATE,			// Timers and win conditions
+	PROFILE_SNAPSHOT_BUILD,		// Collecting and queueing changed states
+	PROFILE_SERIALIZATION,		// Encoding a snapshot for one client
+	PROFILE_CLEANUP,			// Deleting destroyed entities
+
+	// Counts per room tick. Everything from here on is not a duration.
+	PROFILE_ENTITIES_TICKED,
+	PROFILE_ENTITIES_CHANGED,
+
+	PROFILE_METRIC_COUNT
+};
+
+/*
+** Counts of values in log-linear buckets, for percentiles of values spread
+** over many orders of magnitude. Any number of threads can record at once
+** without locks; a snapshot taken meanwhile may be off by those few values.
+*/
+class Histogram
+{
+public:
+	struct Snapshot
+	{
+		std::array<uint64_t, HISTOGRAM_BUCKETS> buckets;
+		uint64_t count;
+		uint64_t sum;
+		uint64_t max;
+
+		// Upper bound of the bucket holding a percentile, never above max
+		uint64_t percentile(double percent) const;
+	};
+
+	Histogram();
+	~Histogram() {};
+
+	void record(uint64_t value);
+
+	// Takes everything recorded since the last call
+	void takeSnapshot(Snapshot & snapshot);
+
+private:
+	static size_t getBucket(uint64_t value);
+
+	// Smallest value past a bucket
+	static uint64_t getBucketEnd(size_t bucket);
+
+	std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> _buckets;
+	std::atomic<uint64_t> _sum;
+	std::atomic<uint64_t> _max;
+};
+
+/*
+** Where the server's time goes. Code is timed with a ProfileScope and lands in
+** one histogram per ProfileMetric, which is exported to PROFILE_EXPORT_PATH
+** and summarized in the log every PROFILE_EXPORT_INTERVAL.
+**
+** Between beginTick() and endTick(), a thread adds up what it measures and
+** records the totals once at the end, so a phase spread over several places,
+** like the broad phase of each solver iteration, is one sample per tick.
+** Anything measured outside a tick, like serialization on network threads, is
+** recorded right away.
+*/
+class Profiler
+{
+public:
+	static Profiler * getInstance()
+	{
+		// Never destroyed, so it outlives every thread that records
+		static Profiler * instance = new Profiler();
+		return instance;
+	}
+
+	// Totals of a tick, by metric
+	struct Tick
+	{
+		std::array<uint64_t, PROFILE_METRIC_COUNT> values;
+		uint32_t touched;	// Bit per metric added to
+	};
+
+	// Adds to this thread's tick, or records the value if not in one
+	void add(ProfileMetric metric, uint64_t value);
+
+	// Times a room tick on this thread. Ticks cannot be nested.
+	void beginTick();
+	void endTick();
+
+	// Totals of the last tick that ended on this thread
+	const Tick & getLastTick();
+
+	// Exports metrics to path every PROFILE_EXPORT_INTERVAL, on a separate
+	// thread. Nothing is exported unless this is called.
+	void startExporter(std::string path = PROFILE_EXPORT_PATH);
+
+	static const char * getName(ProfileMetric metric);
+	static bool isDuration(ProfileMetric metric) { return metric < PROFILE_ENTITIES_TICKED; };
+
+private:
+	Profiler() {};
+
+	// Exports every PROFILE_EXPORT_INTERVAL; runs in separate thread
+	void exportLoop(std::string path);
+
+	// Writes metrics to a temporary file first, so readers never see half
+	void writeMetrics(const std::string & path);
+
+	// Logs tick percentiles and how much of the tick budget they take up
+	void logSummary();
+
+	std::array<Histogram, PROFILE_METRIC_COUNT> _histograms;
+
+	// Used only by the export thread
+	std::array<Histogram::Snapshot, PROFILE_METRIC_COUNT> _snapshots;
+	std::array<uint64_t, PROFILE_METRIC_COUNT> _totalCounts = {};
+	std::array<uint64_t, PROFILE_METRIC_COUNT> _totalSums = {};
+};
+
+/*
+** Times the enclosing block and adds it to a metric, as in
+** ProfileScope scope(PROFILE_BROAD_PHASE);
+*/
+class ProfileScope
+{
+public:
+	ProfileScope(ProfileMetric metric)
+		: _metric(metric), _start(std::chrono::steady_clock::now()) {};
+
+	~ProfileScope()
+	{
+		auto elapsed = std::chrono::steady_clock::now() - _start;
+		Profiler::getInstance()->add(_metric,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	};
+
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope & operator=(const ProfileScope &) = delete;
+
+private:
+	ProfileMetric _metric;
+	std::chrono::steady_clock::time_point _start;
+};
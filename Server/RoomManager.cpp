@@ -0,0 +1,134 @@
+#include "RoomManager.hpp"
+
+RoomManager::RoomManager(std::string levelPath)
+{
+	_levelPath = levelPath;
+
+	_isRunning = false;
+	_isFinished = true;
+}
+
+
+RoomManager::~RoomManager()
+{
+}
+
+
+void RoomManager::start()
+{
+	_threadPool = std::make_unique<ThreadPool>(ROOM_THREADS);
+	Logger::getInstance()->info("Ticking rooms on " +
+		std::to_string(_threadPool->getThreadCount()) + " threads");
+
+	// Start network server. Rooms are created as players connect, so hold
+	// the room lock until the server can be reached from assignRoom().
+	std::unique_lock<std::mutex> lock(_roomMutex);
+	_networkServer = std::make_unique<NetworkServer>(
+		PORTNUM,
+		[this](uint32_t & roomId) { return assignRoom(roomId); });
+	lock.unlock();
+
+	// Tick and phase timings, exported while the server runs
+	Profiler::getInstance()->startExporter();
+
+	_isRunning = true;
+	_isFinished = false;
+
+	// Run the update loop at a fixed rate, catching up on late ticks
+	_scheduler.run([this]()
+		{
+			ProfileScope scope(PROFILE_SERVER_TICK);
+			this->update();
+		}, _isRunning);
+
+	_isFinished = true;
+}
+
+
+void RoomManager::update()
+{
+	// Rooms that nobody is in, or ever was since their last reset, have
+	// nothing to do. Players count as soon as they connect, and the room
+	// keeps ticking until their events are handled.
+	std::unique_lock<std::mutex> lock(_roomMutex);
+	_activeRooms.clear();
+	for (auto& room : _rooms)
+	{
+		if (room->server->hasPlayers() ||
+			_networkServer->getPlayerCount(room->id) ||
+			_networkServer->hasEvents(room->id))
+		{
+			_activeRooms.push_back(room.get());
+		}
+	}
+	lock.unlock();
+
+	// Rooms share nothing but the network server, which is thread safe
+	_threadPool->run(_activeRooms.size(), [this](size_t i)
+		{
+			_activeRooms[i]->server->update();
+		});
+}
+
+
+bool RoomManager::assignRoom(uint32_t & roomId)
+{
+	std::unique_lock<std::mutex> lock(_roomMutex);
+
+	// Fill up the oldest rooms first. A room that has started its game takes
+	// nobody until it is back in the lobby.
+	for (auto& room : _rooms)
+	{
+		if (room->server->isInLobby() &&
+			_networkServer->getPlayerCount(room->id) < ROOM_MAX_PLAYERS)
+		{
+			roomId = room->id;
+			return true;
+		}
+	}
+
+	if (_rooms.size() >= MAX_ROOMS)
+	{
+		return false;
+	}
+
+	// This is the only thread that adds rooms, so the next index stays free
+	// while the lock is released
+	auto room = std::make_unique<Room>();
+	room->id = (uint32_t)_rooms.size();
+	lock.unlock();
+
+	// Loading the level takes a moment, so it is done without holding up
+	// the tick of every other room
+	room->server = std::make_unique<GameServer>(
+		std::make_unique<RoomNetwork>(_networkServer.get(), room->id),
+		_levelPath);
+	room->server->initialize();
+
+	Logger::getInstance()->info("Created room " + std::to_string(room->id));
+
+	roomId = room->id;
+	lock.lock();
+	_rooms.push_back(std::move(room));
+	return true;
+}
+
+
+void RoomManager::shutdown()
+{
+	Logger::getInstance()->info("Shutting down server");
+
+	// Signal main thread to stop and wait for it to finish
+	_isRunning = false;
+
+	while (!_isFinished)
+	{
+		std::this_thread::sleep_for(tick(1));
+	}
+
+	std::unique_lock<std::mutex> lock(_roomMutex);
+	for (auto& room : _rooms)
+	{
+		room->server->shutdown();
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#include "GameServer.hpp"
+#include "NetworkServer.hpp"
+#include "RoomNetwork.hpp"
+#include "ThreadPool.hpp"
+#include "TickScheduler.hpp"
+
+// Players a room takes before new ones go to another room
+#define ROOM_MAX_PLAYERS 8
+
+// Rooms are created as players arrive, up to this many
+#define MAX_ROOMS 64
+
+// Threads that tick rooms. 0 means one per core.
+#define ROOM_THREADS 0
+
+/*
+** Hosts many independent matches in one process. Owns the NetworkServer and
+** one GameServer per room, each with its own entity map, EventManager and
+** CollisionManager, and ticks every room in parallel on a ThreadPool.
+**
+** New players go to the first room that is still in the lobby and has space,
+** and a room is created when there is none. Rooms are kept for reuse once
+** their players leave, and are skipped by the tick loop until someone joins.
+*/
+class RoomManager
+{
+public:
+	// levelPath is loaded by every room
+	RoomManager(std::string levelPath = DEFAULT_LEVEL_PATH);
+	~RoomManager();
+
+	// Start the network server and run the main loop
+	void start();
+
+	// Stop the main loop, disconnect everyone and free every room
+	void shutdown();
+
+private:
+	struct Room
+	{
+		uint32_t id;
+		std::unique_ptr<GameServer> server;
+	};
+
+	// Picks or creates a room for a new player. Called by the NetworkServer's
+	// listener thread.
+	bool assignRoom(uint32_t & roomId);
+
+	// Ticks every room that has players, in parallel
+	void update();
+
+	std::atomic<bool> _isRunning;
+	std::atomic<bool> _isFinished;
+
+	std::string _levelPath;
+
+	std::unique_ptr<NetworkServer> _networkServer;
+	std::unique_ptr<ThreadPool> _threadPool;
+	TickScheduler _scheduler;
+
+	// Rooms are only ever added while running, so their IDs are indices
+	std::vector<std::unique_ptr<Room>> _rooms;
+	std::mutex _roomMutex;
+
+	// Rooms to tick this tick, rebuilt every tick
+	std::vector<Room*> _activeRooms;
+};
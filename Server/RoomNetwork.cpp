@@ -0,0 +1,47 @@
+#include "RoomNetwork.hpp"
+
+RoomNetwork::RoomNetwork(NetworkServer * networkServer, uint32_t roomId)
+{
+	_networkServer = networkServer;
+	_roomId = roomId;
+}
+
+std::vector<uint32_t> RoomNetwork::getPlayerList()
+{
+	return _networkServer->getPlayerList(_roomId);
+}
+
+void RoomNetwork::closePlayerSession(uint32_t playerId)
+{
+	_networkServer->closePlayerSession(playerId);
+}
+
+void RoomNetwork::clearQueues()
+{
+	_networkServer->clearQueues(_roomId);
+}
+
+void RoomNetwork::receiveEvents(std::vector<std::shared_ptr<GameEvent>> & events)
+{
+	_networkServer->receiveEvents(_roomId, events);
+}
+
+void RoomNetwork::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates)
+{
+	_networkServer->sendUpdates(std::move(updates), _roomId);
+}
+
+void RoomNetwork::sendUpdate(std::shared_ptr<BaseState> update)
+{
+	_networkServer->sendUpdate(update, _roomId);
+}
+
+void RoomNetwork::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId)
+{
+	_networkServer->sendUpdates(std::move(updates), _roomId, playerId);
+}
+
+void RoomNetwork::sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId)
+{
+	_networkServer->sendUpdate(update, _roomId, playerId);
+}
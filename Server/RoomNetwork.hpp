@@ -0,0 +1,33 @@
+#pragma once
+
+#include "NetworkInterface.hpp"
+#include "NetworkServer.hpp"
+
+/*
+** A room's view of the NetworkServer. Only sees the events and players of
+** its own room, and everything it sends goes to that room alone. The
+** NetworkServer is shared by every room and must outlive them.
+*/
+class RoomNetwork : public NetworkInterface
+{
+public:
+	RoomNetwork(NetworkServer * networkServer, uint32_t roomId);
+	~RoomNetwork() {};
+
+	std::vector<uint32_t> getPlayerList() override;
+	void closePlayerSession(uint32_t playerId) override;
+	void clearQueues() override;
+
+	void receiveEvents(std::vector<std::shared_ptr<GameEvent>> & events) override;
+
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates) override;
+	void sendUpdate(std::shared_ptr<BaseState> update) override;
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId) override;
+	void sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId) override;
+
+	uint32_t getRoomId() { return _roomId; };
+
+private:
+	NetworkServer * _networkServer;
+	uint32_t _roomId;
+};
@@ -1,11 +1,18 @@
 #include <algorithm>
 #include "SBaseEntity.hpp"
+#include "EntityStore.hpp"
 
 SBaseEntity::~SBaseEntity()
 {
 	_state = nullptr;
 	_collider = nullptr;
 	_collisionHandlers.clear();
+
+	// Timers may refer to this entity, so none can fire after it is gone
+	for (auto& handle : _timers)
+	{
+		_timerWheel->cancel(handle);
+	}
 }
 
 std::shared_ptr<BaseState> SBaseEntity::getState()
@@ -18,7 +25,7 @@ std::vector<std::shared_ptr<SBaseEntity>> SBaseEntity::getChildren()
 	return std::vector<std::shared_ptr<SBaseEntity>>();
 }
 
-bool SBaseEntity::isColliding(QuadTree & tree)
+bool SBaseEntity::isColliding(BroadPhase & tree)
 {
 	return _collider->isColliding(tree);
 }
@@ -28,15 +35,17 @@ bool SBaseEntity::isColliding(BaseState * state)
 	return _collider->isColliding(state);
 }
 
-std::vector<BaseState*> SBaseEntity::getColliding(QuadTree & tree)
+void SBaseEntity::getColliding(BroadPhase & tree, std::vector<BaseState*> & results)
 {
-	return _collider->getColliding(tree);
+	_collider->getColliding(tree, results);
 }
 
 void SBaseEntity::handleCollision(SBaseEntity * entity)
 {
+	wake();
+
 	// Execute lambdas (if any) first
-	for (auto f : _collisionHandlers)
+	for (auto& f : _collisionHandlers)
 	{
 		f(this, entity);
 	}
@@ -71,39 +80,85 @@ void SBaseEntity::initState(bool generateId)
 	_state->isSolid = true;
 	_state->isVisible = true;
 
-	hasChanged = false;
+	_hasChanged = false;
 }
 
-Timer * SBaseEntity::registerTimer(long durationMilliseconds, std::function<void()> f)
+void SBaseEntity::markChanged()
 {
-	auto timer = new Timer(durationMilliseconds, f);
-	_timers.push_back(timer);
-	return timer;
+	if (_hasChanged)
+	{
+		return;
+	}
+
+	// Entities not in the store yet are added to the list when inserted
+	_hasChanged = true;
+	if (_store)
+	{
+		_store->_changed.push_back(this);
+	}
+}
+
+void SBaseEntity::destroy()
+{
+	if (_state->isDestroyed)
+	{
+		return;
+	}
+
+	_state->isDestroyed = true;
+	if (_store)
+	{
+		_store->_destroyed.push_back(_state->id);
+	}
 }
 
-void SBaseEntity::updateTimers()
+void SBaseEntity::wake()
 {
-	bool dirty = false;
+	if (!_hasUpdate)
+	{
+		return;
+	}
 
-	// Update all timers and delete them if they're finished
-	for (int i = 0; i < _timers.size(); i++)
+	// Entities not in the store yet are added to the list when inserted
+	_isAwake = true;
+	if (_store && !_isActive)
 	{
-		if (_timers[i])
+		_isActive = true;
+		_store->_active.push_back(this);
+	}
+}
+
+TimerHandle SBaseEntity::registerTimer(long durationMilliseconds, std::function<void()> f)
+{
+	if (!_timerWheel)
+	{
+		_timerWheel = TimerWheel::getCurrent();
+	}
+
+	// Forget timers that have fired, so the list stays as long as the number
+	// pending
+	_timers.erase(std::remove_if(_timers.begin(), _timers.end(),
+		[&](TimerHandle handle)
+		{
+			return !_timerWheel->isPending(handle);
+		}), _timers.end());
+
+	// Pending timers are cancelled with the entity, so this outlives them
+	auto handle = _timerWheel->scheduleMilliseconds(durationMilliseconds,
+		[this, f = std::move(f)]()
 		{
-			_timers[i]->update();
-			if (_timers[i]->isComplete())
-			{
-				delete _timers[i];
-				_timers[i] = nullptr;
-				dirty = true;
-			}
-		}
-	}
-
-	// Remove all completed timers from vector
-	if (dirty)
+			wake();
+			f();
+		});
+	_timers.push_back(handle);
+	return handle;
+}
+
+void SBaseEntity::cancelTimer(TimerHandle handle)
+{
+	if (_timerWheel)
 	{
-		_timers.erase(std::remove(_timers.begin(), _timers.end(), nullptr), _timers.end());
+		_timerWheel->cancel(handle);
 	}
 }
 
@@ -5,10 +5,13 @@
 
 #include "Shared/BaseState.hpp"
 #include "Shared/GameEvent.hpp"
-#include "Shared/QuadTree.hpp"
-#include "Shared/Timer.hpp"
+#include "Shared/BroadPhase.hpp"
 #include "IdGenerator.hpp"
 #include "BaseCollider.hpp"
+#include "TimerWheel.hpp"
+#include "EventSpan.hpp"
+
+class EntityStore;
 
 /*
 ** As with CBaseEntity, this is an abstract class, and cannot be instantiated.
@@ -22,13 +25,12 @@
 class SBaseEntity
 {
 public:
-	bool hasChanged;	// If object state has changed during the last iteration
-
 	virtual ~SBaseEntity();	// Destroys local state and collider objects
 
-	// Update function, called every tick. Override if additional functionality
-	// is desired
-	virtual void update(std::vector<std::shared_ptr<GameEvent>> events) {};
+	// Update function, called every tick while awake with this player's
+	// events, sorted by type. Only called on entities with _hasUpdate set,
+	// so set it when overriding.
+	virtual void update(EventSpan events) {};
 
     // All server objects must have a state to send to the client.
 	virtual std::shared_ptr<BaseState> getState();
@@ -37,11 +39,11 @@ public:
 	virtual	std::vector<std::shared_ptr<SBaseEntity>> getChildren();
 
 	// Wrappers for colliders
-	virtual bool isColliding(QuadTree & tree);
+	virtual bool isColliding(BroadPhase & tree);
 
 	virtual bool isColliding(BaseState* state);
 
-	virtual std::vector<BaseState*> getColliding(QuadTree & tree);
+	virtual void getColliding(BroadPhase & tree, std::vector<BaseState*> & results);
 
 	// Registers custom collision handler for this object. Called inside
 	// handleCollision()
@@ -62,12 +64,32 @@ public:
 	// any children
 	virtual void initState(bool generateId = true);
 
-	// Registers a timer with the entity
-	Timer * registerTimer(long durationMilliseconds, std::function<void()> f);
+	// Sends this entity's state to clients at the end of the tick. Call
+	// whenever the state changes.
+	void markChanged();
+
+	// If the state has changed this tick
+	bool hasChanged() { return _hasChanged; };
+
+	// Deletes this entity at the end of the tick. Clients are only told if
+	// it is also marked as changed.
+	void destroy();
+
+	// Entities with an update() start out awake. One that has nothing to do
+	// can sleep, and is not updated again until woken. Collisions, timers and
+	// events for the entity all wake it, and anything else that changes what
+	// update() would do should too. Both are safe to call from update().
+	void wake();
+	void sleep() { _isAwake = false; };
+	bool isAwake() { return _hasUpdate && _isAwake; };
 
-	// Updates existing timers. This must be manually called every tick in
-	// order for timers to work!
-	void updateTimers();
+	// Calls f at the start of the first tick at least durationMilliseconds
+	// of game time from now, unless cancelled or this entity is destroyed
+	// first. Timers run on the wheel of the room ticking on this thread.
+	TimerHandle registerTimer(long durationMilliseconds, std::function<void()> f);
+
+	// Stops a timer registered with this entity from firing
+	void cancelTimer(TimerHandle handle);
 
 	// Rotates the object and all its children around a point.
 	// Angle is the number of times to be rotated clockwise in
@@ -90,10 +112,26 @@ protected:
 	// to generate shared pointers from themselves.
 	std::vector<std::function<void(SBaseEntity*, SBaseEntity*)>> _collisionHandlers;
 
+	// Whether update() does anything. Read when the entity is added to the
+	// store, so set it in the constructor.
+	bool _hasUpdate = false;
+
 private:
+	friend class EntityStore;
+
+	// Store holding this entity, which keeps the changed and destroyed lists
+	EntityStore * _store = nullptr;
+	bool _hasChanged = false;
+
+	// Whether this entity is on the store's active list. It stays on it for
+	// the rest of the tick after falling asleep.
+	bool _isAwake = true;
+	bool _isActive = false;
+
 	// Helper function to rotate forward vector 90 degrees clockwise
 	glm::vec3 rotateOnce(glm::vec3 vec);
 
-	// Timers to fire events
-	std::vector<Timer*> _timers;
+	// Timers to cancel when destroyed, and the wheel they are on
+	TimerWheel * _timerWheel = nullptr;
+	std::vector<TimerHandle> _timers;
 };
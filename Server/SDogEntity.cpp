@@ -30,7 +30,7 @@ SDogEntity::SDogEntity(
 	dogState->runStamina = MAX_DOG_STAMINA;
 	dogState->urineMeter = MAX_DOG_URINE;
 	dogState->isCaught = false;
-	_barkTime = std::chrono::steady_clock::now();
+	_barkTime = GameClock::now();
 	dogState->isTeleporting = false;
 
 	// Player-specific stuff
@@ -38,7 +38,7 @@ SDogEntity::SDogEntity(
 	dogState->skinID = skinID;
 }
 
-void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
+void SDogEntity::update(EventSpan events)
 {
 	auto dogState = std::static_pointer_cast<DogState>(_state);
 
@@ -61,67 +61,64 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	{
 		// Four seconds to charge 1 second of sprinting
 		dogState->runStamina += 1.0f / 4 / TICKS_PER_SEC;
-		hasChanged = true;
+		markChanged();
 	}
 	else
 	{
 		dogState->runStamina = MAX_DOG_STAMINA;
 	}
 
-	// Non-movement events, duplicates removed
-	auto filteredEvents = SPlayerEntity::getFilteredEvents(events);
-
-	// If any events left, process them
-	if (filteredEvents.size())
+	// Non-movement events, duplicates skipped
+	for (size_t i = 0; i < events.size(); i++)
 	{
-		for (auto& event : filteredEvents)
+		if (SPlayerEntity::isFilteredEvent(events, i))
 		{
-			switch (event->type)
+			continue;
+		}
+
+		auto& event = events[i];
+		switch (event->type)
+		{
+		case EVENT_PLAYER_RUN_START:
+			_isRunning = true;
+			break;
+		case EVENT_PLAYER_RUN_END:
+			_isRunning = false;
+			break;
+		case EVENT_PLAYER_URINATE_START:
+			_isUrinating = true;
+			break;
+		case EVENT_PLAYER_URINATE_END:
+			_isUrinating = false;
+
+			// Abort timer if it exists
+			cancelTimer(_peeTimer);
+			_peeTimer = TimerHandle();
+			break;
+		case EVENT_PLAYER_INTERACT_START:
+			_isInteracting = true;
+
+			// If currently trapped, increment button count
+			if (_isTrapped)
 			{
-			case EVENT_PLAYER_RUN_START:
-				_isRunning = true;
-				break;
-			case EVENT_PLAYER_RUN_END:
-				_isRunning = false;
-				break;
-			case EVENT_PLAYER_URINATE_START:
-				_isUrinating = true;
-				break;
-			case EVENT_PLAYER_URINATE_END:
-				_isUrinating = false;
-
-				// Abort timer if it exists
-				if (_peeTimer)
-				{
-					_peeTimer->abort();
-					_peeTimer = nullptr;
-				}
-				break;
-			case EVENT_PLAYER_INTERACT_START:
-				_isInteracting = true;
+				_numEscapePressed++;
 
-				// If currently trapped, increment button count
-				if (_isTrapped)
+				// Mark player as no longer trapped if we reach the max
+				if (_numEscapePressed >= MAX_DOG_ESCAPE_PRESSES)
 				{
-					_numEscapePressed++;
-
-					// Mark player as no longer trapped if we reach the max
-					if (_numEscapePressed >= MAX_DOG_ESCAPE_PRESSES)
-					{
-						_numEscapePressed = 0;
-						_isTrapped = false;
-						_isInterpolating = false;
-						_curTrap->getState()->isDestroyed = true;
-						_curTrap->hasChanged = true;
-						_curTrap = nullptr;
-					}
+					_numEscapePressed = 0;
+					_isTrapped = false;
+					_isInterpolating = false;
+					_curTrap->destroy();
+					_curTrap->markChanged();
+					_curTrap = nullptr;
 				}
-				break;
-			case EVENT_PLAYER_INTERACT_END:
-				_isInteracting = false;
-			default:
-				break;
 			}
+			break;
+		case EVENT_PLAYER_INTERACT_END:
+			_isInteracting = false;
+		default:
+			break;
 		}
 	}
 
@@ -142,13 +139,13 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	case ACTION_DOG_IDLE:
 		if (actionChanged) {
 			dogState->currentAnimation = ANIMATION_DOG_IDLE;
-			hasChanged = true;
+			markChanged();
 		}
 		break;
 	case ACTION_DOG_MOVING:
 		if (actionChanged) {
 			dogState->currentAnimation = ANIMATION_DOG_RUNNING;
-			hasChanged = true;
+			markChanged();
 		}
 		if (_isRunning) {
 			if (dogState->runStamina >= 1.5f / TICKS_PER_SEC)
@@ -169,17 +166,17 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	case ACTION_DOG_PEEING:
 		if (actionChanged) {
 			dogState->currentAnimation = ANIMATION_DOG_PEEING;
-			hasChanged = true;
+			markChanged();
 
 			// Register a timer and place the pee object after half a second
-			_peeTimer = registerTimer(500 /* Milliseconds */, [&]()
+			_peeTimer = registerTimer(500 /* Milliseconds */, [&, dogState]()
 				{
 					if (_curAction == ACTION_DOG_PEEING)
 					{
 						createPuddle();
 						dogState->urineMeter = 0.0f;
 						_isUrinating = false;
-						_peeTimer = nullptr;
+						_peeTimer = TimerHandle();
 					}
 				});
 		}
@@ -191,11 +188,11 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			glm::vec3 dest = targetPos + glm::normalize(_state->pos - targetPos) * 0.55f;
 			dogState->currentAnimation = ANIMATION_DOG_RUNNING;
 			interpolateMovement(dest, glm::normalize(targetPos - _state->pos), DOG_BASE_VELOCITY / 2,
-				[&] {
+				[&, dogState] {
 					// Stage 1: start scratching animation and lifting the gate
 					actionStage++;
 					dogState->currentAnimation = ANIMATION_DOG_SCRATCHING;
-					hasChanged = true;
+					markChanged();
 				});
 		}
 		break;
@@ -203,12 +200,12 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 		// Stage 0: interpolating to the fountain and look at it
 		if (actionStage == 0) {
 			dogState->currentAnimation = ANIMATION_DOG_RUNNING;
-			interpolateMovement(targetPos, targetDir, DOG_BASE_VELOCITY / 2, [&]()
+			interpolateMovement(targetPos, targetDir, DOG_BASE_VELOCITY / 2, [&, dogState]()
 				{
 					// Stage 1: start drinking animation and filling meter
 					actionStage++;
 					dogState->currentAnimation = ANIMATION_DOG_DRINKING;
-					hasChanged = true;
+					markChanged();
 				});
 		}
 		else if (actionStage == 1) {
@@ -229,24 +226,24 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 		//	std::to_string(_numEscapePressed) + "/" +
 		//	std::to_string(MAX_DOG_ESCAPE_PRESSES) + "]";
 		dogState->tooltip = TOOLTIP_TRAPPED;
-		hasChanged = true;
+		markChanged();
 
 		if (actionChanged) {
 			dogState->currentAnimation = ANIMATION_DOG_WALKING;
 
 			// Interpolate to trap
 			interpolateMovement(_curTrap->getState()->pos, _state->forward, DOG_BASE_VELOCITY / 10,
-				[&]() {
+				[&, dogState]() {
 					// Switch to idle
 					dogState->currentAnimation = ANIMATION_DOG_EATING;
-					hasChanged = true;
+					markChanged();
 				});
 		}
 		break;
 	case ACTION_DOG_JAILED:
 		_isTeleporting = false;
 		dogState->isCaught = true;
-		hasChanged = true;
+		markChanged();
 		if (actionChanged)
 		{
 			// Make dog invisible and non-solid
@@ -284,7 +281,7 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 				_sourceDoghousePos,
 				_sourceDoghouseDir,
 				DOG_BASE_VELOCITY / 5,
-				[&]()
+				[&, dogState]()
 				{
 					actionStage++;
 					dogState->isTeleporting = false;	// No longer need to play sound
@@ -292,7 +289,7 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 				0,
 				false);
 
-			hasChanged = true;
+			markChanged();
 		}
 
 		// stage 1: start digging animation
@@ -304,14 +301,14 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			dogState->currentAnimation = ANIMATION_DOG_DIGGING_IN;
 			dogState->isPlayOnce = true;
 			dogState->animationDuration = 300;
-			hasChanged = true;
+			markChanged();
 
 			// Timer until dog digging end
 			registerTimer(300, [&]()
 			{
 				if (_curAction == ACTION_DOG_TELEPORTING)
 				{
-					hasChanged = true;
+					markChanged();
 					_state->isSolid = false;
 					_state->transparency = 0.0f;
 					actionStage++;
@@ -349,7 +346,7 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			_state->isSolid = true;
 			_state->transparency = 1.0f;
 			_state->forward = -(_targetDoghouseDir);
-			hasChanged = true;
+			markChanged();
 
 			// Timer until digging end
 			registerTimer(300, [&]()
@@ -374,8 +371,8 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 					_isTeleporting = false;
 
 					// Reset cooldowns
-					_sourceCooldowns->insert({ _state->id, std::chrono::steady_clock::now() });
-					_targetCooldowns->insert({ _state->id, std::chrono::steady_clock::now() });
+					_sourceCooldowns->insert({ _state->id, GameClock::now() });
+					_targetCooldowns->insert({ _state->id, GameClock::now() });
 				},
 				0,
 				false);
@@ -386,14 +383,14 @@ void SDogEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	handleInterpolation();
 
 	// Dogs can bark if idle or running
-	auto elapsed = std::chrono::steady_clock::now() - _barkTime;
+	auto elapsed = GameClock::now() - _barkTime;
 	if ((_curAction == ACTION_DOG_IDLE || _curAction == ACTION_DOG_MOVING) &&
 		_isInteracting &&
 		std::chrono::duration_cast<std::chrono::seconds>(elapsed) >= std::chrono::seconds(1))
 	{
-		_barkTime = std::chrono::steady_clock::now();
+		_barkTime = GameClock::now();
 		dogState->isBarking = true;
-		hasChanged = true;
+		markChanged();
 	}
 
 	// Reset state handled by collision logic
@@ -440,11 +437,11 @@ void SDogEntity::generalHandleCollision(SBaseEntity * entity)
 		{
 			dogState->runStamina = MAX_DOG_STAMINA;
 		}
-		hasChanged = true;
+		markChanged();
 
 		// Remove dog bone
-		entity->getState()->isDestroyed = true;
-		entity->hasChanged = true;
+		entity->destroy();
+		entity->markChanged();
 	}
 	else if (entity->getState()->type == ENTITY_TRAP)
 	{
@@ -17,7 +17,7 @@ public:
 
 	~SDogEntity() {};
 
-	void update(std::vector<std::shared_ptr<GameEvent>> events) override;
+	void update(EventSpan events) override;
 
 	void generalHandleCollision(SBaseEntity* entity) override;
 
@@ -50,7 +50,7 @@ public:
 	}
 
 	void setSourceDoghouseCooldowns(
-		std::unordered_map<uint32_t, std::chrono::time_point<std::chrono::steady_clock>>* cooldowns) {
+		std::unordered_map<uint32_t, GameClock::time_point>* cooldowns) {
 		_sourceCooldowns = cooldowns;
 	}
 
@@ -63,7 +63,7 @@ public:
 	}
 
 	void setTargetDoghouseCooldowns(
-		std::unordered_map<uint32_t, std::chrono::time_point<std::chrono::steady_clock>>* cooldowns) {
+		std::unordered_map<uint32_t, GameClock::time_point>* cooldowns) {
 		_targetCooldowns = cooldowns;
 	}
 
@@ -85,14 +85,14 @@ private:
 	// Doghouse teleportation stuff
 	glm::vec3 _sourceDoghousePos;
 	glm::vec3 _sourceDoghouseDir;
-	std::unordered_map<uint32_t, std::chrono::time_point<std::chrono::steady_clock>>* _sourceCooldowns;
+	std::unordered_map<uint32_t, GameClock::time_point>* _sourceCooldowns;
 
 	glm::vec3 _targetDoghousePos;
 	glm::vec3 _targetDoghouseDir;
-	std::unordered_map<uint32_t, std::chrono::time_point<std::chrono::steady_clock>>* _targetCooldowns;
+	std::unordered_map<uint32_t, GameClock::time_point>* _targetCooldowns;
 
 	// Time since last dog bark
-	std::chrono::time_point<std::chrono::steady_clock> _barkTime;
+	GameClock::time_point _barkTime;
 
 	// Number of times the dog has pressed a button to escape trap
 	int _numEscapePressed = 0;
@@ -109,7 +109,7 @@ private:
 	bool _nearFountain = false;
 
 	// Dog pee timer
-	Timer* _peeTimer;
+	TimerHandle _peeTimer;
 
 	void createPuddle();
 
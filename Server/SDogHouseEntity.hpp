@@ -45,7 +45,6 @@ public:
 			glm::vec3(pos.x, 0, pos.z - backOffset),
 			glm::vec3(_state->width, _state->height, DOGHOUSE_WALL_WIDTH));
 		backWall->getState()->transparency = 0.0f;
-		_walls.push_back(backWall);
 
 		// Walls on either side of the doghouse (naming not strictly accurate)
 		auto leftWall = std::make_shared<SBoxEntity>(
@@ -53,14 +52,12 @@ public:
 			glm::vec3(_state->width - DOGHOUSE_WALL_WIDTH, _state->height, DOGHOUSE_WALL_WIDTH));
 		leftWall->getState()->transparency = 0.0f;
 		leftWall->rotate(leftWall->getState()->pos, 1);
-		_walls.push_back(leftWall);
 
 		auto rightWall = std::make_shared<SBoxEntity>(
 			glm::vec3(pos.x + sideOffset, 0, pos.z + DOGHOUSE_WALL_WIDTH/2),
 			glm::vec3(_state->width - DOGHOUSE_WALL_WIDTH, _state->height, DOGHOUSE_WALL_WIDTH));
 		rightWall->getState()->transparency = 0.0f;
 		rightWall->rotate(rightWall->getState()->pos, 1);
-		_walls.push_back(rightWall);
 
 		// Front wall, has variable solidity
 		auto frontWall = std::make_shared<SBoxEntity>(
@@ -75,7 +72,7 @@ public:
 				auto result = _cooldowns.find(collidingEntity->id);
 				if (result != _cooldowns.end())
 				{
-					auto elapsed = std::chrono::steady_clock::now() - result->second;
+					auto elapsed = GameClock::now() - result->second;
 					return (std::chrono::duration_cast<std::chrono::seconds>(elapsed).count() < DOGHOUSE_COOLDOWN_SECS);
 				}
 				else
@@ -85,7 +82,6 @@ public:
 			}
 			return true;
 		});
-		_walls.push_back(frontWall);
 
 		// Sensor for dogs. Performs actual logic on the doghouse
 		auto sensorBox = std::make_shared<SBoxEntity>(
@@ -119,7 +115,7 @@ public:
 						if (result != _cooldowns.end())
 						{
 							// Check cooldown, return if too soon
-							auto elapsed = std::chrono::steady_clock::now() - result->second;
+							auto elapsed = GameClock::now() - result->second;
 							if (std::chrono::duration_cast<std::chrono::seconds>(elapsed).count() < DOGHOUSE_COOLDOWN_SECS)
 							{
 								return;
@@ -164,15 +160,6 @@ public:
 		_children.clear();
 	};
 
-	// Reset solidity of doghouse walls
-	void update(std::vector<std::shared_ptr<GameEvent>> events) override
-	{
-		for (auto& wall : _walls)
-		{
-			wall->getState()->isSolid = true;
-		}
-	}
-
 	std::vector<std::shared_ptr<SBaseEntity>> getChildren() override
 	{
 		return _children;
@@ -190,11 +177,10 @@ public:
 	}
 
 	// Map of dog ID's to cooldowns
-	std::unordered_map<uint32_t, std::chrono::time_point<std::chrono::steady_clock>> _cooldowns;
+	std::unordered_map<uint32_t, GameClock::time_point> _cooldowns;
 
 private:
 	std::vector<std::shared_ptr<SBaseEntity>>* _dogHouses;
 	std::vector<std::shared_ptr<SBaseEntity>> _children;
-	std::vector<std::shared_ptr<SBaseEntity>> _walls;
 };
 
@@ -41,7 +41,7 @@ public:
 
 					DogState* dogState = static_cast<DogState*>(collidingEntity->getState().get());
 					dogState->tooltip = TOOLTIP_DRINK;
-					collidingEntity->hasChanged = true;
+					collidingEntity->markChanged();
 
 					// Get unit vector of dog to fountain
 					glm::vec3 fountainDir = glm::normalize(_state->pos - collidingDog->getState()->pos);
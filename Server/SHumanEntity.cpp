@@ -40,20 +40,20 @@ SHumanEntity::SHumanEntity(
 		// Start cooldown
 		auto playerState = std::static_pointer_cast<HumanState>(_state);
 		playerState->plungerCooldown = std::chrono::duration_cast<std::chrono::milliseconds>(PLUNGER_COOLDOWN).count();
-		_plungerCooldownStart = std::chrono::steady_clock::now();
-		hasChanged = true;
+		_plungerCooldownStart = GameClock::now();
+		markChanged();
 
 		_isLaunching = false;
 		if (plungerEntity != nullptr)
 		{
-			plungerEntity->getState()->isDestroyed = true;
-			plungerEntity->hasChanged = true;
+			plungerEntity->destroy();
+			plungerEntity->markChanged();
 			plungerEntity = nullptr;
 		}
 		if (ropeEntity != nullptr)
 		{
-			ropeEntity->getState()->isDestroyed = true;
-			ropeEntity->hasChanged = true;
+			ropeEntity->destroy();
+			ropeEntity->markChanged();
 			ropeEntity = nullptr;
 		}
 	};
@@ -61,22 +61,26 @@ SHumanEntity::SHumanEntity(
 	_swingingReset = [&] {
 		if (netEntity != nullptr)
 		{
-			netEntity->getState()->isDestroyed = true;
-			netEntity->hasChanged = true;
+			netEntity->destroy();
+			netEntity->markChanged();
 			netEntity = nullptr;
 		}
 	};
 }
 
-void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
+void SHumanEntity::update(EventSpan events)
 {
 	auto humanState = std::static_pointer_cast<HumanState>(_state);
 
-	// Non-movement events, duplicates removed
-	auto filteredEvents = SPlayerEntity::getFilteredEvents(events);
-
-	for (auto& event : filteredEvents)
+	// Non-movement events, duplicates skipped
+	for (size_t i = 0; i < events.size(); i++)
 	{
+		if (SPlayerEntity::isFilteredEvent(events, i))
+		{
+			continue;
+		}
+
+		auto& event = events[i];
 		switch (event->type)
 		{
 		case EVENT_PLAYER_CHARGE_NET:
@@ -127,7 +131,7 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	// Update net charge amount
 	if (_isCharging && !_isSwinging && humanState->chargeMeter < MAX_HUMAN_CHARGE) {
 		humanState->chargeMeter += 2.0f / TICKS_PER_SEC;
-		hasChanged = true;
+		markChanged();
 	}
 
 	bool actionChanged = updateAction();
@@ -142,13 +146,13 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 	case ACTION_HUMAN_IDLE:
 		if (actionChanged) {
 			humanState->currentAnimation = ANIMATION_HUMAN_IDLE;
-			hasChanged = true;
+			markChanged();
 		}
 		break;
 	case ACTION_HUMAN_MOVING:
 		if (actionChanged) {
 			humanState->currentAnimation = ANIMATION_HUMAN_RUNNING;
-			hasChanged = true;
+			markChanged();
 		}
 		handleActionMoving();
 		break;
@@ -159,13 +163,13 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			humanState->currentAnimation = ANIMATION_HUMAN_SHOOT;
 			humanState->isPlayOnce = true;
 			humanState->animationDuration = 450;
-			hasChanged = true;
+			markChanged();
 			// Timer until shooting animation end
 			registerTimer(450, [&]()
 			{
 				if (_curAction == ACTION_HUMAN_LAUNCHING)
 				{
-					hasChanged = true;
+					markChanged();
 					actionStage++;
 				}
 			});
@@ -197,7 +201,7 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 		// stage 2: human fly to plunger
 		if (actionStage == 2) {
 			humanState->currentAnimation = ANIMATION_HUMAN_FLYING;
-			hasChanged = true;
+			markChanged();
 			glm::vec3 plungerTailPos = plungerEntity->getState()->pos + glm::normalize(plungerEntity->getState()->forward) * -0.675f;
 			interpolateMovement(plungerTailPos, plungerEntity->getState()->forward, HUMAN_FLY_VELOCITY,
 				_launchingReset, _launchingReset, false);
@@ -218,21 +222,21 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			humanState->currentAnimation = ANIMATION_HUMAN_SLIPPING;
 			humanState->isPlayOnce = true;
 			humanState->animationDuration = 1500;
-			hasChanged = true;
+			markChanged();
 
 			// Timer until immobility stops
 			registerTimer(1500, [&]()
 				{
 					_isSlipping = false;
 					_isSlipImmune = true;
-					hasChanged = true;
+					markChanged();
 
 					// Disable slipping for another two seconds after
 					// initial slip
 					registerTimer(2000, [&]()
 						{
 							_isSlipImmune = false;
-							hasChanged = true;
+							markChanged();
 						});
 				});
 		}
@@ -285,19 +289,19 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			}
 				
 			humanState->chargeMeter = 0;
-			hasChanged = true;
+			markChanged();
 
 			// alarm for end of charging
-			registerTimer(chargeDuration * 1000, [&]()
+			registerTimer(chargeDuration * 1000, [&, humanState]()
 			{
 				actionStage++;
 
 				// alarm for end of stunt
-				registerTimer(stuntDuration, [&]()
+				registerTimer(stuntDuration, [&, humanState]()
 				{
 					_isSwinging = false;
 					humanState->chargeMeter = 0;
-					hasChanged = true;
+					markChanged();
 					_swingingReset();
 				});
 			});
@@ -306,7 +310,7 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 		// stage 0: human moving forward and net moving forward
 		if (actionStage == 0) {
 			_state->pos += _state->forward * (HUMAN_SWING_VELOCITY / TICKS_PER_SEC);
-			hasChanged = true;
+			markChanged();
 		}
 
 		if (netEntity != nullptr)
@@ -321,8 +325,8 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 			humanState->currentAnimation = ANIMATION_HUMAN_PLACING;
 			humanState->isPlayOnce = true;
 			humanState->animationDuration = 400;
-			hasChanged = true;
-			registerTimer(400, [&]()
+			markChanged();
+			registerTimer(400, [&, humanState]()
 				{
 					_isPlacingTrap = false;
 
@@ -332,9 +336,9 @@ void SHumanEntity::update(std::vector<std::shared_ptr<GameEvent>> events)
 
 					// Set cooldown
 					humanState->trapCooldown = std::chrono::duration_cast<std::chrono::milliseconds>(TRAP_COOLDOWN).count();
-					_trapCooldownStart = std::chrono::steady_clock::now();
+					_trapCooldownStart = GameClock::now();
 
-					hasChanged = true;
+					markChanged();
 				});
 		}
 		break;
@@ -418,30 +422,30 @@ void SHumanEntity::updateCooldowns()
 	// Trap bones
 	if (humanState->trapCooldown != 0)
 	{
-		auto elapsed = std::chrono::steady_clock::now() - _trapCooldownStart;
+		auto elapsed = GameClock::now() - _trapCooldownStart;
 		auto diff = TRAP_COOLDOWN - elapsed;
 		humanState->trapCooldown = std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
-		hasChanged = true;
+		markChanged();
 	}
 
 	if (humanState->trapCooldown < 0)
 	{
 		humanState->trapCooldown = 0;
-		hasChanged = true;
+		markChanged();
 	}
 
 	// Plunger
 	if (humanState->plungerCooldown != 0)
 	{
-		auto elapsed = std::chrono::steady_clock::now() - _plungerCooldownStart;
+		auto elapsed = GameClock::now() - _plungerCooldownStart;
 		auto diff = PLUNGER_COOLDOWN - elapsed;
 		humanState->plungerCooldown = std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
-		hasChanged = true;
+		markChanged();
 	}
 
 	if (humanState->plungerCooldown < 0)
 	{
 		humanState->plungerCooldown = 0;
-		hasChanged = true;
+		markChanged();
 	}
 }
@@ -16,7 +16,7 @@ public:
 
 	~SHumanEntity() {};
 
-	void update(std::vector<std::shared_ptr<GameEvent>> events) override;
+	void update(EventSpan events) override;
 
 	void generalHandleCollision(SBaseEntity* entity) override;
 
@@ -36,8 +36,8 @@ private:
 	void updateCooldowns();
 
 	// Cooldowns
-	std::chrono::time_point<std::chrono::steady_clock> _plungerCooldownStart;
-	std::chrono::time_point<std::chrono::steady_clock> _trapCooldownStart;
+	GameClock::time_point _plungerCooldownStart;
+	GameClock::time_point _trapCooldownStart;
 
 	// Slipping state
 	bool _isSlipping = false;
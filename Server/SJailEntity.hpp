@@ -27,6 +27,7 @@ public:
 		glm::vec3 scale)
 	{
 		_state = std::make_shared<BaseState>();
+		_hasUpdate = true;
 
 		// Base defaults
 		SBaseEntity::initState();
@@ -149,7 +150,7 @@ public:
 				DogState* dogState = static_cast<DogState*>(collidingEntity->getState().get());
 				dogState->tooltip = TOOLTIP_JAIL;
 				collidingDog->setNearTrigger(true);
-				collidingDog->hasChanged = true;
+				collidingDog->markChanged();
 
 				// sending position of trigger to dogEntity for interpolate
 				collidingDog->targetPos = entity->getState()->pos;
@@ -157,6 +158,7 @@ public:
 				// start lifting the gate in Stage 1
 				if (collidingDog->isInteracting() && collidingDog->actionStage == 1) {
 					_lifted = true;
+					wake();
 				}
 			}
 		};
@@ -235,14 +237,14 @@ public:
 		return _children;
 	}
 
-	virtual void update(std::vector<std::shared_ptr<GameEvent>> events) override
+	virtual void update(EventSpan events) override
 	{
 		if (_lifted) {
 			if (gateHeight < GATE_MAX_HEIGHT) {
 				gateHeight += GATE_LIFT_RATE / TICKS_PER_SEC;
 				for (int i = 0; i < _gates.size(); i++) {
 					_gates[i]->getState()->pos.y = gateHeight;
-					_gates[i]->hasChanged = true;
+					_gates[i]->markChanged();
 
 					auto gateState = std::static_pointer_cast<GateState>(_gates[i]->getState());
 					gateState->isLifting = true;
@@ -257,7 +259,7 @@ public:
 				gateHeight -= GATE_LOWER_RATE / TICKS_PER_SEC;
 				for (int i = 0; i < _gates.size(); i++) {
 					_gates[i]->getState()->pos.y = gateHeight;
-					_gates[i]->hasChanged = true;
+					_gates[i]->markChanged();
 					auto gateState = std::static_pointer_cast<GateState>(_gates[i]->getState());
 					gateState->isLifting = false;
 				}
@@ -265,6 +267,10 @@ public:
 					_triggers[i]->updateForward(-2);
 				}
 			}
+			else {
+				// Gates are shut; nothing to do until a trigger lifts them
+				sleep();
+			}
 		}
 
 		_lifted = false;
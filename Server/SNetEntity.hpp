@@ -23,7 +23,7 @@ public:
 		if (_curDistance > _maxDistance)
 			_curDistance = _maxDistance;
 		_state->pos = pos + forward * _curDistance;
-		hasChanged = true;
+		markChanged();
 	}
 
 	~SNetEntity() {};
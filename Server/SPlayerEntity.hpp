@@ -13,7 +13,10 @@ const float FP_EPSILON = 0.00001f;
 class SPlayerEntity : public SBaseEntity
 {
 public:
-	SPlayerEntity() {};
+	SPlayerEntity()
+	{
+		_hasUpdate = true;
+	};
 
 	~SPlayerEntity() {};
 
@@ -32,7 +35,7 @@ public:
 		playerState->tooltip = TOOLTIP_NONE;
 	}
 
-	virtual void update(std::vector<std::shared_ptr<GameEvent>> events) override
+	virtual void update(EventSpan events) override
 	{
 		auto playerState = std::static_pointer_cast<PlayerState>(_state);
 
@@ -45,41 +48,38 @@ public:
 		// Only change attributes of this object if not static
 		if (!_state->isStatic)
 		{
-			// Movement events
-			std::vector<std::shared_ptr<GameEvent>> movementEvents;
-			std::copy_if(events.begin(), events.end(), std::back_inserter(movementEvents), [&](std::shared_ptr<GameEvent> i)
+			// Movement events. Events are sorted by type, so they are all
+			// together.
+			auto isMove = [](const std::shared_ptr<GameEvent> & event)
 			{
-				return i->type == EVENT_PLAYER_MOVE;
-			});
+				return event->type == EVENT_PLAYER_MOVE;
+			};
+			auto movementBegin = std::find_if(events.begin(), events.end(), isMove);
+			auto movementEnd = std::find_if_not(movementBegin, events.end(), isMove);
 
 			// Movement logic
-			if (movementEvents.size())
+			if (movementBegin != movementEnd)
 			{
 				if (!_isInterpolating)
 				{
-					// Sort by vector
-					std::sort(movementEvents.begin(), movementEvents.end(),
-						[](const std::shared_ptr<GameEvent> & a, const std::shared_ptr<GameEvent> & b) -> bool
-						{
-							if (std::abs(a->direction.x - b->direction.x) < FP_EPSILON)
-								return a->direction.x < b->direction.x;
-							else
-								return a->direction.y < b->direction.y;
-						});
-
-					// Remove duplicate vectors
-					movementEvents.erase(std::unique(movementEvents.begin(), movementEvents.end(),
-						[](const std::shared_ptr<GameEvent> & a, const std::shared_ptr<GameEvent> & b) -> bool
-						{
-							return a->direction == b->direction;
-						}), movementEvents.end());
-
-					// Overall direction of player; take average of all direction vectors
+					// Overall direction of player; take average of all direction
+					// vectors, counting each distinct one once. There are only
+					// ever a handful, so a search beats sorting them.
 					glm::vec3 dir = glm::vec3(0);
 
-					for (auto& moveEvent : movementEvents)
+					for (auto it = movementBegin; it != movementEnd; it++)
 					{
-						dir += glm::vec3(moveEvent->direction.x, 0, moveEvent->direction.y);
+						auto& direction = (*it)->direction;
+						bool isDuplicate = std::any_of(movementBegin, it,
+							[&](const std::shared_ptr<GameEvent> & earlier)
+							{
+								return earlier->direction == direction;
+							});
+
+						if (!isDuplicate)
+						{
+							dir += glm::vec3(direction.x, 0, direction.y);
+						}
 					}
 
 					// Update forward vector with unit direction only if it was modified
@@ -104,9 +104,6 @@ public:
 			}
 		} // isStatic
 
-		// Update all timers for the player
-		updateTimers();
-
 		// Reset custom player message
 		playerState->message = "";
 
@@ -181,7 +178,7 @@ protected:
 			{
 				_isInterpolating = false;
 				_state->forward = _finalDirection;
-				hasChanged = true;
+				markChanged();
 				if (_interpOnComplete)
 				{
 					_interpOnComplete();
@@ -206,7 +203,7 @@ protected:
 				_state->pos += movementVec;
 				_state->forward = unitDiff;
 			}
-			hasChanged = true;
+			markChanged();
 		}
 	}
 
@@ -227,35 +224,20 @@ protected:
 		}
 	}
 
-	// Filters out movement and duplicate events
-	std::vector<std::shared_ptr<GameEvent>> getFilteredEvents(
-		std::vector<std::shared_ptr<GameEvent>> events)
+	// Whether event i is a movement event, or repeats the type of the one
+	// before it. Events are sorted by type, so this leaves one of each
+	// non-movement event.
+	static bool isFilteredEvent(EventSpan events, size_t i)
 	{
-		// Filter for non-movement events
-		auto filteredEvents = std::vector<std::shared_ptr<GameEvent>>();
-		for (auto& event : events)
-		{
-			if (event->type != EVENT_PLAYER_MOVE)
-			{
-				filteredEvents.push_back(event);
-			}
-		}
-
-		// Remove duplicates
-		filteredEvents.erase(std::unique(filteredEvents.begin(), filteredEvents.end(),
-			[](const std::shared_ptr<GameEvent> & a, const std::shared_ptr<GameEvent> & b) -> bool
-		{
-			return a->type == b->type;
-		}), filteredEvents.end());
-
-		return filteredEvents;
+		return events[i]->type == EVENT_PLAYER_MOVE ||
+			(i > 0 && events[i - 1]->type == events[i]->type);
 	}
 
 	void handleActionMoving() {
 		_state->forward = _newDir;
 		// Move player by (direction * velocity) / ticks_per_sec
 		_state->pos = _state->pos + ((_state->forward * _velocity) / (float)TICKS_PER_SEC);
-		hasChanged = true;
+		markChanged();
 	}
 };
 
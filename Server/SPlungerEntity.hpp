@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cfloat>
 #include "SBaseEntity.hpp"
 #include "PlungerCollider.hpp"
 #include "EmptyCollider.hpp"
@@ -13,6 +14,7 @@ public:
 	SPlungerEntity(glm::vec3 pos, glm::vec3 forward)
 	{
 		_state = std::make_shared<PlungerState>();
+		_hasUpdate = true;
 
 		// Base defaults
 		SBaseEntity::initState();
@@ -46,7 +48,7 @@ public:
 
 	~SPlungerEntity() {};
 
-	void update(std::vector<std::shared_ptr<GameEvent>> events) override
+	void update(EventSpan events) override
 	{
 		if (_state->isDestroyed)
 		{
@@ -56,7 +58,7 @@ public:
 		if (launching) {
 			_state->pos += _state->forward * (LAUNCHING_VELOCITY / TICKS_PER_SEC);
 		}
-		hasChanged = true;
+		markChanged();
 	}
 
 	void generalHandleCollision(SBaseEntity* entity) override
@@ -16,6 +16,7 @@ public:
 		// Allocate a state struct and initialize. Modify as necessary for more
 		// sane defaults
 		_state = std::make_shared<BaseState>();
+		_hasUpdate = true;
 
 		// Base defaults
 		SBaseEntity::initState();
@@ -37,21 +38,19 @@ public:
 		_state->isSolid = false;
 		_state->transparency = 0.60f;
 
-		hasChanged = true;
+		markChanged();
 
 		// Expires after 30 seconds
 		registerTimer(PUDDLE_DURATION_MSEC, [&]()
 			{
-				_state->isDestroyed = true;
-				hasChanged = true;
+				destroy();
+				markChanged();
 			});
 	};
 	~SPuddleEntity() {};
 
-	void update(std::vector<std::shared_ptr<GameEvent>> events)
+	void update(EventSpan events)
 	{
-		updateTimers();
-
 		// Shrink the puddle
 		const float diff = PUDDLE_MAX_WIDTH - PUDDLE_MIN_WIDTH;
 		const float durationSecs = PUDDLE_DURATION_MSEC / 1000;
@@ -61,6 +60,6 @@ public:
 		_state->depth -= change;
 		_state->scale.x -= change / 2;
 		_state->scale.z -= change / 2;
-		hasChanged = true;
+		markChanged();
 	}
 };
@@ -25,7 +25,7 @@ public:
 		_state->scale.z = glm::length(endPos - beginPos);
 		_state->forward = glm::normalize(endPos - beginPos);
 		_state->width = _state->scale.z;
-		hasChanged = true;
+		markChanged();
 	}
 	~SRopeEntity() {};
 };
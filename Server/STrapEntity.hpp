@@ -27,7 +27,7 @@ public:
 		// Non-solid object
 		_state->isSolid = false;
 
-		hasChanged = true;
+		markChanged();
 	}
 	~STrapEntity() {};
 };
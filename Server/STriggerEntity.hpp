@@ -19,7 +19,7 @@ public:
 		curDegree += degree + 360;
 		curDegree %= 360;
 		_state->forward = origForward * (float)curDegree + origForward;
-		hasChanged = true;
+		markChanged();
 	}
 
 	~STriggerEntity() {};
@@ -0,0 +1,170 @@
+#include "ScriptedNetwork.hpp"
+#include "IdGenerator.hpp"
+
+ScriptedNetwork::ScriptedNetwork(int botCount)
+{
+	for (int i = 0; i < botCount; i++)
+	{
+		Bot bot = Bot();
+		bot.playerId = IdGenerator::getInstance()->getNextId();
+		bot.isDog = (i % 2 == 0);
+		bot.isConnected = true;
+		bot.random.seed(i + 1);
+		bot.direction = glm::vec2(0);
+		bot.headingTicks = 0;
+		bot.actionTicks = 0;
+		_bots.push_back(bot);
+	}
+
+	_tick = 0;
+	_packetsSent = 0;
+	_statesSent = 0;
+}
+
+std::vector<uint32_t> ScriptedNetwork::getPlayerList()
+{
+	auto playerList = std::vector<uint32_t>();
+	for (auto& bot : _bots)
+	{
+		if (bot.isConnected)
+		{
+			playerList.push_back(bot.playerId);
+		}
+	}
+	return playerList;
+}
+
+void ScriptedNetwork::closePlayerSession(uint32_t playerId)
+{
+	for (auto& bot : _bots)
+	{
+		if (bot.playerId == playerId)
+		{
+			bot.isConnected = false;
+		}
+	}
+}
+
+std::shared_ptr<GameEvent> ScriptedNetwork::makeEvent(Bot & bot, EventType type)
+{
+	auto event = std::make_shared<GameEvent>();
+	event->type = type;
+	event->playerId = bot.playerId;
+	event->direction = bot.direction;
+	return event;
+}
+
+void ScriptedNetwork::scriptBot(Bot & bot, std::vector<std::shared_ptr<GameEvent>> & events)
+{
+	// Wander around, stopping every so often
+	if (--bot.headingTicks <= 0)
+	{
+		bot.headingTicks = 30 + bot.random() % SCRIPT_MAX_HEADING_TICKS;
+		if (bot.random() % 8 == 0)
+		{
+			bot.direction = glm::vec2(0);
+			events.push_back(makeEvent(bot, EVENT_PLAYER_STOP));
+		}
+		else
+		{
+			float angle = (float)(bot.random() % 360) * 3.14159265f / 180.0f;
+			bot.direction = glm::vec2(std::cos(angle), std::sin(angle));
+		}
+	}
+
+	if (bot.direction != glm::vec2(0))
+	{
+		events.push_back(makeEvent(bot, EVENT_PLAYER_MOVE));
+	}
+
+	// Finish the current ability, or maybe start a new one
+	if (bot.actionTicks > 0)
+	{
+		if (--bot.actionTicks == 0)
+		{
+			events.push_back(makeEvent(bot, bot.actionEnd));
+		}
+		return;
+	}
+
+	if (bot.random() % 90 != 0)
+	{
+		return;
+	}
+
+	bot.actionTicks = 20 + bot.random() % 70;
+	switch (bot.random() % 3)
+	{
+	case 0:
+		events.push_back(makeEvent(bot, bot.isDog ? EVENT_PLAYER_RUN_START : EVENT_PLAYER_LAUNCH_START));
+		bot.actionEnd = bot.isDog ? EVENT_PLAYER_RUN_END : EVENT_PLAYER_LAUNCH_END;
+		break;
+	case 1:
+		events.push_back(makeEvent(bot, bot.isDog ? EVENT_PLAYER_URINATE_START : EVENT_PLAYER_CHARGE_NET));
+		bot.actionEnd = bot.isDog ? EVENT_PLAYER_URINATE_END : EVENT_PLAYER_SWING_NET;
+		break;
+	case 2:
+		events.push_back(makeEvent(bot, bot.isDog ? EVENT_PLAYER_INTERACT_START : EVENT_PLAYER_PLACE_TRAP));
+		bot.actionEnd = bot.isDog ? EVENT_PLAYER_INTERACT_END : EVENT_PLAYER_STOP;
+		break;
+	}
+}
+
+void ScriptedNetwork::receiveEvents(std::vector<std::shared_ptr<GameEvent>> & events)
+{
+	for (auto& bot : _bots)
+	{
+		if (!bot.isConnected)
+		{
+			continue;
+		}
+
+		// Join, ready up and finish loading on consecutive ticks
+		switch (_tick)
+		{
+		case 0:
+		{
+			auto event = makeEvent(bot, EVENT_PLAYER_JOIN);
+			event->playerName = "bot" + std::to_string(bot.playerId);
+			events.push_back(event);
+			break;
+		}
+		case 1:
+			events.push_back(makeEvent(bot, EVENT_PLAYER_READY));
+			break;
+		case 2:
+			events.push_back(makeEvent(bot, EVENT_CLIENT_READY));
+			break;
+		default:
+			scriptBot(bot, events);
+		}
+	}
+
+	_tick++;
+}
+
+void ScriptedNetwork::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates)
+{
+	sendUpdates(updates, 0);
+}
+
+void ScriptedNetwork::sendUpdate(std::shared_ptr<BaseState> update)
+{
+	sendUpdates(std::vector<std::shared_ptr<BaseState>>({ update }), 0);
+}
+
+void ScriptedNetwork::sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t)
+{
+	if (updates.empty())
+	{
+		return;
+	}
+
+	_packetsSent++;
+	_statesSent += updates.size();
+}
+
+void ScriptedNetwork::sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId)
+{
+	sendUpdates(std::vector<std::shared_ptr<BaseState>>({ update }), playerId);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "NetworkInterface.hpp"
+
+// Ticks a bot keeps heading the same way, at most
+#define SCRIPT_MAX_HEADING_TICKS 180
+
+/*
+** Stand-in for the NetworkServer that plays back a script of events for a
+** fixed number of bots, and throws away everything sent to them. Lets the
+** game run headless, with no sockets.
+**
+** Every bot joins, readies up and reports itself loaded over the first few
+** ticks. From then on each one sends a move event every tick, as a real
+** client does while a key is held, and now and then stops or uses its
+** abilities. Scripts are seeded per bot, so every run sends the same events.
+*/
+class ScriptedNetwork : public NetworkInterface
+{
+public:
+	ScriptedNetwork(int botCount);
+	~ScriptedNetwork() {};
+
+	std::vector<uint32_t> getPlayerList() override;
+	void closePlayerSession(uint32_t playerId) override;
+	void clearQueues() override {};
+
+	// Appends the next tick's worth of scripted events
+	void receiveEvents(std::vector<std::shared_ptr<GameEvent>> & events) override;
+
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates) override;
+	void sendUpdate(std::shared_ptr<BaseState> update) override;
+	void sendUpdates(std::vector<std::shared_ptr<BaseState>> updates, uint32_t playerId) override;
+	void sendUpdate(std::shared_ptr<BaseState> update, uint32_t playerId) override;
+
+	// Totals of what has been sent so far
+	size_t getPacketsSent() { return _packetsSent; };
+	size_t getStatesSent() { return _statesSent; };
+
+private:
+	struct Bot
+	{
+		uint32_t playerId;
+		bool isDog;		// Sides alternate by join order, starting with dogs
+		bool isConnected;
+		std::mt19937 random;
+
+		glm::vec2 direction;
+		int headingTicks;	// Ticks left before picking a new direction
+		int actionTicks;	// Ticks left in the current ability, if any
+		EventType actionEnd;	// Sent when the current ability runs out
+	};
+
+	// Appends one tick of gameplay events for bot
+	void scriptBot(Bot & bot, std::vector<std::shared_ptr<GameEvent>> & events);
+
+	std::shared_ptr<GameEvent> makeEvent(Bot & bot, EventType type);
+
+	std::vector<Bot> _bots;
+	size_t _tick;
+
+	size_t _packetsSent;
+	size_t _statesSent;
+};
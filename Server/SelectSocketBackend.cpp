@@ -0,0 +1,102 @@
+#include <thread>
+#include <chrono>
+
+#include "SelectSocketBackend.hpp"
+
+bool SelectSocketBackend::addSocket(SOCKET socket, uint32_t playerId)
+{
+	std::unique_lock<std::mutex> lock(_socketMutex);
+
+	// FD sets have a fixed capacity
+	if (_sockets.size() >= FD_SETSIZE)
+	{
+		return false;
+	}
+
+	_sockets[socket] = { playerId, false };
+	return true;
+}
+
+
+void SelectSocketBackend::removeSocket(SOCKET socket, uint32_t)
+{
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	_sockets.erase(socket);
+}
+
+
+void SelectSocketBackend::setWriteInterest(SOCKET socket, uint32_t, bool isInterested)
+{
+	std::unique_lock<std::mutex> lock(_socketMutex);
+
+	auto result = _sockets.find(socket);
+	if (result != _sockets.end())
+	{
+		result->second.isWriteInterested = isInterested;
+	}
+}
+
+
+int SelectSocketBackend::wait(std::vector<SocketEvent> & events, int timeoutMs)
+{
+	fd_set readSet;
+	fd_set writeSet;
+	fd_set exceptSet;
+	FD_ZERO(&readSet);
+	FD_ZERO(&writeSet);
+	FD_ZERO(&exceptSet);
+
+	// Copy of the watched sockets, so that the lock is not held while blocked
+	std::unique_lock<std::mutex> lock(_socketMutex);
+	auto sockets = _sockets;
+	lock.unlock();
+
+	// select() errors out on empty sets on Windows, so just sleep instead
+	if (sockets.empty())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+		return 0;
+	}
+
+	// Set read, write and except FDs. Sockets are almost always writable, so
+	// only watch the ones that are backed up. nfds is ignored on Windows.
+	SOCKET maxSocket = 0;
+	for (auto& pair : sockets)
+	{
+		FD_SET(pair.first, &readSet);
+		FD_SET(pair.first, &exceptSet);
+		if (pair.second.isWriteInterested)
+		{
+			FD_SET(pair.first, &writeSet);
+		}
+		if (pair.first > maxSocket)
+		{
+			maxSocket = pair.first;
+		}
+	}
+
+	struct timeval timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+	if (select((int)maxSocket + 1, &readSet, &writeSet, &exceptSet, &timeout) == SOCKET_ERROR)
+	{
+		return -1;
+	}
+
+	int eventCount = 0;
+	for (auto& pair : sockets)
+	{
+		bool isReadable = FD_ISSET(pair.first, &readSet) != 0;
+		bool isWritable = FD_ISSET(pair.first, &writeSet) != 0;
+		bool isError = FD_ISSET(pair.first, &exceptSet) != 0;
+
+		if (isReadable || isWritable || isError)
+		{
+			events.push_back({ pair.second.playerId, isReadable, isWritable, isError });
+			eventCount++;
+		}
+	}
+
+	return eventCount;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "SocketBackend.hpp"
+
+/*
+** Level-triggered backend built on select(). This is what we have always used
+** on Windows, and it works anywhere, but it rebuilds its FD sets on every
+** call and scans every socket per wakeup. Prefer epoll on Linux.
+**
+** Write interest changes are only picked up on the next call to wait().
+*/
+class SelectSocketBackend : public SocketBackend
+{
+public:
+	SelectSocketBackend() {};
+	~SelectSocketBackend() {};
+
+	bool addSocket(SOCKET socket, uint32_t playerId) override;
+
+	void removeSocket(SOCKET socket, uint32_t playerId) override;
+
+	void setWriteInterest(SOCKET socket, uint32_t playerId, bool isInterested) override;
+
+	int wait(std::vector<SocketEvent> & events, int timeoutMs) override;
+
+	const char * getName() override { return "select"; }
+
+private:
+	struct WatchedSocket
+	{
+		uint32_t playerId;
+		bool isWriteInterested;
+	};
+
+	// Watched sockets, keyed by socket
+	std::unordered_map<SOCKET, WatchedSocket> _sockets;
+	std::mutex _socketMutex;
+};
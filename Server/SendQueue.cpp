@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstring>
+
+#include "SendQueue.hpp"
+
+SendQueue::SendQueue(size_t ringSize, size_t highWaterMark, size_t maxBacklog)
+{
+	_ring = (char*)malloc(ringSize);
+	_ringSize = ringSize;
+	_ringHead = 0;
+	_ringUsed = 0;
+
+	_backlogFrontOffset = 0;
+	_backlogBytes = 0;
+	_isFrontEncoded = false;
+
+	_hasWireFormat = false;
+	_wireFormat = WIRE_FORMAT_STANDARD;
+
+	_highWaterMark = highWaterMark;
+	_maxBacklog = maxBacklog;
+	_coalescedCount = 0;
+}
+
+
+SendQueue::~SendQueue()
+{
+	free(_ring);
+}
+
+
+bool SendQueue::push(const SendFrame & frame)
+{
+	// Under pressure, fold the new batch into the last queued one. The front
+	// frame may already be encoded and partially in the ring, so leave it.
+	if (isCongested() && _backlog.size() > 1)
+	{
+		size_t coalescedCount;
+		SendFrame merged = UpdateBatch::merge(*_backlog.back().frame, *frame, coalescedCount);
+		size_t mergedSize = merged->getEncoding(_wireFormat).data.size();
+
+		_backlogBytes -= _backlog.back().size;
+		_backlogBytes += mergedSize;
+		_backlog.back() = { merged, mergedSize };
+		_coalescedCount += coalescedCount;
+		return _backlogBytes <= _maxBacklog;
+	}
+
+	// Before the client picks a format this is only an estimate, as the
+	// standard format is the larger one
+	size_t size = frame->getEncoding(_wireFormat).data.size();
+	if (_backlogBytes + size > _maxBacklog)
+	{
+		return false;
+	}
+
+	_backlog.push_back({ frame, size });
+	_backlogBytes += size;
+
+	return true;
+}
+
+
+void SendQueue::setWireFormat(WireFormat format)
+{
+	if (_hasWireFormat)
+	{
+		return;
+	}
+
+	_hasWireFormat = true;
+	_wireFormat = format;
+	_encoder.setWireFormat(format);
+}
+
+
+FlushResult SendQueue::flush(SOCKET socket)
+{
+	while (true)
+	{
+		fillRing();
+		if (!_ringUsed)
+		{
+			return FLUSH_DONE;
+		}
+
+		// Send the contiguous chunk starting at the head of the ring
+		size_t chunk = std::min(_ringUsed, _ringSize - _ringHead);
+		int sendResult = send(socket, _ring + _ringHead, (int)chunk, SEND_FLAGS);
+
+		if (sendResult > 0)
+		{
+			_ringHead = (_ringHead + sendResult) % _ringSize;
+			_ringUsed -= sendResult;
+		}
+		else if (sendResult == SOCKET_ERROR && isWouldBlock(getLastSocketError()))
+		{
+			return FLUSH_BLOCKED;
+		}
+		else
+		{
+			return FLUSH_ERROR;
+		}
+	}
+}
+
+
+void SendQueue::fillRing()
+{
+	while (_hasWireFormat && !_backlog.empty() && _ringUsed < _ringSize)
+	{
+		if (!_isFrontEncoded)
+		{
+			_encoder.encode(_backlog.front().frame, _encoded);
+			_backlogBytes -= _backlog.front().size;
+			_isFrontEncoded = true;
+		}
+
+		// Copy into the free space, which may wrap around the end of the ring
+		size_t tail = (_ringHead + _ringUsed) % _ringSize;
+		size_t count = std::min(
+				_encoded.size() - _backlogFrontOffset,
+				std::min(_ringSize - _ringUsed, _ringSize - tail));
+
+		memcpy(_ring + tail, _encoded.data() + _backlogFrontOffset, count);
+		_ringUsed += count;
+		_backlogFrontOffset += count;
+
+		if (_backlogFrontOffset == _encoded.size())
+		{
+			_backlog.pop_front();
+			_backlogFrontOffset = 0;
+			_isFrontEncoded = false;
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+#include "SocketCompat.hpp"
+#include "UpdateBatch.hpp"
+#include "SnapshotEncoder.hpp"
+
+// Serialized batch of updates, shared between every session it is sent to
+typedef std::shared_ptr<const UpdateBatch> SendFrame;
+
+// Result of trying to flush a queue to its socket
+enum FlushResult
+{
+	FLUSH_DONE,		// Everything queued has been handed to the kernel
+	FLUSH_BLOCKED,	// Socket is full; try again once it is writable
+	FLUSH_ERROR		// Socket errored out; the session should be closed
+};
+
+/*
+** Outgoing data for a single player session. Frames are first queued on a
+** backlog, then delta-encoded against what the client has acknowledged and
+** copied into a fixed-size ring buffer right before they are sent. Encoding
+** late means deltas use the freshest acks, and many small packets still go
+** out in one send() call.
+**
+** The backlog only grows while the socket is not keeping up. Once it is
+** larger than the high-water mark, new batches are merged into the last
+** queued one, dropping updates for entities that have a newer one. If it
+** still outgrows the hard limit the client is hopeless, and push() fails.
+**
+** Nothing is sent until the client has picked a wire format, since the
+** format decides how every frame is serialized.
+**
+** Not thread-safe on its own. Hold getMutex() around every call.
+*/
+class SendQueue
+{
+public:
+	SendQueue(size_t ringSize, size_t highWaterMark, size_t maxBacklog);
+	~SendQueue();
+
+	// Queues a batch. Returns false if the backlog is over the hard limit.
+	bool push(const SendFrame & frame);
+
+	// Sends as much as possible without blocking
+	FlushResult flush(SOCKET socket);
+
+	// Sets the format frames are sent in. Only the first call has any effect;
+	// baselines are already in that format after it.
+	void setWireFormat(WireFormat format);
+
+	// The client has received every packet up to and including sequence
+	void acknowledge(uint32_t sequence) { _encoder.acknowledge(sequence); }
+
+	// Whether anything is still waiting to be sent
+	bool hasPending() { return _ringUsed || !_backlog.empty(); }
+
+	// Whether the backlog is over the high-water mark
+	bool isCongested() { return _backlogBytes > _highWaterMark; }
+
+	// Number of updates replaced by a newer one since the queue was created
+	uint64_t getCoalescedCount() { return _coalescedCount; }
+
+	std::mutex & getMutex() { return _mutex; }
+
+private:
+	// Moves as much of the backlog into the ring as will fit
+	void fillRing();
+
+	// Ring buffer of bytes that are committed to the wire
+	char * _ring;
+	size_t _ringSize;
+	size_t _ringHead;
+	size_t _ringUsed;
+
+	// Frame waiting for space in the ring, with its serialized size
+	struct QueuedFrame
+	{
+		SendFrame frame;
+		size_t size;
+	};
+
+	// Frames waiting for space in the ring. The front one is encoded into
+	// _encoded as soon as it starts going into the ring.
+	std::deque<QueuedFrame> _backlog;
+	size_t _backlogFrontOffset;	// Bytes of _encoded already in the ring
+	size_t _backlogBytes;		// Serialized size of the frames not yet encoded
+	bool _isFrontEncoded;
+
+	// Until the client picks a format, frames are only queued
+	bool _hasWireFormat;
+	WireFormat _wireFormat;
+
+	SnapshotEncoder _encoder;
+	std::vector<char> _encoded;
+
+	size_t _highWaterMark;
+	size_t _maxBacklog;
+	uint64_t _coalescedCount;
+
+	std::mutex _mutex;
+};
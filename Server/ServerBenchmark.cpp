@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <sstream>
+#include <iomanip>
+
+#include "ServerBenchmark.hpp"
+#include "ScriptedNetwork.hpp"
+#include "SPlungerEntity.hpp"
+
+#ifdef SERVER_BENCHMARK
+/*
+** Allocations made by each thread, counted by replacing the global operator
+** new. This is the only way to see allocations without an external tool, but
+** it replaces allocation for the whole process, so it is only built into
+** benchmark builds, with SERVER_BENCHMARK defined. Array and nothrow forms
+** forward to these.
+*/
+static thread_local size_t allocationCount = 0;
+
+void * operator new(size_t size)
+{
+	allocationCount++;
+	if (void * ptr = std::malloc(size ? size : 1))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+// GCC inlines these into its own allocators and, seeing free() on memory from
+// operator new, warns that they do not match, though here they do
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void * ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+ServerBenchmark::ServerBenchmark(int playerCount, int tickCount)
+{
+	_playerCount = playerCount;
+	_tickCount = tickCount;
+}
+
+void ServerBenchmark::run()
+{
+	// Directory order is unspecified, so sort by name
+	auto levels = std::vector<std::string>();
+	for (auto& entry : std::filesystem::directory_iterator(BENCHMARK_LEVELS_DIR))
+	{
+		if (entry.is_directory() && std::filesystem::exists(entry.path() / "map.dat"))
+		{
+			levels.push_back(entry.path().filename().string());
+		}
+	}
+	std::sort(levels.begin(), levels.end());
+
+	if (levels.empty())
+	{
+		Logger::getInstance()->error("No levels found in " BENCHMARK_LEVELS_DIR);
+		return;
+	}
+
+	for (auto& name : levels)
+	{
+		auto levelPath = std::filesystem::path(BENCHMARK_LEVELS_DIR) / name / "map.dat";
+		runLevel(name, levelPath.string());
+	}
+}
+
+void ServerBenchmark::runLevel(std::string name, std::string levelPath)
+{
+	auto network = std::make_unique<ScriptedNetwork>(_playerCount);
+	auto scriptedNetwork = network.get();
+
+	GameServer server(std::move(network), levelPath);
+	server.initialize();
+
+	// Get the game going. Loading and the pregame countdown take a few
+	// seconds of game time, so this gives up after a while rather than hang.
+	auto gameState = server.getStructureInfo()->gameState;
+	auto warmupTicks = tick(LOADING_LENGTH + PREGAME_LENGTH * 2).count();
+	for (int i = 0; i < warmupTicks && !gameState->gameStarted; i++)
+	{
+		server.update();
+	}
+
+	if (!gameState->gameStarted)
+	{
+		Logger::getInstance()->warn(name + ": game never started, measuring anyway");
+	}
+
+	// Per-tick samples of every metric a room tick records
+	auto samples = std::vector<std::vector<double>>(PROFILE_METRIC_COUNT);
+#ifdef SERVER_BENCHMARK
+	auto allocations = std::vector<double>();
+#endif
+
+	size_t statesSent = scriptedNetwork->getStatesSent();
+
+	for (int i = 0; i < _tickCount; i++)
+	{
+#ifdef SERVER_BENCHMARK
+		size_t allocationsBefore = allocationCount;
+		server.update();
+		allocations.push_back((double)(allocationCount - allocationsBefore));
+#else
+		server.update();
+#endif
+
+		// Phases that did not run this tick took no time
+		auto& lastTick = Profiler::getInstance()->getLastTick();
+		for (int metric = PROFILE_ROOM_TICK; metric < PROFILE_METRIC_COUNT; metric++)
+		{
+			double value = (double)lastTick.values[metric];
+			samples[metric].push_back(Profiler::isDuration((ProfileMetric)metric) ? value / 1000 : value);
+		}
+	}
+
+	auto structureInfo = server.getStructureInfo();
+	Logger::getInstance()->info(name + ": " +
+		std::to_string(_playerCount) + " players, " +
+		std::to_string(_tickCount) + " ticks, " +
+		std::to_string(structureInfo->entities->size()) + " entities, " +
+		std::to_string((scriptedNetwork->getStatesSent() - statesSent) / _tickCount) + " states sent per tick");
+
+	report("tick", samples[PROFILE_ROOM_TICK], "us");
+	for (int metric = PROFILE_EVENT_INGEST; metric < PROFILE_ENTITIES_TICKED; metric++)
+	{
+		if (metric != PROFILE_SERIALIZATION)
+		{
+			report(std::string("  ") + Profiler::getName((ProfileMetric)metric),
+				samples[metric], "us");
+		}
+	}
+#ifdef SERVER_BENCHMARK
+	report("allocations", allocations, "per tick");
+#endif
+	report("changed entities", samples[PROFILE_ENTITIES_CHANGED], "per tick");
+	report("ticked entities", samples[PROFILE_ENTITIES_TICKED], "per tick");
+
+	benchmarkBroadPhase(structureInfo);
+	benchmarkNarrowPhase(structureInfo);
+
+	server.shutdown();
+}
+
+void ServerBenchmark::benchmarkBroadPhase(StructureInfo * structureInfo)
+{
+	auto states = std::vector<BaseState*>();
+	for (auto& state : structureInfo->entities->getStates())
+	{
+		if (state->colliderType != COLLIDER_NONE)
+		{
+			states.push_back(state);
+		}
+	}
+
+	if (states.empty())
+	{
+		return;
+	}
+
+	const char * names[] = { "quadtree", "grid" };
+	BroadPhaseType types[] = { BROAD_PHASE_QUADTREE, BROAD_PHASE_GRID };
+	auto results = std::vector<BaseState*>();
+
+	for (int i = 0; i < 2; i++)
+	{
+		auto inserts = std::vector<double>();
+		auto queries = std::vector<double>();
+		size_t candidates = 0;
+
+		for (int round = 0; round < BENCHMARK_ROUNDS; round++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto broadPhase = BroadPhase::create(
+				types[i],
+				BoundingBox({ glm::vec2(0), MAP_WIDTH / 2 }),
+				structureInfo->gridWidth);
+			for (auto& state : states)
+			{
+				broadPhase->update(state);
+			}
+			auto end = std::chrono::steady_clock::now();
+			inserts.push_back(std::chrono::duration<double, std::nano>(end - start).count() / states.size());
+
+			candidates = 0;
+			start = std::chrono::steady_clock::now();
+			for (auto& state : states)
+			{
+				results.clear();
+				broadPhase->query(state, results);
+				candidates += results.size();
+			}
+			end = std::chrono::steady_clock::now();
+			queries.push_back(std::chrono::duration<double, std::nano>(end - start).count() / states.size());
+		}
+
+		report(std::string("  ") + names[i] + " insert", inserts, "ns");
+		report(std::string("  ") + names[i] + " query", queries, "ns, " +
+			std::to_string(candidates / states.size()) + " candidates");
+	}
+}
+
+void ServerBenchmark::benchmarkNarrowPhase(StructureInfo * structureInfo)
+{
+	auto players = std::vector<std::shared_ptr<SBaseEntity>>();
+	auto plungers = std::vector<std::shared_ptr<SBaseEntity>>();
+	for (auto& entity : *structureInfo->entities)
+	{
+		auto type = entity->getState()->type;
+		if (type == ENTITY_DOG || type == ENTITY_HUMAN)
+		{
+			auto state = entity->getState();
+			players.push_back(entity);
+
+			// A plunger fired from where each player stands
+			plungers.push_back(std::make_shared<SPlungerEntity>(state->pos, state->forward));
+		}
+	}
+
+	if (players.empty())
+	{
+		return;
+	}
+
+	auto broadPhase = BroadPhase::create(
+		DEFAULT_BROAD_PHASE,
+		BoundingBox({ glm::vec2(0), MAP_WIDTH / 2 }),
+		structureInfo->gridWidth);
+	for (auto& state : structureInfo->entities->getStates())
+	{
+		if (state->colliderType != COLLIDER_NONE)
+		{
+			broadPhase->update(state);
+		}
+	}
+
+	const char * names[] = { "capsule narrow", "plunger narrow" };
+	std::vector<std::shared_ptr<SBaseEntity>> * entityLists[] = { &players, &plungers };
+	auto candidates = std::vector<BaseState*>();
+
+	for (int i = 0; i < 2; i++)
+	{
+		// Candidates are gathered up front, so only the narrow phase is timed
+		auto pairs = std::vector<std::pair<SBaseEntity*, BaseState*>>();
+		for (auto& entity : *entityLists[i])
+		{
+			candidates.clear();
+			broadPhase->query(entity->getState().get(), candidates);
+			for (auto& candidate : candidates)
+			{
+				pairs.push_back({ entity.get(), candidate });
+			}
+		}
+
+		if (pairs.empty())
+		{
+			continue;
+		}
+
+		auto checks = std::vector<double>();
+		size_t hits = 0;
+		for (int round = 0; round < BENCHMARK_ROUNDS; round++)
+		{
+			hits = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (auto& pair : pairs)
+			{
+				hits += pair.first->isColliding(pair.second);
+			}
+			auto end = std::chrono::steady_clock::now();
+			checks.push_back(std::chrono::duration<double, std::nano>(end - start).count() / pairs.size());
+		}
+
+		report(std::string("  ") + names[i], checks, "ns, " +
+			std::to_string(pairs.size()) + " pairs, " + std::to_string(hits) + " hits");
+	}
+}
+
+void ServerBenchmark::report(std::string name, std::vector<double> & samples, std::string unit)
+{
+	std::sort(samples.begin(), samples.end());
+
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(1) << std::left << std::setw(24) << name <<
+		" p50 " << samples[samples.size() / 2] <<
+		"  p99 " << samples[samples.size() * 99 / 100] <<
+		"  max " << samples.back() << " " << unit;
+	Logger::getInstance()->info(line.str());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "GameServer.hpp"
+
+#define BENCHMARK_DEFAULT_PLAYERS 8
+#define BENCHMARK_DEFAULT_TICKS 2000
+
+// Every directory in here with a map.dat is benchmarked
+#define BENCHMARK_LEVELS_DIR "Levels"
+
+// Times each structure or collider is run over a level's entities
+#define BENCHMARK_ROUNDS 50
+
+/*
+** Runs the server headless against every level, with bots driven by a
+** ScriptedNetwork, and logs how long the parts of a tick take. Meant for
+** tracking regressions in the hot paths, so nothing here needs a socket or
+** a client.
+**
+** For each level, the game is first brought up to the point where it has
+** started. Game logic runs on game time, so both the warm-up and the measured
+** ticks run back to back, and every run plays out exactly the same.
+*/
+class ServerBenchmark
+{
+public:
+	ServerBenchmark(int playerCount, int tickCount);
+	~ServerBenchmark() {};
+
+	// Benchmarks every level and logs the results
+	void run();
+
+private:
+	void runLevel(std::string name, std::string levelPath);
+
+	// Per-object cost of inserting into and querying each broad phase
+	void benchmarkBroadPhase(StructureInfo * structureInfo);
+
+	// Per-candidate cost of player and plunger narrow phases
+	void benchmarkNarrowPhase(StructureInfo * structureInfo);
+
+	// Logs p50, p99 and max of samples, which get sorted
+	void report(std::string name, std::vector<double> & samples, std::string unit);
+
+	int _playerCount;
+	int _tickCount;
+};
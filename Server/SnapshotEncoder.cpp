@@ -0,0 +1,107 @@
+#include <cstring>
+
+#include "Shared/StateDelta.hpp"
+#include "SnapshotEncoder.hpp"
+#include "Profiler.hpp"
+
+// Appends a plain value to a packet
+template<typename T>
+static void writeValue(std::vector<char> & out, T value)
+{
+	const char * bytes = (const char*)&value;
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+
+SnapshotEncoder::SnapshotEncoder()
+{
+	// Zero is never used, so that a client can ack zero to mean nothing
+	_nextSequence = 1;
+	_wireFormat = WIRE_FORMAT_STANDARD;
+}
+
+
+void SnapshotEncoder::encode(const std::shared_ptr<const UpdateBatch> & batch, std::vector<char> & out)
+{
+	// Includes serializing the batch, for whichever session gets to it first
+	ProfileScope scope(PROFILE_SERIALIZATION);
+
+	uint32_t sequence = _nextSequence++;
+	const UpdateBatch::Encoding & encoding = batch->getEncoding(_wireFormat);
+
+	// Length goes first and is filled in at the end
+	out.clear();
+	writeValue<uint32_t>(out, 0);
+	writeValue<uint32_t>(out, sequence);
+	writeValue<uint32_t>(out, (uint32_t)encoding.records.size());
+
+	for (auto& record : encoding.records)
+	{
+		const char * current = encoding.data.data() + record.offset;
+		writeValue<uint32_t>(out, record.id);
+
+		// Deltas only work between states of the same size
+		auto result = _baselines.find(record.id);
+		if (result != _baselines.end() && result->second.data.size() == record.size)
+		{
+			writeValue<uint8_t>(out, STATE_RECORD_DELTA);
+			writeValue<uint32_t>(out, result->second.sequence);
+			writeValue<uint32_t>(out, record.size);
+			StateDelta::encode(result->second.data.data(), current, record.size, out);
+		}
+		else
+		{
+			writeValue<uint8_t>(out, STATE_RECORD_FULL);
+			writeValue<uint32_t>(out, result != _baselines.end() ? result->second.sequence : 0);
+			writeValue<uint32_t>(out, record.size);
+			out.insert(out.end(), current, current + record.size);
+		}
+	}
+
+	uint32_t size = (uint32_t)(out.size() - sizeof(uint32_t));
+	memcpy(out.data(), &size, sizeof(uint32_t));
+
+	// Held on to until the client says it has it
+	_unacked.push_back({ sequence, batch });
+	if (_unacked.size() > SNAPSHOT_MAX_UNACKED)
+	{
+		// Destroyed entities are never sent again, so their baselines would
+		// otherwise be kept for good
+		const UpdateBatch::Encoding & encoding = _unacked.front().batch->getEncoding(_wireFormat);
+		for (auto& record : encoding.records)
+		{
+			if (record.isDestroyed)
+			{
+				_baselines.erase(record.id);
+			}
+		}
+		_unacked.pop_front();
+	}
+}
+
+
+void SnapshotEncoder::acknowledge(uint32_t sequence)
+{
+	// Acks are cumulative, since TCP delivers packets in order. Later records
+	// for the same entity overwrite earlier ones.
+	while (!_unacked.empty() && _unacked.front().sequence <= sequence)
+	{
+		SentPacket & packet = _unacked.front();
+		const UpdateBatch::Encoding & encoding = packet.batch->getEncoding(_wireFormat);
+		for (auto& record : encoding.records)
+		{
+			// The client forgets destroyed entities, so we do too
+			if (record.isDestroyed)
+			{
+				_baselines.erase(record.id);
+				continue;
+			}
+
+			Baseline & baseline = _baselines[record.id];
+			const char * data = encoding.data.data() + record.offset;
+			baseline.sequence = packet.sequence;
+			baseline.data.assign(data, data + record.size);
+		}
+		_unacked.pop_front();
+	}
+}
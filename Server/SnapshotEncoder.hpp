@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "UpdateBatch.hpp"
+
+// Packets kept around waiting for an ack. If a client stops acking, the
+// oldest ones are forgotten, and deltas stay against older baselines.
+#define SNAPSHOT_MAX_UNACKED 1024
+
+/*
+** Turns update batches into snapshot packets for a single client (see
+** Shared/StateDelta.hpp for the layout). Every entity is sent as a delta
+** against the last state of it that the client has acknowledged, or in full
+** if there is none. The client keeps every state it received since, so any
+** acknowledged baseline can be used no matter how many packets are in
+** flight.
+**
+** Not thread-safe; owned by a session's SendQueue.
+*/
+class SnapshotEncoder
+{
+public:
+	SnapshotEncoder();
+
+	// Format the client asked for. Must be set before the first encode().
+	void setWireFormat(WireFormat format) { _wireFormat = format; }
+
+	// Encodes a batch as a length-prefixed snapshot packet into out, and
+	// remembers it until it is acknowledged
+	void encode(const std::shared_ptr<const UpdateBatch> & batch, std::vector<char> & out);
+
+	// The client has received every packet up to and including sequence
+	void acknowledge(uint32_t sequence);
+
+private:
+	// Last acknowledged state of an entity
+	struct Baseline
+	{
+		uint32_t sequence;
+		std::vector<char> data;
+	};
+
+	struct SentPacket
+	{
+		uint32_t sequence;
+		std::shared_ptr<const UpdateBatch> batch;
+	};
+
+	std::unordered_map<uint32_t, Baseline> _baselines;
+	std::deque<SentPacket> _unacked;
+	uint32_t _nextSequence;
+	WireFormat _wireFormat;
+};
@@ -0,0 +1,46 @@
+#include "Shared/Logger.hpp"
+#include "SocketBackend.hpp"
+#include "SelectSocketBackend.hpp"
+#include "EpollSocketBackend.hpp"
+#include "IoUringSocketBackend.hpp"
+
+std::unique_ptr<SocketBackend> SocketBackend::create(SocketBackendType type)
+{
+	switch (type)
+	{
+	case SOCKET_BACKEND_IO_URING:
+	{
+#if defined(__linux__) && defined(SOCKET_BACKEND_USE_IO_URING)
+		auto backend = std::make_unique<IoUringSocketBackend>();
+		if (backend->isValid())
+		{
+			return backend;
+		}
+		Logger::getInstance()->warn("Failed to set up io_uring, falling back to default socket backend");
+#else
+		Logger::getInstance()->warn("io_uring socket backend not built in, falling back to default");
+#endif
+		break;
+	}
+	case SOCKET_BACKEND_EPOLL:
+	{
+#ifdef __linux__
+		auto backend = std::make_unique<EpollSocketBackend>();
+		if (backend->isValid())
+		{
+			return backend;
+		}
+		Logger::getInstance()->warn("Failed to set up epoll, falling back to select()");
+#else
+		Logger::getInstance()->warn("epoll socket backend not available, falling back to select()");
+#endif
+		return std::make_unique<SelectSocketBackend>();
+	}
+	case SOCKET_BACKEND_SELECT:
+		return std::make_unique<SelectSocketBackend>();
+	}
+
+	// Only reached when io_uring was requested but is unavailable
+	return create(SOCKET_BACKEND_IO_URING == DEFAULT_SOCKET_BACKEND ?
+		SOCKET_BACKEND_EPOLL : DEFAULT_SOCKET_BACKEND);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "SocketCompat.hpp"
+
+// How long a backend may block in wait() before returning with no events
+#define SOCKET_WAIT_TIMEOUT_MS 100
+
+// Max number of events returned from a single call to wait()
+#define SOCKET_MAX_EVENTS 64
+
+// Available readiness notification backends
+enum SocketBackendType
+{
+	SOCKET_BACKEND_SELECT,	// Portable select(); the only option on Windows
+	SOCKET_BACKEND_EPOLL,	// Edge-triggered epoll; Linux default
+	SOCKET_BACKEND_IO_URING	// io_uring poll requests; Linux opt-in
+};
+
+// Pick a sane backend for the platform. io_uring needs liburing and a recent
+// kernel, so it is only picked if SOCKET_BACKEND_USE_IO_URING is defined.
+#if defined(_WIN32)
+#define DEFAULT_SOCKET_BACKEND SOCKET_BACKEND_SELECT
+#elif defined(SOCKET_BACKEND_USE_IO_URING)
+#define DEFAULT_SOCKET_BACKEND SOCKET_BACKEND_IO_URING
+#else
+#define DEFAULT_SOCKET_BACKEND SOCKET_BACKEND_EPOLL
+#endif
+
+/*
+** Readiness notification for a single player socket, returned by wait().
+*/
+struct SocketEvent
+{
+	uint32_t playerId;
+	bool isReadable;	// Data (or EOF) is waiting to be read
+	bool isWritable;	// Send buffer has room again
+	bool isError;		// Socket errored out or was hung up on
+};
+
+/*
+** Interface over the OS facility used to find out which player sockets have
+** activity. The NetworkServer registers sockets as sessions come and go, and
+** its read thread calls wait() in a loop.
+**
+** Backends may be edge-triggered, so callers must drain a readable socket
+** until recv() would block before waiting again. Writability is only
+** guaranteed to be reported for sockets with write interest set, and only
+** after a send() has reported would-block.
+**
+** addSocket(), removeSocket() and setWriteInterest() may be called from any
+** thread while another thread is blocked in wait(). Only one thread may call
+** wait() at a time.
+*/
+class SocketBackend
+{
+public:
+	virtual ~SocketBackend() {};
+
+	// Starts watching a non-blocking socket. Returns false on failure.
+	virtual bool addSocket(SOCKET socket, uint32_t playerId) = 0;
+
+	// Stops watching a socket. Must be called before the socket is closed.
+	virtual void removeSocket(SOCKET socket, uint32_t playerId) = 0;
+
+	// Asks to be told when a socket can be written to. Set it when send()
+	// would block and clear it once the session's send queue is empty.
+	virtual void setWriteInterest(SOCKET socket, uint32_t playerId, bool isInterested) = 0;
+
+	// Blocks for up to timeoutMs waiting for socket activity, and appends
+	// what happened to events. Returns the number of events appended, or -1
+	// on error.
+	virtual int wait(std::vector<SocketEvent> & events, int timeoutMs) = 0;
+
+	// Name of the backend, for logging
+	virtual const char * getName() = 0;
+
+	// Creates a backend of the given type. Falls back to the platform
+	// default if the requested type is not available in this build.
+	static std::unique_ptr<SocketBackend> create(SocketBackendType type);
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+** Thin portability layer over the platform socket APIs. Winsock is used on
+** Windows, and BSD sockets are used everywhere else (i.e. our Linux hosts).
+** Only the handful of types and calls that the NetworkServer and socket
+** backends need are wrapped here; everything else is plain BSD socket API,
+** which Winsock also provides.
+*/
+
+#ifdef _WIN32
+
+#include <winsock2.h>
+#include <WS2tcpip.h>
+
+#else
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+
+typedef int SOCKET;
+
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+
+#endif
+
+// Initializes the socket library. Returns zero on success, or an error code.
+inline int initSocketLibrary()
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	return WSAStartup(MAKEWORD(2, 2), &wsaData);
+#else
+	return 0;
+#endif
+}
+
+// Cleans up the socket library. Pairs with initSocketLibrary().
+inline void cleanupSocketLibrary()
+{
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+// Error code of the last failed socket call on this thread
+inline int getLastSocketError()
+{
+#ifdef _WIN32
+	return WSAGetLastError();
+#else
+	return errno;
+#endif
+}
+
+// Whether an error code means "try again later" on a non-blocking socket
+inline bool isWouldBlock(int error)
+{
+#ifdef _WIN32
+	return error == WSAEWOULDBLOCK;
+#else
+	return error == EWOULDBLOCK || error == EAGAIN;
+#endif
+}
+
+// Closes a socket
+inline void closeSocket(SOCKET socket)
+{
+#ifdef _WIN32
+	closesocket(socket);
+#else
+	close(socket);
+#endif
+}
+
+// Puts a socket in non-blocking mode. Returns false on failure.
+inline bool setNonBlocking(SOCKET socket)
+{
+#ifdef _WIN32
+	u_long socketMode = 1;
+	return ioctlsocket(socket, FIONBIO, &socketMode) != SOCKET_ERROR;
+#else
+	int flags = fcntl(socket, F_GETFL, 0);
+	return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+}
+
+// Disables Nagle's algorithm on a socket
+inline void setNoDelay(SOCKET socket)
+{
+	int one = 1;
+	setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+}
+
+// Flags for send(). On Linux, writing to a socket that the peer has closed
+// raises SIGPIPE and kills the process unless told otherwise.
+#ifdef _WIN32
+#define SEND_FLAGS 0
+#else
+#define SEND_FLAGS MSG_NOSIGNAL
+#endif
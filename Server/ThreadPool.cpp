@@ -0,0 +1,103 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+	if (!threadCount)
+	{
+		threadCount = std::thread::hardware_concurrency();
+	}
+
+	_task = nullptr;
+	_taskCount = 0;
+	_nextTask = 0;
+	_activeWorkers = 0;
+	_isStopping = false;
+
+	for (size_t i = 1; i < threadCount; i++)
+	{
+		_workers.push_back(std::thread(&ThreadPool::worker, this));
+	}
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_isStopping = true;
+	lock.unlock();
+	_workCond.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+
+void ThreadPool::run(size_t taskCount, const std::function<void(size_t)> & task)
+{
+	if (!taskCount)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_task = &task;
+	_taskCount = taskCount;
+	_nextTask = 0;
+	lock.unlock();
+
+	// Not worth waking anyone for a single task
+	if (taskCount > 1)
+	{
+		_workCond.notify_all();
+	}
+
+	runTasks();
+
+	// Every index is taken by now, but workers may still be running theirs
+	lock.lock();
+	_doneCond.wait(lock, [this]() { return _activeWorkers == 0; });
+	_task = nullptr;
+}
+
+
+void ThreadPool::worker()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_workCond.wait(lock, [this]()
+			{
+				return _isStopping || (_task && _nextTask < _taskCount);
+			});
+
+		if (_isStopping)
+		{
+			return;
+		}
+
+		// Counted before taking any index, so run() cannot return while a
+		// task of ours is still running
+		_activeWorkers++;
+		lock.unlock();
+
+		runTasks();
+
+		lock.lock();
+		if (--_activeWorkers == 0)
+		{
+			_doneCond.notify_one();
+		}
+	}
+}
+
+
+void ThreadPool::runTasks()
+{
+	size_t index;
+	while ((index = _nextTask++) < _taskCount)
+	{
+		(*_task)(index);
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+/*
+** Fixed set of worker threads for running many independent tasks at once,
+** such as ticking every room. run() hands out task indices to whichever
+** thread is free, the calling thread included, and returns once all of them
+** are done. Nothing is allocated per call, so it can be used every tick.
+**
+** Only one thread may call run() at a time.
+*/
+class ThreadPool
+{
+public:
+	// Starts threadCount - 1 workers, since the caller of run() works too.
+	// A threadCount of 0 means one thread per core.
+	ThreadPool(size_t threadCount = 0);
+
+	// Stops and joins the workers
+	~ThreadPool();
+
+	// Calls task(i) for every i in [0, taskCount), spread over the pool
+	void run(size_t taskCount, const std::function<void(size_t)> & task);
+
+	// Total threads that run tasks, counting the caller of run()
+	size_t getThreadCount() { return _workers.size() + 1; };
+
+private:
+	// Waits for run() to hand out tasks and helps with them
+	void worker();
+
+	// Takes and runs task indices until there are none left
+	void runTasks();
+
+	std::vector<std::thread> _workers;
+
+	// Guards everything below except _nextTask
+	std::mutex _mutex;
+	std::condition_variable _workCond;	// Work is available, or stopping
+	std::condition_variable _doneCond;	// A worker ran out of tasks
+
+	// Task being run, and how many indices it has. Only written while no
+	// workers are active.
+	const std::function<void(size_t)> * _task;
+	size_t _taskCount;
+	std::atomic<size_t> _nextTask;
+
+	// Workers between taking their first task index and running out
+	size_t _activeWorkers;
+	bool _isStopping;
+};
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <thread>
+#include <sstream>
+
+#include "Shared/Logger.hpp"
+#include "TickScheduler.hpp"
+
+TickScheduler::TickScheduler(int maxCatchUpTicks)
+{
+	_maxCatchUpTicks = maxCatchUpTicks;
+	_scheduledTicks = 0;
+	_tickCount = 0;
+
+	_latenessHistogram.fill(0);
+	_maxLateness = std::chrono::nanoseconds(0);
+	_caughtUpTicks = 0;
+	_droppedTicks = 0;
+}
+
+
+void TickScheduler::run(const std::function<void()> & tick, const std::atomic<bool> & isRunning)
+{
+	auto tickLength = GameClock::ticksToDuration(1);
+
+	_scheduleStart = std::chrono::steady_clock::now();
+	_scheduledTicks = 0;
+	_lastReport = _scheduleStart;
+
+	while (isRunning)
+	{
+		auto due = _scheduleStart + GameClock::ticksToDuration(_scheduledTicks);
+		auto now = std::chrono::steady_clock::now();
+
+		if (now < due)
+		{
+			std::this_thread::sleep_until(due);
+			continue;
+		}
+
+		auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - due);
+		recordLateness(lateness);
+
+		// Too far behind to catch up. Drop the backlog, and start counting
+		// from this tick instead.
+		uint64_t ticksBehind = lateness / tickLength;
+		if (ticksBehind > (uint64_t)_maxCatchUpTicks)
+		{
+			_droppedTicks += ticksBehind;
+			_scheduleStart += GameClock::ticksToDuration(ticksBehind);
+
+			Logger::getInstance()->warn("Server is " +
+				std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(lateness).count()) +
+				"ms behind, dropped " + std::to_string(ticksBehind) + " ticks");
+		}
+		else if (ticksBehind)
+		{
+			_caughtUpTicks++;
+		}
+
+		tick();
+		_scheduledTicks++;
+		_tickCount++;
+
+		if (now - _lastReport >= LATENESS_REPORT_INTERVAL)
+		{
+			report();
+			_lastReport = now;
+		}
+	}
+}
+
+
+void TickScheduler::recordLateness(std::chrono::nanoseconds lateness)
+{
+	auto microseconds = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(lateness).count();
+
+	// Index of the highest set bit, plus one
+	size_t bucket = 0;
+	while (microseconds && bucket < LATENESS_BUCKETS - 1)
+	{
+		microseconds >>= 1;
+		bucket++;
+	}
+
+	_latenessHistogram[bucket]++;
+	_maxLateness = std::max(_maxLateness, lateness);
+}
+
+
+void TickScheduler::report()
+{
+	uint64_t total = 0;
+	for (auto& count : _latenessHistogram)
+	{
+		total += count;
+	}
+
+	if (!total)
+	{
+		return;
+	}
+
+	uint64_t maxMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(_maxLateness).count();
+
+	// Upper bound of the bucket holding a percentile, in microseconds. The
+	// last bucket has no upper bound, so the max stands in for it.
+	auto percentile = [this, total, maxMicroseconds](uint64_t percent)
+	{
+		uint64_t seen = 0;
+		for (size_t i = 0; i < LATENESS_BUCKETS - 1; i++)
+		{
+			seen += _latenessHistogram[i];
+			if (seen * 100 >= total * percent)
+			{
+				return (uint64_t)1 << i;
+			}
+		}
+		return maxMicroseconds;
+	};
+
+	std::ostringstream line;
+	line << "Tick lateness over " << total << " ticks: p50 <" << percentile(50) <<
+		"us, p99 <" << percentile(99) << "us, max " << maxMicroseconds << "us; " <<
+		_caughtUpTicks << " caught up, " << _droppedTicks << " dropped";
+	Logger::getInstance()->info(line.str());
+
+	_latenessHistogram.fill(0);
+	_maxLateness = std::chrono::nanoseconds(0);
+	_caughtUpTicks = 0;
+	_droppedTicks = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdint.h>
+
+#include "Shared/GameClock.hpp"
+
+// Ticks run back to back to catch up after running late. Anything further
+// behind than this is dropped rather than run, so a long stall does not turn
+// into a long burst of ticks.
+#define MAX_CATCH_UP_TICKS 5
+
+// How often tick lateness is logged
+#define LATENESS_REPORT_INTERVAL std::chrono::seconds(10)
+
+// Lateness histogram buckets. Bucket 0 is on time, and bucket i > 0 holds
+// lateness of [2^(i-1), 2^i) microseconds, the last one everything above.
+#define LATENESS_BUCKETS 20
+
+/*
+** Runs a tick function at a fixed rate of TICKS_PER_SEC, against the wall
+** clock. Tick n is due at exactly n ticks after the scheduler started, so
+** sleeping too long or a slow tick never shifts the ticks after it; the
+** scheduler just runs the late ones back to back until it has caught up.
+**
+** How late each tick started is kept in a histogram and logged every
+** LATENESS_REPORT_INTERVAL, along with how many ticks had to catch up and how
+** many were dropped.
+*/
+class TickScheduler
+{
+public:
+	TickScheduler(int maxCatchUpTicks = MAX_CATCH_UP_TICKS);
+	~TickScheduler() {};
+
+	// Calls tick() on schedule until isRunning is false
+	void run(const std::function<void()> & tick, const std::atomic<bool> & isRunning);
+
+	// Ticks run so far
+	uint64_t getTickCount() { return _tickCount; };
+
+private:
+	void recordLateness(std::chrono::nanoseconds lateness);
+
+	// Logs and clears the lateness stats
+	void report();
+
+	int _maxCatchUpTicks;
+
+	// Tick n is due at _scheduleStart + n ticks. Moved forward when ticks are
+	// dropped.
+	std::chrono::steady_clock::time_point _scheduleStart;
+	uint64_t _scheduledTicks;
+
+	uint64_t _tickCount;
+
+	// Lateness since the last report
+	std::array<uint64_t, LATENESS_BUCKETS> _latenessHistogram;
+	std::chrono::nanoseconds _maxLateness;
+	uint64_t _caughtUpTicks;	// Started a tick or more late
+	uint64_t _droppedTicks;
+	std::chrono::steady_clock::time_point _lastReport;
+};
@@ -0,0 +1,195 @@
+#include <algorithm>
+
+#include "TimerWheel.hpp"
+#include "Shared/Common.hpp"
+
+TimerWheel::TimerWheel(uint64_t startTick)
+{
+	_heads.fill(NONE);
+	_currentTick = startTick;
+	_pendingCount = 0;
+}
+
+TimerHandle TimerWheel::schedule(uint64_t delayTicks, std::function<void()> f)
+{
+	// Reuse a node if there is one, otherwise grow the pool
+	uint32_t index;
+	if (_freeNodes.size())
+	{
+		index = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	else
+	{
+		index = (uint32_t)_nodes.size();
+		_nodes.push_back(Node());
+		_nodes[index].generation = 1;
+	}
+
+	delayTicks = std::max(delayTicks, (uint64_t)1);
+	delayTicks = std::min(delayTicks, TIMER_WHEEL_MAX_TICKS - 1);
+
+	auto& node = _nodes[index];
+	node.expiry = _currentTick + delayTicks;
+	node.callback = std::move(f);
+	insert(index);
+	_pendingCount++;
+
+	return TimerHandle({ index, node.generation });
+}
+
+TimerHandle TimerWheel::scheduleMilliseconds(long milliseconds, std::function<void()> f)
+{
+	uint64_t ticks = 0;
+	if (milliseconds > 0)
+	{
+		ticks = ((uint64_t)milliseconds * TICKS_PER_SEC + 999) / 1000;
+	}
+	return schedule(ticks, std::move(f));
+}
+
+bool TimerWheel::cancel(TimerHandle handle)
+{
+	if (!isPending(handle))
+	{
+		return false;
+	}
+
+	unlink(handle.index);
+	release(handle.index);
+	_pendingCount--;
+	return true;
+}
+
+bool TimerWheel::isPending(TimerHandle handle)
+{
+	return handle.index < _nodes.size() &&
+		_nodes[handle.index].generation == handle.generation &&
+		_nodes[handle.index].list != NONE;
+}
+
+void TimerWheel::advance(uint64_t tick)
+{
+	while (_currentTick < tick)
+	{
+		// Nothing to fire or cascade, so skip straight there
+		if (!_pendingCount)
+		{
+			_currentTick = tick;
+			return;
+		}
+
+		uint64_t t = ++_currentTick;
+
+		// Each time a level wraps around, the next slot of the level above
+		// comes within its reach and is spread out over it
+		for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+		{
+			if (t & (((uint64_t)1 << (TIMER_WHEEL_BITS * level)) - 1))
+			{
+				break;
+			}
+			cascade(level, (t >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+		}
+
+		// Move everything due now to the firing list first, so callbacks can
+		// schedule and cancel timers, this slot's included, while it is
+		// walked
+		uint32_t slot = t & (TIMER_WHEEL_SLOTS - 1);
+		while (_heads[slot] != NONE)
+		{
+			uint32_t index = _heads[slot];
+			unlink(index);
+			link(index, FIRING_LIST);
+		}
+
+		while (_heads[FIRING_LIST] != NONE)
+		{
+			uint32_t index = _heads[FIRING_LIST];
+			unlink(index);
+
+			auto callback = std::move(_nodes[index].callback);
+			release(index);
+			_pendingCount--;
+
+			callback();
+		}
+	}
+}
+
+void TimerWheel::insert(uint32_t index)
+{
+	auto& node = _nodes[index];
+	uint64_t delta = node.expiry - _currentTick;
+
+	// Lowest level that reaches far enough, in the slot for the expiry tick
+	uint32_t level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 &&
+		delta >= ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1))))
+	{
+		level++;
+	}
+	uint32_t slot = (node.expiry >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+
+	link(index, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+void TimerWheel::link(uint32_t index, uint32_t list)
+{
+	// Push to the front
+	auto& node = _nodes[index];
+	node.list = list;
+	node.prev = NONE;
+	node.next = _heads[list];
+	if (node.next != NONE)
+	{
+		_nodes[node.next].prev = index;
+	}
+	_heads[list] = index;
+}
+
+void TimerWheel::unlink(uint32_t index)
+{
+	auto& node = _nodes[index];
+	if (node.prev != NONE)
+	{
+		_nodes[node.prev].next = node.next;
+	}
+	else
+	{
+		_heads[node.list] = node.next;
+	}
+	if (node.next != NONE)
+	{
+		_nodes[node.next].prev = node.prev;
+	}
+	node.list = NONE;
+}
+
+void TimerWheel::release(uint32_t index)
+{
+	auto& node = _nodes[index];
+	node.callback = nullptr;
+	node.list = NONE;
+
+	// Outstanding handles no longer match. Generation 0 is never handed out.
+	if (++node.generation == 0)
+	{
+		node.generation = 1;
+	}
+	_freeNodes.push_back(index);
+}
+
+void TimerWheel::cascade(uint32_t level, uint32_t slot)
+{
+	uint32_t list = level * TIMER_WHEEL_SLOTS + slot;
+	uint32_t index = _heads[list];
+	_heads[list] = NONE;
+
+	while (index != NONE)
+	{
+		uint32_t next = _nodes[index].next;
+		insert(index);
+		index = next;
+	}
+}
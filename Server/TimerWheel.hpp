@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+#include <stdint.h>
+
+// Each level of the wheel has 2^TIMER_WHEEL_BITS slots, and each level's
+// slots cover as many ticks as the whole level below it
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+
+// Four levels of 64 slots reach 2^24 ticks ahead, a bit over two days at
+// 90 ticks per second. Anything later is clamped to that.
+#define TIMER_WHEEL_MAX_TICKS ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+/*
+** Refers to a scheduled timer. Stays safe to cancel after the timer has fired
+** or been cancelled, and even once its slot is reused for another timer.
+*/
+struct TimerHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;	// 0 never refers to a timer
+
+	bool isSet() { return generation != 0; };
+};
+
+/*
+** Hierarchical timer wheel, driven by tick number rather than the clock. Each
+** room has one, advanced once at the start of every tick, and every timer due
+** on that tick fires in one batch. Scheduling and cancelling are O(1), and
+** timers live in pooled nodes, so nothing is allocated once the pool has
+** grown to the number of timers pending at once.
+**
+** Timers due within TIMER_WHEEL_SLOTS ticks sit in the bottom level, one slot
+** per tick. Later ones sit in a coarser level, and move down a level each
+** time the level below wraps around to their slot.
+**
+** The room ticking on the current thread sets its wheel as the current one,
+** the same way it sets the GameClock, so entities can schedule timers from
+** anywhere without being handed the wheel.
+*/
+class TimerWheel
+{
+public:
+	// startTick is the last tick considered already fired
+	TimerWheel(uint64_t startTick = 0);
+	~TimerWheel() {};
+
+	// Calls f on the tick that is delayTicks after the current one. A delay
+	// of zero fires on the next tick.
+	TimerHandle schedule(uint64_t delayTicks, std::function<void()> f);
+
+	// Same as above, with the delay in milliseconds of game time, rounded up
+	// to whole ticks
+	TimerHandle scheduleMilliseconds(long milliseconds, std::function<void()> f);
+
+	// Stops a timer from firing. Returns false if it already fired or was
+	// cancelled. Safe to call from a timer callback.
+	bool cancel(TimerHandle handle);
+
+	// Whether the timer has yet to fire
+	bool isPending(TimerHandle handle);
+
+	// Fires every timer due up to and including tick, in order of tick
+	void advance(uint64_t tick);
+
+	// Last tick that has been fired
+	uint64_t getCurrentTick() { return _currentTick; };
+
+	// Timers waiting to fire
+	size_t size() { return _pendingCount; };
+
+	// Wheel of the room ticking on this thread
+	static TimerWheel * getCurrent() { return _current; };
+	static void setCurrent(TimerWheel * wheel) { _current = wheel; };
+
+private:
+	// Lists are doubly linked through node indices
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	// One list per slot per level, and one for timers being fired
+	static constexpr uint32_t LIST_COUNT = TIMER_WHEEL_SLOTS * TIMER_WHEEL_LEVELS + 1;
+	static constexpr uint32_t FIRING_LIST = LIST_COUNT - 1;
+
+	struct Node
+	{
+		uint64_t expiry;
+		std::function<void()> callback;
+		uint32_t generation;
+		uint32_t list;		// NONE while free
+		uint32_t prev;
+		uint32_t next;
+	};
+
+	// Puts a node in the list for its expiry
+	void insert(uint32_t index);
+
+	void link(uint32_t index, uint32_t list);
+	void unlink(uint32_t index);
+
+	// Returns a node to the pool, invalidating its handles
+	void release(uint32_t index);
+
+	// Moves every timer in a slot of a higher level down to where it belongs
+	// now
+	void cascade(uint32_t level, uint32_t slot);
+
+	std::vector<Node> _nodes;
+	std::vector<uint32_t> _freeNodes;
+
+	std::array<uint32_t, LIST_COUNT> _heads;
+
+	uint64_t _currentTick;
+	size_t _pendingCount;
+
+	static inline thread_local TimerWheel * _current = nullptr;
+};
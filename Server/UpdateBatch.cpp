@@ -0,0 +1,125 @@
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/memory.hpp>
+#include <unordered_set>
+#include <streambuf>
+#include <ostream>
+
+#include "UpdateBatch.hpp"
+
+/*
+** Output stream buffer that appends straight onto a vector, so serialized
+** data does not have to be copied back out of a stringstream.
+*/
+class VectorStreamBuf : public std::streambuf
+{
+public:
+	VectorStreamBuf(std::vector<char> & buffer) : _buffer(buffer) {};
+
+protected:
+	int_type overflow(int_type c) override
+	{
+		if (c != traits_type::eof())
+		{
+			_buffer.push_back((char)c);
+		}
+		return c;
+	}
+
+	std::streamsize xsputn(const char * s, std::streamsize n) override
+	{
+		_buffer.insert(_buffer.end(), s, s + n);
+		return n;
+	}
+
+private:
+	std::vector<char> & _buffer;
+};
+
+
+const UpdateBatch::Encoding & UpdateBatch::getEncoding(WireFormat format) const
+{
+	std::unique_lock<std::mutex> lock(_encodingMutex);
+
+	Encoding & encoding = _encodings[format];
+	if (encoding.isSerialized)
+	{
+		return encoding;
+	}
+
+	encoding.records.clear();
+	encoding.data.clear();
+
+	VectorStreamBuf streamBuf(encoding.data);
+	std::ostream os(&streamBuf);
+
+	// Each state gets its own archive so that it can be decoded on its own
+	for (auto& state : states)
+	{
+		uint32_t offset = (uint32_t)encoding.data.size();
+		if (format == WIRE_FORMAT_COMPACT)
+		{
+			CompactOutputArchive oarchive(os);
+			oarchive(state);
+		}
+		else
+		{
+			cereal::BinaryOutputArchive oarchive(os);
+			oarchive(state);
+		}
+
+		encoding.records.push_back({
+			state->id,
+			offset,
+			(uint32_t)encoding.data.size() - offset,
+			state->isDestroyed });
+	}
+
+	encoding.isSerialized = true;
+	return encoding;
+}
+
+
+void UpdateBatch::clear()
+{
+	std::unique_lock<std::mutex> lock(_encodingMutex);
+
+	states.clear();
+	for (auto& encoding : _encodings)
+	{
+		encoding.isSerialized = false;
+	}
+}
+
+
+std::shared_ptr<UpdateBatch> UpdateBatch::merge(
+		const UpdateBatch & older,
+		const UpdateBatch & newer,
+		size_t & coalescedCount)
+{
+	auto batch = std::make_shared<UpdateBatch>();
+	batch->states.reserve(older.states.size() + newer.states.size());
+
+	std::unordered_set<uint32_t> newerIds;
+	for (auto& state : newer.states)
+	{
+		newerIds.insert(state->id);
+	}
+
+	// Every update carries the full state of an entity, so older updates for
+	// the same entity can simply be dropped
+	coalescedCount = 0;
+	for (auto& state : older.states)
+	{
+		if (newerIds.count(state->id))
+		{
+			coalescedCount++;
+		}
+		else
+		{
+			batch->states.push_back(state);
+		}
+	}
+	batch->states.insert(batch->states.end(), newer.states.begin(), newer.states.end());
+
+	return batch;
+}
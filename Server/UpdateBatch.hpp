@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+#include "Shared/BaseState.hpp"
+#include "Shared/WireFormat.hpp"
+
+/*
+** A group of updates that go out to clients as a single snapshot packet. Each
+** state is serialized once per wire format, and the bytes are shared by every
+** session the batch is sent to. Sessions then delta-encode the records
+** against whatever their client has acknowledged; see SnapshotEncoder.
+*/
+struct UpdateBatch
+{
+	// Serialized state of one entity, stored in data
+	struct Record
+	{
+		uint32_t id;
+		uint32_t offset;
+		uint32_t size;
+		bool isDestroyed;
+	};
+
+	// States serialized in a single wire format
+	struct Encoding
+	{
+		// One record per state, and the serialized bytes they point into
+		std::vector<Record> records;
+		std::vector<char> data;
+		bool isSerialized = false;
+	};
+
+	// States in the batch, in the order they were queued. Must not change
+	// once the batch has been handed to a session.
+	std::vector<std::shared_ptr<BaseState>> states;
+
+	// Returns the states serialized in the given format, serializing them the
+	// first time a session asks for it. Safe to call from several threads.
+	const Encoding & getEncoding(WireFormat format) const;
+
+	// Empties the batch so it can be reused. Keeps whatever capacity the
+	// buffers already have.
+	void clear();
+
+	// Creates a batch holding the states of older that are not superseded by
+	// one in newer, followed by all of newer. Returns the number of states
+	// that were dropped from older in coalescedCount.
+	static std::shared_ptr<UpdateBatch> merge(
+			const UpdateBatch & older,
+			const UpdateBatch & newer,
+			size_t & coalescedCount);
+
+private:
+	mutable Encoding _encodings[WIRE_FORMAT_COUNT];
+	mutable std::mutex _encodingMutex;
+};
@@ -1,11 +1,20 @@
 #include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <iostream>
 
 #include "Shared/GameEvent.hpp"
-#include "GameServer.hpp"
+#include "RoomManager.hpp"
+#include "ServerBenchmark.hpp"
 
-static GameServer* server = nullptr;
+#ifndef _WIN32
+#include <signal.h>
+#include <thread>
+#endif
 
+static RoomManager* server = nullptr;
+
+#ifdef _WIN32
 // Callback for window close
 BOOL WINAPI CtrlHandler(DWORD fdwCtrlType)
 {
@@ -20,13 +29,49 @@ BOOL WINAPI CtrlHandler(DWORD fdwCtrlType)
 	}
 	return false;
 }
+#else
+// Waits for SIGINT/SIGTERM on its own thread, like the console handler on
+// Windows. shutdown() blocks until the main loop exits, so it cannot be
+// called from a regular signal handler on the main thread.
+void signalListener(sigset_t signals)
+{
+	int signal;
+	sigwait(&signals, &signal);
+
+	if (server)
+	{
+		server->shutdown();
+	}
+	exit(0);
+}
+#endif
 
 int main(int argc, char ** argv)
 {
+	// Headless benchmark: --benchmark [players] [ticks]
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		int playerCount = (argc > 2) ? std::atoi(argv[2]) : BENCHMARK_DEFAULT_PLAYERS;
+		int tickCount = (argc > 3) ? std::atoi(argv[3]) : BENCHMARK_DEFAULT_TICKS;
+		ServerBenchmark(std::max(playerCount, 1), std::max(tickCount, 1)).run();
+		return 0;
+	}
+
+#ifdef _WIN32
 	// Register callback for window close
 	SetConsoleCtrlHandler(CtrlHandler, TRUE);
+#else
+	// Block termination signals on every thread (they inherit the mask), and
+	// handle them on a dedicated one instead
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+	std::thread(signalListener, signals).detach();
+#endif
 
 	// Create and start server
-    server = new GameServer();
+    server = new RoomManager();
     server->start();
 }
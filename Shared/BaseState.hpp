@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "Shared/Common.hpp"	// GameEntity type enum
+#include "Shared/WireFormat.hpp"	// Compact archives, before any CEREAL_REGISTER_TYPE
 
 // Allow Cereal serialization of GLM 3-item vectors
 namespace cereal
@@ -65,23 +66,162 @@ struct BaseState
 	template<class Archive>
 	void serialize(Archive & archive)
 	{
-		archive(type,
-				id,
-				pos,
-				up,
-				forward,
-				scale,
-				width,
-				depth,
-				height,
-				colliderType,
-				transparency,
-				isDestroyed,
-				isStatic,
-				isSolid,
-				isVisible);
+		if constexpr (IsCompactArchive<Archive>::value)
+		{
+			if constexpr (Archive::is_saving::value)
+			{
+				saveCompact(archive);
+			}
+			else
+			{
+				loadCompact(archive);
+			}
+		}
+		else
+		{
+			archive(type,
+					id,
+					pos,
+					up,
+					forward,
+					scale,
+					width,
+					depth,
+					height,
+					colliderType,
+					transparency,
+					isDestroyed,
+					isStatic,
+					isSolid,
+					isVisible);
+		}
+	};
+
+	/*
+	** WIRE_FORMAT_COMPACT encoding. Positions and sizes are fixed-point, the
+	** orientation is a yaw angle whenever the object is upright, and a scale
+	** of one is left out entirely. Anything that does not fit falls back to
+	** full floats, so nothing is clamped.
+	*/
+	enum CompactFlags
+	{
+		COMPACT_DESTROYED = 1 << 0,
+		COMPACT_STATIC = 1 << 1,
+		COMPACT_SOLID = 1 << 2,
+		COMPACT_VISIBLE = 1 << 3,
+		COMPACT_YAW = 1 << 4,		// up is +Y and forward is a unit vector in XZ
+		COMPACT_UNIT_SCALE = 1 << 5,	// scale is (1, 1, 1)
+		COMPACT_FLOATS = 1 << 6		// pos or size is out of fixed-point range
 	};
 
+	template<class Archive>
+	void saveCompact(Archive & archive)
+	{
+		uint8_t flags = 0;
+		flags |= isDestroyed ? COMPACT_DESTROYED : 0;
+		flags |= isStatic ? COMPACT_STATIC : 0;
+		flags |= isSolid ? COMPACT_SOLID : 0;
+		flags |= isVisible ? COMPACT_VISIBLE : 0;
+
+		if (up == glm::vec3(0, 1, 0) && std::abs(forward.y) < 0.001f &&
+			std::abs(glm::length(forward) - 1.0f) < 0.001f)
+		{
+			flags |= COMPACT_YAW;
+		}
+		if (scale == glm::vec3(1, 1, 1))
+		{
+			flags |= COMPACT_UNIT_SCALE;
+		}
+		if (!isFixedRange(pos.x) || !isFixedRange(pos.y) || !isFixedRange(pos.z) ||
+			!isFixedRange(width) || !isFixedRange(depth) || !isFixedRange(height))
+		{
+			flags |= COMPACT_FLOATS;
+		}
+
+		archive((uint8_t)type, id, flags);
+
+		if (flags & COMPACT_FLOATS)
+		{
+			archive(pos, width, depth, height);
+		}
+		else
+		{
+			archive(toFixed(pos.x), toFixed(pos.y), toFixed(pos.z),
+					toFixed(width), toFixed(depth), toFixed(height));
+		}
+
+		if (flags & COMPACT_YAW)
+		{
+			archive(toCompactYaw(forward.x, forward.z));
+		}
+		else
+		{
+			archive(up, forward);
+		}
+
+		if (!(flags & COMPACT_UNIT_SCALE))
+		{
+			archive(scale);
+		}
+
+		archive((uint8_t)colliderType,
+				toCompactUnit(transparency));
+	}
+
+	template<class Archive>
+	void loadCompact(Archive & archive)
+	{
+		uint8_t compactType, flags;
+		archive(compactType, id, flags);
+		type = (EntityType)compactType;
+
+		isDestroyed = (flags & COMPACT_DESTROYED) != 0;
+		isStatic = (flags & COMPACT_STATIC) != 0;
+		isSolid = (flags & COMPACT_SOLID) != 0;
+		isVisible = (flags & COMPACT_VISIBLE) != 0;
+
+		if (flags & COMPACT_FLOATS)
+		{
+			archive(pos, width, depth, height);
+		}
+		else
+		{
+			int16_t x, y, z, fixedWidth, fixedDepth, fixedHeight;
+			archive(x, y, z, fixedWidth, fixedDepth, fixedHeight);
+			pos = glm::vec3(fromFixed(x), fromFixed(y), fromFixed(z));
+			width = fromFixed(fixedWidth);
+			depth = fromFixed(fixedDepth);
+			height = fromFixed(fixedHeight);
+		}
+
+		if (flags & COMPACT_YAW)
+		{
+			uint16_t compactYaw;
+			archive(compactYaw);
+			float yaw = fromCompactYaw(compactYaw);
+			up = glm::vec3(0, 1, 0);
+			forward = glm::vec3(std::sin(yaw), 0, std::cos(yaw));
+		}
+		else
+		{
+			archive(up, forward);
+		}
+
+		if (flags & COMPACT_UNIT_SCALE)
+		{
+			scale = glm::vec3(1, 1, 1);
+		}
+		else
+		{
+			archive(scale);
+		}
+
+		uint8_t compactColliderType, compactTransparency;
+		archive(compactColliderType, compactTransparency);
+		colliderType = (ColliderType)compactColliderType;
+		transparency = fromCompactUnit(compactTransparency);
+	}
+
 	bool getSolidity(BaseState* entity)
 	{
 		if (solidFunc == 0)
@@ -46,6 +46,42 @@ public:
 		_queue.pop();
 	};
 
+    /*
+    ** Non-blocking version of pop(). Returns false without touching item if
+    ** the queue is empty.
+    */
+	bool tryPop(T & item)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_queue.empty())
+		{
+			return false;
+		}
+		item = _queue.front();
+		_queue.pop();
+		return true;
+	};
+
+    /*
+    ** Removes every item for which pred returns true. The rest keep their
+    ** order.
+    */
+	template<typename Predicate>
+	void removeIf(Predicate pred)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::queue<T> kept;
+		while (!_queue.empty())
+		{
+			if (!pred(_queue.front()))
+			{
+				kept.push(std::move(_queue.front()));
+			}
+			_queue.pop();
+		}
+		_queue.swap(kept);
+	};
+
     /*
     ** Simple check to see if the queue is empty or not.
     */
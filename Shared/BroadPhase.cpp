@@ -0,0 +1,27 @@
+#include "Shared/Logger.hpp"
+#include "BroadPhase.hpp"
+#include "QuadTree.hpp"
+#include "UniformGrid.hpp"
+
+std::unique_ptr<BroadPhase> BroadPhase::create(
+	BroadPhaseType type,
+	BoundingBox boundary,
+	int cellsPerSide)
+{
+	switch (type)
+	{
+	case BROAD_PHASE_GRID:
+	{
+		if (cellsPerSide > 0)
+		{
+			return std::make_unique<UniformGrid>(boundary, cellsPerSide);
+		}
+		Logger::getInstance()->warn("No tile grid to build broad phase on, falling back to quadtree");
+		break;
+	}
+	case BROAD_PHASE_QUADTREE:
+		break;
+	}
+
+	return std::make_unique<QuadTree>(boundary);
+}
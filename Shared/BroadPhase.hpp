@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BaseState.hpp"
+
+// Available broad-phase structures
+enum BroadPhaseType
+{
+	BROAD_PHASE_QUADTREE,	// Adaptive quadtree; works for any level
+	BROAD_PHASE_GRID		// Buckets objects into the level's tile grid
+};
+
+#define DEFAULT_BROAD_PHASE BROAD_PHASE_GRID
+
+// Internal representation of a square, axis-aligned bounding box
+struct BoundingBox
+{
+	glm::vec2 pos;		// Center of box
+	double halfWidth;	// Half of width of box
+
+	bool containsPoint(glm::vec2 point)
+	{
+		return (
+			point.x >= (pos.x - halfWidth) &&
+			point.x <= (pos.x + halfWidth) &&
+			point.y >= (pos.y - halfWidth) &&
+			point.y <= (pos.y + halfWidth));
+	}
+
+	bool intersects(BoundingBox * bb)
+	{
+		return (
+			(bb->pos.x + bb->halfWidth) >= (pos.x - halfWidth) &&
+			(bb->pos.x - bb->halfWidth) <= (pos.x + halfWidth) &&
+			(bb->pos.y + bb->halfWidth) >= (pos.y - halfWidth) &&
+			(bb->pos.y - bb->halfWidth) <= (pos.y + halfWidth));
+	}
+
+	bool intersects(BaseState * state)
+	{
+		return (
+			(state->pos.x + state->width / 2) >= (pos.x - halfWidth) &&
+			(state->pos.x - state->width / 2) <= (pos.x + halfWidth) &&
+			(state->pos.z + state->depth / 2) >= (pos.y - halfWidth) &&
+			(state->pos.z - state->depth / 2) <= (pos.y + halfWidth));
+	}
+};
+
+/*
+** Interface over the structures used to find collision candidates on the XZ
+** plane. Implementations are meant to be kept between ticks: call update()
+** on every object each tick, then removeStale() to drop the ones that are
+** gone.
+**
+** Objects are identified by state ID. Their states are only dereferenced by
+** update() and query(), so entities that were deleted since the last tick
+** are safe to leave in the structure until removeStale() is called.
+*/
+class BroadPhase
+{
+public:
+	// Creates a broad phase covering boundary. cellsPerSide is the width of
+	// the level's tile grid, and is ignored by structures that do not use it.
+	static std::unique_ptr<BroadPhase> create(
+		BroadPhaseType type,
+		BoundingBox boundary,
+		int cellsPerSide);
+
+	virtual ~BroadPhase() {};
+
+	// Adds an object, or re-inserts it if it moved or resized since it was
+	// last seen. Either way the object counts as present for removeStale().
+	virtual void update(BaseState * state) = 0;
+
+	// Removes an object, if it is present
+	virtual void remove(uint32_t id) = 0;
+
+	// Removes every object that has not been passed to update() since the
+	// last call to removeStale()
+	virtual void removeStale() = 0;
+
+	// Removes every object, keeping storage around
+	virtual void clear() = 0;
+
+	// Appends every object that might overlap state to results. Each object
+	// is appended at most once.
+	virtual void query(BaseState * state, std::vector<BaseState*> & results) = 0;
+
+	// Number of objects present
+	virtual size_t size() = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+
+#include "Shared/Common.hpp"
+
+/*
+** Simulation clock for game logic on the server, usable anywhere a
+** std::chrono clock is. Time is the number of ticks the current room has run
+** times the length of a tick, so it only moves when a tick starts and always
+** by exactly one tick. Timers, cooldowns and countdowns measured against it
+** come out the same however late or bunched up ticks actually run.
+**
+** Every room counts its own ticks, and rooms tick on different threads, so
+** the room sets the count for its thread with setTick() before running any
+** game logic.
+*/
+struct GameClock
+{
+	typedef std::chrono::nanoseconds duration;
+	typedef duration::rep rep;
+	typedef duration::period period;
+	typedef std::chrono::time_point<GameClock> time_point;
+	static constexpr bool is_steady = true;
+
+	// Start of the current tick
+	static time_point now()
+	{
+		return time_point(ticksToDuration(_currentTick));
+	};
+
+	// Ticks the current room has run, counting the one in progress
+	static uint64_t getTick()
+	{
+		return _currentTick;
+	};
+
+	static void setTick(uint64_t tick)
+	{
+		_currentTick = tick;
+	};
+
+	// Exact length of a number of ticks, without rounding error piling up
+	static duration ticksToDuration(uint64_t ticks)
+	{
+		return std::chrono::seconds(ticks / TICKS_PER_SEC) +
+			duration((ticks % TICKS_PER_SEC) * std::nano::den / TICKS_PER_SEC);
+	};
+
+private:
+	static inline thread_local uint64_t _currentTick = 0;
+};
@@ -5,6 +5,7 @@
 #include <string>
 #include <cereal/types/vector.hpp>
 #include "Shared/Logger.hpp"
+#include "Shared/WireFormat.hpp"
 
 // Allow Cereal serialization of GLM 2-item vectors
 namespace cereal
@@ -42,7 +43,9 @@ enum EventType
 	EVENT_PLAYER_LAUNCH_END,
 	EVENT_PLAYER_PLACE_TRAP,
 	EVENT_CLIENT_READY,	// Game is fully rendered on the client
-	EVENT_REQUEST_RESEND	// Request a resend of state from server
+	EVENT_REQUEST_RESEND,	// Request a resend of state from server
+	EVENT_SNAPSHOT_ACK,	// Snapshot packets received; handled by the network layer
+	EVENT_SET_WIRE_FORMAT	// Format to send states in; handled by the network layer
     // TODO: more event types here
 };
 // GamePad Indexes
@@ -66,6 +69,14 @@ struct GameEvent
 	// knows about
 	std::vector<uint32_t> entityList;
 
+	// Used only for SNAPSHOT_ACK. Sequence number of the last snapshot packet
+	// the client received.
+	uint32_t sequence;
+
+	// Used only for SET_WIRE_FORMAT. One of the formats offered by the
+	// server when connecting.
+	WireFormat wireFormat;
+
 	//TODO: add more elements as necessary
 
 	// Serialization for Cereal
@@ -76,11 +87,13 @@ struct GameEvent
 			type,
 			playerId,
 			playerName,
-			direction);
+			direction,
+			sequence,
+			wireFormat);
 	}
 
 	void print()
 	{
-		Logger::getInstance()->debug("[playerEvent type: " + std::to_string(type) + " playerID: " + std::to_string(playerId) + " playerName: " + playerName + "]");
+		LOG_DEBUG("[playerEvent type: " + std::to_string(type) + " playerID: " + std::to_string(playerId) + " playerName: " + playerName + "]");
 	}
 };
@@ -8,6 +8,7 @@
 #include <chrono>
 
 #include "Shared/BaseState.hpp"
+#include "Shared/GameClock.hpp"
 
 struct GameState : public BaseState
 {
@@ -52,11 +53,12 @@ struct GameState : public BaseState
 			readyPlayers);
 	}
 
-	// Some items used by server, not serialized for the client
-	std::chrono::time_point<std::chrono::steady_clock> _loadedStart;
-	std::chrono::time_point<std::chrono::steady_clock> _pregameStart;
-	std::chrono::time_point<std::chrono::steady_clock> _gameStart;
-	std::chrono::time_point<std::chrono::steady_clock> _endgameStart;
+	// Some items used by server, not serialized for the client. Measured in
+	// game time.
+	GameClock::time_point _loadedStart;
+	GameClock::time_point _pregameStart;
+	GameClock::time_point _gameStart;
+	GameClock::time_point _endgameStart;
 	std::chrono::nanoseconds _gameDuration;
 };
 
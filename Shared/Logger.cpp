@@ -1,12 +1,201 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 #include "Logger.hpp"
+#ifdef _WIN32
 #include "windows.h"
+#endif
 
-Logger * Logger::_instance = NULL;
 std::mutex Logger::_mutex;
 std::ostream* Logger::_os;
 
+struct Logger::RingOwner
+{
+	Ring * ring = nullptr;
+
+	~RingOwner()
+	{
+		if (ring)
+		{
+			ring->isRetired = true;
+		}
+	}
+};
+
+Logger::Logger()
+{
+	// Set desired output stream here
+	_os = &std::cerr;
+
+	_sequence = 0;
+	_dropped = 0;
+
+	std::thread(&Logger::writeLoop, this).detach();
+
+	// Write out what is left when the program exits
+	std::atexit([]()
+		{
+			Logger::getInstance()->flush();
+		});
+}
+
+Logger::Ring * Logger::getRing()
+{
+	static thread_local RingOwner owner;
+	if (!owner.ring)
+	{
+		auto ring = std::make_unique<Ring>();
+		owner.ring = ring.get();
+
+		std::unique_lock<std::mutex> lock(_ringsMutex);
+		_rings.push_back(std::move(ring));
+	}
+	return owner.ring;
+}
+
+void Logger::log(uint8_t level, std::string_view message)
+{
+	Ring * ring = getRing();
+
+	// Messages too long for a quarter of the ring are cut short
+	size_t count = std::max<size_t>(1, (message.size() + LOG_RECORD_TEXT - 1) / LOG_RECORD_TEXT);
+	count = std::min<size_t>(count, LOG_RING_SIZE / 4);
+
+	size_t tail = ring->tail.load(std::memory_order_relaxed);
+	size_t head = ring->head.load(std::memory_order_acquire);
+	if (tail - head + count > LOG_RING_SIZE)
+	{
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	uint64_t sequence = _sequence.fetch_add(1, std::memory_order_relaxed);
+	auto time = std::chrono::system_clock::now();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Record & record = ring->records[(tail + i) % LOG_RING_SIZE];
+		size_t length = std::min<size_t>(message.size(), LOG_RECORD_TEXT);
+
+		record.sequence = sequence;
+		record.time = time;
+		record.level = level;
+		record.isContinued = (i + 1 < count);
+		record.part = (uint16_t)i;
+		record.length = (uint16_t)length;
+		std::memcpy(record.text, message.data(), length);
+
+		message.remove_prefix(length);
+	}
+
+	// Publish
+	ring->tail.store(tail + count, std::memory_order_release);
+}
+
+void Logger::writeLoop()
+{
+	while (true)
+	{
+		std::this_thread::sleep_for(LOG_WRITE_INTERVAL);
+		flush();
+	}
+}
+
+void Logger::flush()
+{
+	std::unique_lock<std::mutex> writeLock(_writeMutex);
+
+	// Take the rings to read, freeing those of exited threads once empty.
+	// A retired ring gets no more records, so one pass empties it.
+	_writeRings.clear();
+	std::unique_lock<std::mutex> ringsLock(_ringsMutex);
+	_rings.erase(std::remove_if(_rings.begin(), _rings.end(),
+		[](std::unique_ptr<Ring> & ring)
+		{
+			return ring->isRetired &&
+				ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+		}), _rings.end());
+	for (auto& ring : _rings)
+	{
+		_writeRings.push_back(ring.get());
+	}
+	ringsLock.unlock();
+
+	// Copy out every published record
+	_writeRecords.clear();
+	for (auto ring : _writeRings)
+	{
+		size_t head = ring->head.load(std::memory_order_relaxed);
+		size_t tail = ring->tail.load(std::memory_order_acquire);
+		for (size_t i = head; i != tail; i++)
+		{
+			_writeRecords.push_back(ring->records[i % LOG_RING_SIZE]);
+		}
+		ring->head.store(tail, std::memory_order_release);
+	}
+
+	uint64_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+	if (_writeRecords.empty() && !dropped)
+	{
+		return;
+	}
+
+	// Interleave threads in the order messages were logged
+	std::sort(_writeRecords.begin(), _writeRecords.end(),
+		[](const Record & a, const Record & b)
+		{
+			if (a.sequence != b.sequence)
+				return a.sequence < b.sequence;
+			else
+				return a.part < b.part;
+		});
+
+	static const char * severities[] = { "DEBUG", "INFO", "WARNING", "ERROR", "FATAL" };
+
+	_writeBuffer.clear();
+	bool isStart = true;
+	for (auto& record : _writeRecords)
+	{
+		if (isStart)
+		{
+			_writeBuffer += "[" + formatTime(record.time) + "][" + severities[record.level] + "] ";
+		}
+		_writeBuffer.append(record.text, record.length);
+		if (!record.isContinued)
+		{
+			_writeBuffer += '\n';
+		}
+		isStart = !record.isContinued;
+	}
+
+	if (dropped)
+	{
+		_writeBuffer += "[" + formatTime(std::chrono::system_clock::now()) + "][WARNING] " +
+			std::to_string(dropped) + " log messages dropped\n";
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	clearLine();
+	*_os << _writeBuffer << std::flush;
+}
+
+std::string Logger::formatTime(std::chrono::system_clock::time_point time)
+{
+	std::time_t curtime = std::chrono::system_clock::to_time_t(time);
+	char buf[26];
+#ifdef _WIN32
+	ctime_s(buf, sizeof(buf), &curtime);
+#else
+	ctime_r(&curtime, buf);
+#endif
+	buf[24] = 0;
+	return std::string(buf);
+}
+
 void Logger::clearLine()
 {
+#ifdef _WIN32
 	CONSOLE_SCREEN_BUFFER_INFO csbi;
 	memset(&csbi, 0, sizeof(CONSOLE_SCREEN_BUFFER_INFO));
 	GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
@@ -15,4 +204,8 @@ void Logger::clearLine()
 	{
 		*_os << '\r' << std::string(numColumns, ' ') << '\r';
 	}
+#else
+	// ANSI escape: return to start of line and erase it
+	*_os << "\r\33[2K";
+#endif
 }
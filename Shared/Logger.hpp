@@ -2,135 +2,172 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <mutex>
+#include <atomic>
 #include <ctime>
+#include <memory>
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <cmath>
 #include "Common.hpp"
 
+// Severities, least severe first
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_FATAL 4
+
+// Least severe level compiled in. Debug logs only exist in debug builds.
+#ifndef LOG_LEVEL
+#ifdef _DEBUG
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+// Records each thread can have waiting to be written. Past that, messages
+// are dropped rather than making the thread wait.
+#define LOG_RING_SIZE 256
+
+// Message bytes per record. Longer messages take several records.
+#define LOG_RECORD_TEXT 104
+
+// How often the writer thread picks up new records
+#define LOG_WRITE_INTERVAL std::chrono::milliseconds(10)
+
+// Logs at debug level. Unlike calling debug(), the message is not even built
+// unless debug logs are compiled in.
+#define LOG_DEBUG(message) \
+	do { if constexpr (LOG_LEVEL <= LOG_LEVEL_DEBUG) { Logger::getInstance()->debug(message); } } while (0)
+
+/*
+** Asynchronous logger. Logging copies the message into fixed-size records in
+** a ring owned by the calling thread, with no locks and no allocation, and a
+** writer thread formats and prints them every LOG_WRITE_INTERVAL. A thread
+** that logs faster than that drops messages instead of blocking, and the
+** writer reports how many were dropped.
+**
+** Messages from one thread come out in the order they were logged. Anything
+** still waiting is written out by fatal(), flush() and at exit.
+*/
 class Logger
 {
 public:
-    static Logger * getInstance()
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        if (_instance == NULL)
-        {
-            _instance = new Logger();
-        }
-        return _instance;
-    }
-
-    // Log with severity "DEBUG"
-    void debug(std::string str)
-    {
-        printFormattedMessage("DEBUG", str);
-    }
-
-    // Log with severity "INFO"
-    void info(std::string str)
-    {
-        printFormattedMessage("INFO", str);
-    }
-
-    // Log with severity "WARNING"
-    void warn(std::string str)
-    {
-        printFormattedMessage("WARNING", str);
-    }
-
-    // Log with severity "ERROR"
-    void error(std::string str)
-    {
-        printFormattedMessage("ERROR", str);
-    }
-
-    // Log with severity "FATAL"
-    void fatal(std::string str)
-    {
-        printFormattedMessage("FATAL", str);
-    }
-
-	// Init utilization monitor thread
-	void initUtilizationMonitor()
+	static Logger * getInstance()
 	{
-		_utilizationThread = std::thread(
-			&Logger::printUtilization,
-			this);
+		// Never destroyed, so it outlives every thread that logs
+		static Logger * instance = new Logger();
+		return instance;
 	}
 
-	// Store duration of single game loop
-	void storeLoopDuration(long long duration)
+	// Log with severity "DEBUG"
+	void debug(std::string_view str)
 	{
-		std::unique_lock<std::mutex> lock(_durationMutex);
-		_loopDurations.push_back(duration);
+		if constexpr (LOG_LEVEL <= LOG_LEVEL_DEBUG)
+		{
+			log(LOG_LEVEL_DEBUG, str);
+		}
 	}
 
-private:
-    static Logger * _instance;
-    static std::mutex _mutex;
-    static std::ostream* _os;
-
-	// List of loop durations in microseconds, used by server only
-	std::vector<long long> _loopDurations;
-	std::mutex _durationMutex;
-
-	// Thread to print utilization %, used by server only
-	std::thread _utilizationThread;
-
-    Logger()
-    {
-        // Set desired output stream here
-        _os = &std::cerr;
-    };
-
-    // Returns a formatted time string
-    std::string getCurTime()
-    {
-        std::time_t curtime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-        char buf[26];
-        ctime_s(buf, sizeof(buf), &curtime);
-        buf[24] = 0; 
-        return std::string(buf);
-    }
-
-    // Prints a formatted log message
-    void printFormattedMessage(std::string severity, std::string message)
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-		clearLine();
-        *_os << "[" << getCurTime() << "][" << severity << "] " << message << std::endl;
-    }
+	// Log with severity "INFO"
+	void info(std::string_view str)
+	{
+		if constexpr (LOG_LEVEL <= LOG_LEVEL_INFO)
+		{
+			log(LOG_LEVEL_INFO, str);
+		}
+	}
 
-	// Clears the current line
-	void clearLine();
+	// Log with severity "WARNING"
+	void warn(std::string_view str)
+	{
+		if constexpr (LOG_LEVEL <= LOG_LEVEL_WARNING)
+		{
+			log(LOG_LEVEL_WARNING, str);
+		}
+	}
 
-	// Prints server utilization every few seconds; runs in separate thread
-	void printUtilization()
+	// Log with severity "ERROR"
+	void error(std::string_view str)
 	{
-		while (true)
+		if constexpr (LOG_LEVEL <= LOG_LEVEL_ERROR)
 		{
-			std::this_thread::sleep_for(std::chrono::seconds(2));
-
-			// Take average vector value
-			long long totalUsage = 0;
-			std::unique_lock<std::mutex> lock(_durationMutex);
-			int durationCount = (int)_loopDurations.size();
-			for (auto& duration : _loopDurations)
-			{
-				totalUsage += duration;
-			}
-			_loopDurations.clear();
-			lock.unlock();
-
-			// Acquire stderr lock and print utilization
-			std::unique_lock<std::mutex> stderrLock(_mutex);
-
-			// Clear current line first
-			clearLine();
-			*_os << "Utilization: " << (int)((float)(totalUsage / durationCount) / (std::pow(10, 6) / TICKS_PER_SEC) * 100) << "%";
+			log(LOG_LEVEL_ERROR, str);
 		}
 	}
-};
 
+	// Log with severity "FATAL". Written out before returning, since the
+	// caller is usually about to exit.
+	void fatal(std::string_view str)
+	{
+		log(LOG_LEVEL_FATAL, str);
+		flush();
+	}
+
+	// Writes out everything logged so far, on the calling thread
+	void flush();
+
+private:
+	// Guards the output stream
+	static std::mutex _mutex;
+	static std::ostream* _os;
+
+	// Part of a message. All records of a message share its sequence number.
+	struct Record
+	{
+		uint64_t sequence;
+		std::chrono::system_clock::time_point time;
+		uint8_t level;
+		bool isContinued;	// More of the message follows in the next record
+		uint16_t part;		// Which record of the message this is
+		uint16_t length;
+		char text[LOG_RECORD_TEXT];
+	};
+
+	// Records from one thread. Only that thread moves the tail, and only the
+	// writer moves the head.
+	struct Ring
+	{
+		Record records[LOG_RING_SIZE];
+		std::atomic<size_t> head{ 0 };
+		std::atomic<size_t> tail{ 0 };
+		std::atomic<bool> isRetired{ false };	// Thread has exited
+	};
+
+	// Retires a thread's ring when the thread exits
+	struct RingOwner;
+
+	// Rings of every thread that has logged, freed once retired and empty
+	std::vector<std::unique_ptr<Ring>> _rings;
+	std::mutex _ringsMutex;
+
+	std::atomic<uint64_t> _sequence;
+	std::atomic<uint64_t> _dropped;
+
+	// Only one thread writes at a time. Buffers are kept between writes.
+	std::mutex _writeMutex;
+	std::vector<Ring*> _writeRings;
+	std::vector<Record> _writeRecords;
+	std::string _writeBuffer;
+
+	Logger();
+
+	// Copies a message into this thread's ring, or drops it if full
+	void log(uint8_t level, std::string_view message);
+
+	// This thread's ring, created the first time it logs
+	Ring * getRing();
+
+	// Writes out records every LOG_WRITE_INTERVAL; runs in separate thread
+	void writeLoop();
+
+	// Formats a record's timestamp
+	std::string formatTime(std::chrono::system_clock::time_point time);
+
+	// Clears the current line
+	void clearLine();
+};
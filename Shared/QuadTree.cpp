@@ -1,35 +1,33 @@
 #include "Shared/Logger.hpp"
 #include "QuadTree.hpp"
 
-QuadTree::~QuadTree()
+QuadTree::QuadTree(BoundingBox boundary)
 {
-	_objects.clear();
-	if (_nw) delete _nw;
-	if (_ne) delete _ne;
-	if (_sw) delete _sw;
-	if (_se) delete _se;
-	delete _quads;
+	_nodes.push_back(Node());
+	_nodes[0].boundary = boundary;
+	_nodes[0].parent = -1;
+	_nodes[0].firstChild = -1;
+	_nodes[0].depth = 0;
+	_stamp = 0;
 }
 
-int QuadTree::getIndex(BaseState * state)
+int QuadTree::getIndex(int node, int object)
 {
 	int index = -1;
-	// extra room (must be more than velocity of player)
-	double objBottom = (state->pos.z - state->depth / 2);
-	double objTop = (state->pos.z + state->depth / 2);
-	double objLeft = (state->pos.x - state->width / 2);
-	double objRight = (state->pos.x + state->width / 2);
-	double quadBottom = _boundary.pos.y - _boundary.halfWidth;
-	double quadHorizMid = _boundary.pos.y;
-	double quadTop = _boundary.pos.y + _boundary.halfWidth;
-	double quadLeft = _boundary.pos.x - _boundary.halfWidth;
-	double quadVertMid = _boundary.pos.x;
-	double quadRight = _boundary.pos.x + _boundary.halfWidth;
-
-	bool inBottomQuad = (objBottom > quadBottom) && (objTop < quadHorizMid);
-	bool inTopQuad = (objBottom > quadHorizMid) && (objTop < quadTop);
-	bool inLeftQuad = (objLeft > quadLeft) && (objRight < quadVertMid);
-	bool inRightQuad = (objLeft > quadVertMid) && (objRight < quadRight);
+	Object & obj = _objects[object];
+	BoundingBox & boundary = _nodes[node].boundary;
+
+	double quadBottom = boundary.pos.y - boundary.halfWidth;
+	double quadHorizMid = boundary.pos.y;
+	double quadTop = boundary.pos.y + boundary.halfWidth;
+	double quadLeft = boundary.pos.x - boundary.halfWidth;
+	double quadVertMid = boundary.pos.x;
+	double quadRight = boundary.pos.x + boundary.halfWidth;
+
+	bool inBottomQuad = (obj.minZ > quadBottom) && (obj.maxZ < quadHorizMid);
+	bool inTopQuad = (obj.minZ > quadHorizMid) && (obj.maxZ < quadTop);
+	bool inLeftQuad = (obj.minX > quadLeft) && (obj.maxX < quadVertMid);
+	bool inRightQuad = (obj.minX > quadVertMid) && (obj.maxX < quadRight);
 
 	if (inLeftQuad)
 	{
@@ -57,87 +55,257 @@ int QuadTree::getIndex(BaseState * state)
 	return index;
 }
 
-void QuadTree::insert(BaseState * state)
+void QuadTree::update(BaseState * state)
 {
-	if (_nw)
+	float minX = state->pos.x - state->width / 2;
+	float maxX = state->pos.x + state->width / 2;
+	float minZ = state->pos.z - state->depth / 2;
+	float maxZ = state->pos.z + state->depth / 2;
+
+	auto result = _objectIndex.find(state->id);
+	if (result != _objectIndex.end())
 	{
-		int index = getIndex(state);
-		if (index != -1)
+		Object & obj = _objects[result->second];
+		obj.state = state;
+		obj.stamp = _stamp;
+		_nodes[obj.node].states[obj.slot] = state;
+
+		// Most objects never move
+		if (obj.minX == minX && obj.maxX == maxX && obj.minZ == minZ && obj.maxZ == maxZ)
 		{
-			_quads[index]->insert(state);
 			return;
 		}
+
+		// Empty nodes are left alone, since the object usually lands nearby
+		unlink(result->second);
+		obj.minX = minX;
+		obj.maxX = maxX;
+		obj.minZ = minZ;
+		obj.maxZ = maxZ;
+		insertObject(0, result->second);
+		return;
+	}
+
+	int object;
+	if (!_freeObjects.empty())
+	{
+		object = _freeObjects.back();
+		_freeObjects.pop_back();
+	}
+	else
+	{
+		object = (int)_objects.size();
+		_objects.push_back(Object());
 	}
-	
-	_objects.push_back(state);
 
-	if (_objects.size() > QUADTREE_NODE_CAPACITY)
+	_objects[object] = { state, state->id, minX, maxX, minZ, maxZ, -1, -1, _stamp };
+	_objectIndex.insert({ state->id, object });
+	insertObject(0, object);
+}
+
+void QuadTree::insertObject(int node, int object)
+{
+	// Walk down as far as the object fits entirely inside a quadrant
+	while (_nodes[node].firstChild != -1)
 	{
-		if (!_nw)
+		int index = getIndex(node, object);
+		if (index == -1)
 		{
-			divide();
+			break;
 		}
-		int i = 0;
-		while (i < _objects.size())
+		node = _nodes[node].firstChild + index;
+	}
+
+	link(object, node);
+
+	if (_nodes[node].firstChild == -1 &&
+		_nodes[node].objects.size() > QUADTREE_NODE_CAPACITY &&
+		_nodes[node].depth < QUADTREE_MAX_DEPTH)
+	{
+		divide(node);
+
+		// Push down whatever fits in the new children. Going backwards, the
+		// object swapped into a removed slot has already been looked at.
+		for (int i = (int)_nodes[node].objects.size() - 1; i >= 0; i--)
 		{
-			int index = getIndex(_objects[i]);
+			int current = _nodes[node].objects[i];
+			int index = getIndex(node, current);
 			if (index != -1)
 			{
-				_quads[index]->insert(_objects[i]);
-				_objects.erase(_objects.begin() + i);
+				unlink(current);
+				insertObject(_nodes[node].firstChild + index, current);
 			}
-			else
+		}
+	}
+}
+
+void QuadTree::link(int object, int node)
+{
+	Object & obj = _objects[object];
+	obj.node = node;
+	obj.slot = (int)_nodes[node].objects.size();
+	_nodes[node].objects.push_back(object);
+	_nodes[node].states.push_back(obj.state);
+}
+
+void QuadTree::unlink(int object)
+{
+	Object & obj = _objects[object];
+	Node & node = _nodes[obj.node];
+
+	// Move the last object into the freed slot
+	int last = node.objects.back();
+	node.objects[obj.slot] = last;
+	node.states[obj.slot] = node.states.back();
+	_objects[last].slot = obj.slot;
+	node.objects.pop_back();
+	node.states.pop_back();
+
+	obj.node = obj.slot = -1;
+}
+
+void QuadTree::divide(int node)
+{
+	int firstChild;
+	if (!_freeNodes.empty())
+	{
+		firstChild = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	else
+	{
+		firstChild = (int)_nodes.size();
+		_nodes.resize(_nodes.size() + 4);
+	}
+
+	// Same order as getIndex(): NE, NW, SW, SE
+	BoundingBox boundary = _nodes[node].boundary;
+	double halfWidth = boundary.halfWidth / 2;
+	glm::vec2 offsets[4] = {
+		glm::vec2(halfWidth, halfWidth),
+		glm::vec2(-halfWidth, halfWidth),
+		glm::vec2(-halfWidth, -halfWidth),
+		glm::vec2(halfWidth, -halfWidth) };
+
+	for (int i = 0; i < 4; i++)
+	{
+		BoundingBox childBoundary = BoundingBox();
+		childBoundary.pos = boundary.pos + offsets[i];
+		childBoundary.halfWidth = halfWidth;
+
+		// Recycled nodes keep the capacity of their arrays
+		Node & child = _nodes[firstChild + i];
+		child.boundary = childBoundary;
+		child.parent = node;
+		child.firstChild = -1;
+		child.depth = _nodes[node].depth + 1;
+	}
+
+	_nodes[node].firstChild = firstChild;
+}
+
+void QuadTree::collapse(int node)
+{
+	while (node != -1)
+	{
+		int firstChild = _nodes[node].firstChild;
+		if (firstChild == -1)
+		{
+			node = _nodes[node].parent;
+			continue;
+		}
+
+		for (int i = 0; i < 4; i++)
+		{
+			if (_nodes[firstChild + i].firstChild != -1 ||
+				!_nodes[firstChild + i].objects.empty())
 			{
-				i++;
+				return;
 			}
 		}
+
+		_freeNodes.push_back(firstChild);
+		_nodes[node].firstChild = -1;
+		node = _nodes[node].parent;
 	}
 }
 
-void QuadTree::divide()
+void QuadTree::removeObject(int object)
 {
-	BoundingBox nwBoundary = BoundingBox();
-	BoundingBox neBoundary = BoundingBox();
-	BoundingBox swBoundary = BoundingBox();
-	BoundingBox seBoundary = BoundingBox();
-	nwBoundary.pos = glm::vec2(_boundary.pos.x - (_boundary.halfWidth / 2), _boundary.pos.y + (_boundary.halfWidth / 2));
-	neBoundary.pos = glm::vec2(_boundary.pos.x + (_boundary.halfWidth / 2), _boundary.pos.y + (_boundary.halfWidth / 2));
-	swBoundary.pos = glm::vec2(_boundary.pos.x - (_boundary.halfWidth / 2), _boundary.pos.y - (_boundary.halfWidth / 2));
-	seBoundary.pos = glm::vec2(_boundary.pos.x + (_boundary.halfWidth / 2), _boundary.pos.y - (_boundary.halfWidth / 2));
-	nwBoundary.halfWidth = _boundary.halfWidth / 2;
-	neBoundary.halfWidth = _boundary.halfWidth / 2;
-	swBoundary.halfWidth = _boundary.halfWidth / 2;
-	seBoundary.halfWidth = _boundary.halfWidth / 2;
-
-	_nw = new QuadTree(nwBoundary);
-	_ne = new QuadTree(neBoundary);
-	_sw = new QuadTree(swBoundary);
-	_se = new QuadTree(seBoundary);
-
-	_quads[0] = _ne;
-	_quads[1] = _nw;
-	_quads[2] = _sw;
-	_quads[3] = _se;
+	int node = _objects[object].node;
+	unlink(object);
+	_objectIndex.erase(_objects[object].id);
+	_objects[object].state = nullptr;
+	_freeObjects.push_back(object);
+	collapse(node);
 }
 
-std::vector<BaseState*> QuadTree::query(BaseState * state)
+void QuadTree::remove(uint32_t id)
 {
-	std::vector<BaseState*> objectsInRange;
-	for (int i = 0; i < 4; i++)
+	auto result = _objectIndex.find(id);
+	if (result != _objectIndex.end())
+	{
+		removeObject(result->second);
+	}
+}
+
+void QuadTree::removeStale()
+{
+	_staleIds.clear();
+	for (auto& objectPair : _objectIndex)
 	{
-		if (_quads[i] && _quads[i]->intersects(state))
+		if (_objects[objectPair.second].stamp != _stamp)
 		{
-			std::vector<BaseState*> subQuadObjects;
-			subQuadObjects = _quads[i]->query(state);
-			objectsInRange.insert(objectsInRange.end(), subQuadObjects.begin(), subQuadObjects.end());
+			_staleIds.push_back(objectPair.first);
 		}
 	}
 
-	objectsInRange.insert(objectsInRange.end(), _objects.begin(), _objects.end());
-	return objectsInRange;
+	for (auto& id : _staleIds)
+	{
+		remove(id);
+	}
+
+	_stamp++;
+}
+
+void QuadTree::clear()
+{
+	_nodes.resize(1);
+	_nodes[0].firstChild = -1;
+	_nodes[0].objects.clear();
+	_nodes[0].states.clear();
+	_freeNodes.clear();
+	_objects.clear();
+	_freeObjects.clear();
+	_objectIndex.clear();
+}
+
+void QuadTree::query(BaseState * state, std::vector<BaseState*> & results)
+{
+	// Depth-first, so at most three siblings wait at each level
+	int stack[3 * QUADTREE_MAX_DEPTH + 4];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize)
+	{
+		Node & node = _nodes[stack[--stackSize]];
+		results.insert(results.end(), node.states.begin(), node.states.end());
+
+		if (node.firstChild != -1)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				if (_nodes[node.firstChild + i].boundary.intersects(state))
+				{
+					stack[stackSize++] = node.firstChild + i;
+				}
+			}
+		}
+	}
 }
 
 bool QuadTree::intersects(BaseState * state)
 {
-	return _boundary.intersects(state);
-}
\ No newline at end of file
+	return _nodes[0].boundary.intersects(state);
+}
@@ -1,77 +1,110 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
-#include "BaseState.hpp"
+#include "BroadPhase.hpp"
 
 #define QUADTREE_NODE_CAPACITY 4
 
+// Nodes this deep are never split, so a pile of objects at a single spot
+// cannot subdivide forever
+#define QUADTREE_MAX_DEPTH 10
+
 // "borrowed" from https://gamedevelopment.tutsplus.com/tutorials/quick-tip-use-quadtrees-to-detect-likely-collisions-in-2d-space--gamedev-374
 
-// Internal representation of a square, axis-aligned bounding box
-struct BoundingBox
+/*
+** Quadtree over the XZ plane, kept in flat arrays. Nodes live in one vector
+** with the four children of a node stored next to each other, and each node
+** keeps its objects' states in a contiguous array that queries copy out in
+** one go. Freed nodes and objects are recycled along with their capacity, so
+** once the tree has grown to fit the level, moving things around does not
+** allocate.
+**
+** Only objects that moved since they were last updated are re-inserted.
+*/
+class QuadTree : public BroadPhase
 {
-	glm::vec2 pos;		// Center of box
-	double halfWidth;	// Half of width of box
+public:
+	QuadTree(BoundingBox boundary);
 
-	bool containsPoint(glm::vec2 point)
-	{
-		return (
-			point.x >= (pos.x - halfWidth) &&
-			point.x <= (pos.x + halfWidth) &&
-			point.y >= (pos.y - halfWidth) &&
-			point.y <= (pos.y + halfWidth));
-	}
-
-	bool intersects(BoundingBox * bb)
-	{
-		return (
-			(bb->pos.x + bb->halfWidth) >= (pos.x - halfWidth) &&
-			(bb->pos.x - bb->halfWidth) <= (pos.x + halfWidth) &&
-			(bb->pos.y + bb->halfWidth) >= (pos.y - halfWidth) &&
-			(bb->pos.y - bb->halfWidth) <= (pos.y + halfWidth));
-	}
-
-	bool intersects(BaseState * state)
-	{
-		return (
-			(state->pos.x + state->width / 2) >= (pos.x - halfWidth) &&
-			(state->pos.x - state->width / 2) <= (pos.x + halfWidth) &&
-			(state->pos.z + state->depth / 2) >= (pos.y - halfWidth) &&
-			(state->pos.z - state->depth / 2) <= (pos.y + halfWidth));
-	}
-};
+	// Adds an object, or re-inserts it if it moved or resized since it was
+	// last seen. Either way the object counts as present for removeStale().
+	void update(BaseState * state) override;
 
-class QuadTree
-{
-public:
-	QuadTree(BoundingBox boundary)
-	{
-		this->_boundary = boundary;
-		_quads = (QuadTree**)calloc(4, sizeof(QuadTree*));
-	}
+	// Same as update(); kept for callers that build a tree from scratch
+	void insert(BaseState * state) { update(state); }
+
+	// Removes an object, if it is in the tree
+	void remove(uint32_t id) override;
+
+	// Removes every object that has not been passed to update() since the
+	// last call to removeStale()
+	void removeStale() override;
 
-	~QuadTree();
+	// Empties the tree, keeping its storage around
+	void clear() override;
+
+	// Appends every object that might overlap state to results
+	void query(BaseState * state, std::vector<BaseState*> & results) override;
 
-	void insert(BaseState * state);
-	void divide();
-	int getIndex(BaseState * state);
 	bool intersects(BaseState * state);
-	std::vector<BaseState*> query(BaseState * state);
+
+	// Number of objects in the tree
+	size_t size() override { return _objectIndex.size(); }
 
 private:
-	// Square bounding box defining this node's area
-	BoundingBox _boundary;
-	double _wiggleRoom = 3;
-
-	// Objects in this node
-	std::vector<BaseState*> _objects;
-
-	// Subtrees
-	QuadTree * _nw;
-	QuadTree * _ne;
-	QuadTree * _sw;
-	QuadTree * _se;
-	QuadTree ** _quads;
+	struct Node
+	{
+		BoundingBox boundary;
+		int parent;			// -1 for the root
+		int firstChild;		// First of four adjacent children, or -1 for a leaf
+		int depth;
+
+		// Objects linked into this node, and their states in the same order
+		std::vector<int> objects;
+		std::vector<BaseState*> states;
+	};
+
+	struct Object
+	{
+		BaseState * state;
+		uint32_t id;
+
+		// Box the object was inserted with, on the XZ plane
+		float minX, maxX, minZ, maxZ;
+
+		int node;		// Node the object is linked into
+		int slot;		// Position in the node's arrays
+		uint32_t stamp;	// Value of _stamp when last updated
+	};
+
+	// Quadrant of node that fully contains object, or -1 if it straddles
+	int getIndex(int node, int object);
+
+	// Links object into the deepest node under node that fully contains it,
+	// splitting the node if it gets too full
+	void insertObject(int node, int object);
+
+	void link(int object, int node);
+	void unlink(int object);
+
+	// Splits a leaf into four children
+	void divide(int node);
+
+	// Turns node back into a leaf if all of its children are empty leaves,
+	// then tries the same with its parent
+	void collapse(int node);
+
+	void removeObject(int object);
+
+	std::vector<Node> _nodes;
+	std::vector<int> _freeNodes;		// First indexes of unused groups of four
+	std::vector<Object> _objects;
+	std::vector<int> _freeObjects;
+	std::unordered_map<uint32_t, int> _objectIndex;	// State ID to object
+
+	uint32_t _stamp;
+	std::vector<uint32_t> _staleIds;	// Scratch space for removeStale()
 };
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cstring>
+
+#include "StateDelta.hpp"
+
+void StateDelta::encode(
+		const char * baseline,
+		const char * current,
+		uint32_t size,
+		std::vector<char> & out)
+{
+	// Mask goes first and is filled in as we go
+	size_t maskStart = out.size();
+	out.resize(maskStart + getMaskSize(size), 0);
+
+	for (uint32_t offset = 0, word = 0; offset < size; offset += STATE_DELTA_WORD_SIZE, word++)
+	{
+		// The last word may be short
+		uint32_t length = std::min((uint32_t)STATE_DELTA_WORD_SIZE, size - offset);
+		if (memcmp(baseline + offset, current + offset, length))
+		{
+			out[maskStart + word / 8] |= (char)(1 << (word % 8));
+			out.insert(out.end(), current + offset, current + offset + length);
+		}
+	}
+}
+
+
+size_t StateDelta::apply(
+		const char * in,
+		size_t inSize,
+		char * state,
+		uint32_t size)
+{
+	size_t maskSize = getMaskSize(size);
+	if (maskSize > inSize)
+	{
+		return 0;
+	}
+
+	const char * mask = in;
+	size_t used = maskSize;
+
+	for (uint32_t offset = 0, word = 0; offset < size; offset += STATE_DELTA_WORD_SIZE, word++)
+	{
+		if (mask[word / 8] & (1 << (word % 8)))
+		{
+			uint32_t length = std::min((uint32_t)STATE_DELTA_WORD_SIZE, size - offset);
+			if (used + length > inSize)
+			{
+				return 0;
+			}
+
+			memcpy(state + offset, in + used, length);
+			used += length;
+		}
+	}
+
+	return used;
+}
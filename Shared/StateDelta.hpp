@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// Granularity of a delta. Most state fields are 4-byte floats, ints and enums.
+#define STATE_DELTA_WORD_SIZE 4
+
+/*
+** Updates are sent to clients as snapshot packets. After the usual uint32_t
+** length, a packet is laid out as:
+**
+**	uint32_t sequence		Per-client packet number, acked by the client
+**	uint32_t recordCount
+**	records...
+**
+** where each record is one entity's state, serialized on its own with cereal
+** as a std::shared_ptr<BaseState>:
+**
+**	uint32_t id
+**	uint8_t kind			StateRecordKind
+**	uint32_t baseSequence	Packet holding the entity's acknowledged state,
+**							or zero if there is none. The server never uses
+**							anything older as a baseline, so the client can
+**							forget older states of the entity.
+**	uint32_t size			Size of the serialized state
+**	payload					Serialized state, or a StateDelta against the
+**							entity's state from packet baseSequence
+*/
+enum StateRecordKind
+{
+	STATE_RECORD_FULL,
+	STATE_RECORD_DELTA
+};
+
+/*
+** Word-level delta between two serialized states of the same size. A delta
+** is a bitmask with one bit per word, followed by only the words that
+** changed. If the sizes differ (strings, maps), send the full state instead.
+*/
+class StateDelta
+{
+public:
+	// Appends the delta of current against baseline to out
+	static void encode(
+			const char * baseline,
+			const char * current,
+			uint32_t size,
+			std::vector<char> & out);
+
+	// Applies a delta read from in to state, which holds the baseline.
+	// Returns the number of bytes of in that were used, or 0 if the delta
+	// runs past inSize.
+	static size_t apply(
+			const char * in,
+			size_t inSize,
+			char * state,
+			uint32_t size);
+
+	// Size of the bitmask for a state of the given size
+	static size_t getMaskSize(uint32_t size)
+	{
+		size_t wordCount = (size + STATE_DELTA_WORD_SIZE - 1) / STATE_DELTA_WORD_SIZE;
+		return (wordCount + 7) / 8;
+	}
+};
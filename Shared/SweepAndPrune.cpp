@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "SweepAndPrune.hpp"
+
+SweepAndPrune::SweepAndPrune()
+{
+	_stamp = 0;
+}
+
+void SweepAndPrune::update(BaseState * state)
+{
+	int object;
+
+	auto result = _objectIndex.find(state->id);
+	if (result != _objectIndex.end())
+	{
+		object = result->second;
+	}
+	else
+	{
+		if (!_freeObjects.empty())
+		{
+			object = _freeObjects.back();
+			_freeObjects.pop_back();
+		}
+		else
+		{
+			object = (int)_objects.size();
+			_objects.push_back(Object());
+		}
+
+		_objectIndex.insert({ state->id, object });
+		_objects[object].id = state->id;
+
+		// Appended out of order; the next sweep sorts them into place
+		_endpoints.push_back({ 0, object, true });
+		_endpoints.push_back({ 0, object, false });
+	}
+
+	Object & obj = _objects[object];
+	obj.state = state;
+	obj.minX = state->pos.x - state->width / 2;
+	obj.maxX = state->pos.x + state->width / 2;
+	obj.minZ = state->pos.z - state->depth / 2;
+	obj.maxZ = state->pos.z + state->depth / 2;
+	obj.stamp = _stamp;
+}
+
+void SweepAndPrune::removeObject(int object)
+{
+	_endpoints.erase(
+		std::remove_if(_endpoints.begin(), _endpoints.end(),
+			[object](const Endpoint & endpoint) { return endpoint.object == object; }),
+		_endpoints.end());
+
+	_objectIndex.erase(_objects[object].id);
+	_objects[object].state = nullptr;
+	_freeObjects.push_back(object);
+}
+
+void SweepAndPrune::remove(uint32_t id)
+{
+	auto result = _objectIndex.find(id);
+	if (result != _objectIndex.end())
+	{
+		removeObject(result->second);
+	}
+}
+
+void SweepAndPrune::removeStale()
+{
+	_staleIds.clear();
+	for (auto& objectPair : _objectIndex)
+	{
+		if (_objects[objectPair.second].stamp != _stamp)
+		{
+			_staleIds.push_back(objectPair.first);
+		}
+	}
+
+	for (auto& id : _staleIds)
+	{
+		remove(id);
+	}
+
+	_stamp++;
+}
+
+void SweepAndPrune::clear()
+{
+	_objects.clear();
+	_freeObjects.clear();
+	_objectIndex.clear();
+	_endpoints.clear();
+}
+
+void SweepAndPrune::findPairs(std::vector<std::pair<BaseState*, BaseState*>> & pairs)
+{
+	pairs.clear();
+
+	// Pick up the latest boxes, then insertion sort. Endpoints only move a
+	// little between ticks, so this is close to a single pass.
+	for (auto& endpoint : _endpoints)
+	{
+		Object & obj = _objects[endpoint.object];
+		endpoint.value = endpoint.isMin ? obj.minX : obj.maxX;
+	}
+
+	for (size_t i = 1; i < _endpoints.size(); i++)
+	{
+		Endpoint endpoint = _endpoints[i];
+		size_t j = i;
+		while (j > 0 && endpoint < _endpoints[j - 1])
+		{
+			_endpoints[j] = _endpoints[j - 1];
+			j--;
+		}
+		_endpoints[j] = endpoint;
+	}
+
+	// Every object whose X interval starts while another's is still open
+	// overlaps it on X; only Z is left to check
+	_active.clear();
+	for (auto& endpoint : _endpoints)
+	{
+		if (!endpoint.isMin)
+		{
+			// Not found only if a box went NaN and its ends came out of order
+			auto it = std::find(_active.begin(), _active.end(), endpoint.object);
+			if (it != _active.end())
+			{
+				*it = _active.back();
+				_active.pop_back();
+			}
+			continue;
+		}
+
+		Object & obj = _objects[endpoint.object];
+		for (auto& other : _active)
+		{
+			Object & otherObj = _objects[other];
+			if (obj.minZ <= otherObj.maxZ && otherObj.minZ <= obj.maxZ)
+			{
+				pairs.push_back({ otherObj.state, obj.state });
+			}
+		}
+		_active.push_back(endpoint.object);
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+#include "BaseState.hpp"
+
+/*
+** Finds every pair of overlapping boxes on the XZ plane by sweeping along X.
+** The endpoints of each box's X interval are kept sorted between ticks, and
+** since objects only move a little each tick, re-sorting them with an
+** insertion sort is close to linear.
+**
+** Like the broad phases, objects are identified by state ID and are meant to
+** be kept between ticks: call update() on every object each tick, then
+** removeStale() to drop the ones that are gone.
+*/
+class SweepAndPrune
+{
+public:
+	SweepAndPrune();
+
+	// Adds an object, or refreshes its box from its state. Either way the
+	// object counts as present for removeStale().
+	void update(BaseState * state);
+
+	// Removes an object, if it is present
+	void remove(uint32_t id);
+
+	// Removes every object that has not been passed to update() since the
+	// last call to removeStale()
+	void removeStale();
+
+	// Removes every object, keeping storage around
+	void clear();
+
+	// Replaces the contents of pairs with every pair of objects whose boxes,
+	// as of their last update(), overlap. Each pair is reported once, in
+	// sweep order.
+	void findPairs(std::vector<std::pair<BaseState*, BaseState*>> & pairs);
+
+	size_t size() { return _objectIndex.size(); }
+
+private:
+	struct Object
+	{
+		BaseState * state;
+		uint32_t id;
+		float minX, maxX, minZ, maxZ;
+		uint32_t stamp;	// Value of _stamp when last updated
+	};
+
+	struct Endpoint
+	{
+		float value;
+		int object;
+		bool isMin;
+
+		// Starts sort before ends at the same spot, so boxes that only touch
+		// still count as overlapping
+		bool operator<(const Endpoint & other) const
+		{
+			return value < other.value || (value == other.value && isMin && !other.isMin);
+		}
+	};
+
+	void removeObject(int object);
+
+	std::vector<Object> _objects;
+	std::vector<int> _freeObjects;
+	std::unordered_map<uint32_t, int> _objectIndex;	// State ID to object
+
+	// Both ends of every object's X interval, sorted as of the last sweep
+	std::vector<Endpoint> _endpoints;
+
+	std::vector<int> _active;	// Scratch space for findPairs()
+
+	uint32_t _stamp;
+	std::vector<uint32_t> _staleIds;	// Scratch space for removeStale()
+};
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cmath>
+
+#include "UniformGrid.hpp"
+
+UniformGrid::UniformGrid(BoundingBox boundary, int cellsPerSide)
+{
+	_cellsPerSide = std::max(cellsPerSide, 1);
+	_cellWidth = (float)(boundary.halfWidth * 2) / _cellsPerSide;
+	_origin = boundary.pos - glm::vec2((float)boundary.halfWidth);
+	_cells.resize(_cellsPerSide * _cellsPerSide);
+	_stamp = 0;
+}
+
+int UniformGrid::toCell(float coord, float origin)
+{
+	// fmax() also takes care of NaN
+	float cell = std::floor((coord - origin) / _cellWidth);
+	cell = std::fmin(std::fmax(cell, 0.0f), (float)(_cellsPerSide - 1));
+	return (int)cell;
+}
+
+UniformGrid::CellRange UniformGrid::getCells(BaseState * state)
+{
+	CellRange range;
+	range.minX = toCell(state->pos.x - state->width / 2, _origin.x);
+	range.maxX = toCell(state->pos.x + state->width / 2, _origin.x);
+	range.minZ = toCell(state->pos.z - state->depth / 2, _origin.y);
+	range.maxZ = toCell(state->pos.z + state->depth / 2, _origin.y);
+	return range;
+}
+
+void UniformGrid::link(int object)
+{
+	Object & obj = _objects[object];
+	Entry entry = { obj.state, object, obj.cells.minX, obj.cells.minZ };
+
+	for (int z = obj.cells.minZ; z <= obj.cells.maxZ; z++)
+	{
+		for (int x = obj.cells.minX; x <= obj.cells.maxX; x++)
+		{
+			_cells[z * _cellsPerSide + x].push_back(entry);
+		}
+	}
+}
+
+void UniformGrid::unlink(int object)
+{
+	Object & obj = _objects[object];
+
+	// Cells only hold a handful of entries, so searching beats keeping
+	// track of a slot per cell
+	for (int z = obj.cells.minZ; z <= obj.cells.maxZ; z++)
+	{
+		for (int x = obj.cells.minX; x <= obj.cells.maxX; x++)
+		{
+			auto& cell = _cells[z * _cellsPerSide + x];
+			for (size_t i = 0; i < cell.size(); i++)
+			{
+				if (cell[i].object == object)
+				{
+					cell[i] = cell.back();
+					cell.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+void UniformGrid::update(BaseState * state)
+{
+	CellRange cells = getCells(state);
+
+	auto result = _objectIndex.find(state->id);
+	if (result != _objectIndex.end())
+	{
+		Object & obj = _objects[result->second];
+		obj.stamp = _stamp;
+
+		// Most objects stay within the same cells from tick to tick
+		if (obj.cells == cells && obj.state == state)
+		{
+			return;
+		}
+
+		unlink(result->second);
+		obj.state = state;
+		obj.cells = cells;
+		link(result->second);
+		return;
+	}
+
+	int object;
+	if (!_freeObjects.empty())
+	{
+		object = _freeObjects.back();
+		_freeObjects.pop_back();
+	}
+	else
+	{
+		object = (int)_objects.size();
+		_objects.push_back(Object());
+	}
+
+	_objects[object] = { state, state->id, cells, _stamp };
+	_objectIndex.insert({ state->id, object });
+	link(object);
+}
+
+void UniformGrid::removeObject(int object)
+{
+	unlink(object);
+	_objectIndex.erase(_objects[object].id);
+	_objects[object].state = nullptr;
+	_freeObjects.push_back(object);
+}
+
+void UniformGrid::remove(uint32_t id)
+{
+	auto result = _objectIndex.find(id);
+	if (result != _objectIndex.end())
+	{
+		removeObject(result->second);
+	}
+}
+
+void UniformGrid::removeStale()
+{
+	_staleIds.clear();
+	for (auto& objectPair : _objectIndex)
+	{
+		if (_objects[objectPair.second].stamp != _stamp)
+		{
+			_staleIds.push_back(objectPair.first);
+		}
+	}
+
+	for (auto& id : _staleIds)
+	{
+		remove(id);
+	}
+
+	_stamp++;
+}
+
+void UniformGrid::clear()
+{
+	for (auto& cell : _cells)
+	{
+		cell.clear();
+	}
+	_objects.clear();
+	_freeObjects.clear();
+	_objectIndex.clear();
+}
+
+void UniformGrid::query(BaseState * state, std::vector<BaseState*> & results)
+{
+	CellRange cells = getCells(state);
+
+	for (int z = cells.minZ; z <= cells.maxZ; z++)
+	{
+		for (int x = cells.minX; x <= cells.maxX; x++)
+		{
+			for (auto& entry : _cells[z * _cellsPerSide + x])
+			{
+				// Skip the entry unless this is the first cell shared with it
+				if (std::max(entry.minX, cells.minX) == x &&
+					std::max(entry.minZ, cells.minZ) == z)
+				{
+					results.push_back(entry.state);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "BroadPhase.hpp"
+
+/*
+** Fixed grid over the XZ plane, meant to line up with the level's tiles.
+** Every cell an object's box touches holds an entry for it, so large
+** objects like houses occupy several cells. Looking up the neighbours of a
+** small object only has to visit the one to four cells under it.
+**
+** Objects that stick out past the edge of the grid are clamped into the
+** border cells, so nothing is ever missed. Entries are only moved between
+** cells when an object crosses into a different set of cells.
+*/
+class UniformGrid : public BroadPhase
+{
+public:
+	UniformGrid(BoundingBox boundary, int cellsPerSide);
+
+	void update(BaseState * state) override;
+	void remove(uint32_t id) override;
+	void removeStale() override;
+	void clear() override;
+	void query(BaseState * state, std::vector<BaseState*> & results) override;
+
+	size_t size() override { return _objectIndex.size(); }
+
+private:
+	// Inclusive range of cells covered by a box
+	struct CellRange
+	{
+		int minX, maxX, minZ, maxZ;
+
+		bool operator==(const CellRange & other) const
+		{
+			return minX == other.minX && maxX == other.maxX &&
+				minZ == other.minZ && maxZ == other.maxZ;
+		}
+	};
+
+	struct Entry
+	{
+		BaseState * state;
+		int object;
+
+		// First cell of the object's range. A query only reports an entry
+		// from the first cell it shares with the object, so objects in
+		// several cells are not reported more than once.
+		int minX, minZ;
+	};
+
+	struct Object
+	{
+		BaseState * state;
+		uint32_t id;
+		CellRange cells;
+		uint32_t stamp;	// Value of _stamp when last updated
+	};
+
+	CellRange getCells(BaseState * state);
+
+	// Column or row of the cell containing a coordinate, clamped to the grid
+	int toCell(float coord, float origin);
+
+	void link(int object);
+	void unlink(int object);
+
+	void removeObject(int object);
+
+	int _cellsPerSide;
+	float _cellWidth;
+	glm::vec2 _origin;	// Corner of the grid with the lowest X and Z
+
+	// Row-major by Z, then X
+	std::vector<std::vector<Entry>> _cells;
+
+	std::vector<Object> _objects;
+	std::vector<int> _freeObjects;
+	std::unordered_map<uint32_t, int> _objectIndex;	// State ID to object
+
+	uint32_t _stamp;
+	std::vector<uint32_t> _staleIds;	// Scratch space for removeStale()
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cereal/cereal.hpp>
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+/*
+** Encodings that states can be sent to clients in. The server offers the
+** formats it supports when a client connects, and the client picks one with
+** EVENT_SET_WIRE_FORMAT before it is sent any updates.
+*/
+enum WireFormat
+{
+	WIRE_FORMAT_STANDARD,	// cereal::BinaryOutputArchive, full floats
+	WIRE_FORMAT_COMPACT,	// CompactOutputArchive, quantized spatial fields
+	WIRE_FORMAT_COUNT
+};
+
+// Bitmask of the formats a server supports
+#define WIRE_FORMAT_BIT(format) (1u << (format))
+#define SUPPORTED_WIRE_FORMATS (WIRE_FORMAT_BIT(WIRE_FORMAT_STANDARD) | WIRE_FORMAT_BIT(WIRE_FORMAT_COMPACT))
+
+// Fixed-point scale for compact positions and sizes: 1/256 of a unit, which
+// covers +-128 units. That is plenty for a MAP_WIDTH map; anything further
+// out is sent as floats.
+#define COMPACT_FIXED_SCALE 256.0f
+
+#define COMPACT_PI 3.14159265358979f
+
+/*
+** Binary archives for WIRE_FORMAT_COMPACT. They write the same bytes as the
+** cereal binary archives, except that sizes are varints instead of 64 bits.
+** States check for these archives with IsCompactArchive<Archive> and swap in
+** a smaller encoding of their own fields.
+*/
+class CompactOutputArchive : public cereal::OutputArchive<CompactOutputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+	CompactOutputArchive(std::ostream & stream) :
+		cereal::OutputArchive<CompactOutputArchive, cereal::AllowEmptyClassElision>(this),
+		_stream(stream)
+	{};
+
+	void saveBinary(const void * data, std::size_t size)
+	{
+		auto writtenSize = (std::size_t)_stream.rdbuf()->sputn((const char*)data, size);
+		if (writtenSize != size)
+		{
+			throw cereal::Exception("Failed to write " + std::to_string(size) + " bytes to output stream");
+		}
+	}
+
+private:
+	std::ostream & _stream;
+};
+
+class CompactInputArchive : public cereal::InputArchive<CompactInputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+	CompactInputArchive(std::istream & stream) :
+		cereal::InputArchive<CompactInputArchive, cereal::AllowEmptyClassElision>(this),
+		_stream(stream)
+	{};
+
+	void loadBinary(void * const data, std::size_t size)
+	{
+		auto readSize = (std::size_t)_stream.rdbuf()->sgetn((char*)data, size);
+		if (readSize != size)
+		{
+			throw cereal::Exception("Failed to read " + std::to_string(size) + " bytes from input stream");
+		}
+	}
+
+private:
+	std::istream & _stream;
+};
+
+template<class Archive>
+struct IsCompactArchive : std::integral_constant<bool,
+	std::is_same<Archive, CompactOutputArchive>::value ||
+	std::is_same<Archive, CompactInputArchive>::value>
+{};
+
+// Quantization helpers for compact states
+inline bool isFixedRange(float value)
+{
+	return std::abs(value * COMPACT_FIXED_SCALE) < 32767.0f;
+}
+
+inline int16_t toFixed(float value)
+{
+	return (int16_t)std::lround(value * COMPACT_FIXED_SCALE);
+}
+
+inline float fromFixed(int16_t value)
+{
+	return value / COMPACT_FIXED_SCALE;
+}
+
+// Yaw of a direction in the XZ plane, in 1/65536ths of a turn
+inline uint16_t toCompactYaw(float x, float z)
+{
+	float turns = std::atan2(x, z) / (2 * COMPACT_PI);
+	return (uint16_t)(int32_t)std::lround(turns * 65536.0f);
+}
+
+inline float fromCompactYaw(uint16_t yaw)
+{
+	return yaw / 65536.0f * 2 * COMPACT_PI;
+}
+
+// Value between zero and one, such as transparency, in 1/255ths
+inline uint8_t toCompactUnit(float value)
+{
+	return (uint8_t)std::lround(std::max(0.0f, std::min(1.0f, value)) * 255.0f);
+}
+
+inline float fromCompactUnit(uint8_t value)
+{
+	return value / 255.0f;
+}
+
+namespace cereal
+{
+	template<class T> inline
+	typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+	CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive & ar, T const & t)
+	{
+		ar.saveBinary(std::addressof(t), sizeof(t));
+	}
+
+	template<class T> inline
+	typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+	CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive & ar, T & t)
+	{
+		ar.loadBinary(std::addressof(t), sizeof(t));
+	}
+
+	template<class Archive, class T> inline
+	CEREAL_ARCHIVE_RESTRICT(CompactInputArchive, CompactOutputArchive)
+	CEREAL_SERIALIZE_FUNCTION_NAME(Archive & ar, NameValuePair<T> & t)
+	{
+		ar(t.value);
+	}
+
+	// Sizes of strings, vectors and maps are almost always tiny, so write
+	// them seven bits at a time
+	template<class T> inline
+	void CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive & ar, SizeTag<T> const & t)
+	{
+		uint64_t size = (uint64_t)t.size;
+		do
+		{
+			uint8_t byte = size & 0x7F;
+			size >>= 7;
+			if (size)
+			{
+				byte |= 0x80;
+			}
+			ar.saveBinary(&byte, 1);
+		} while (size);
+	}
+
+	template<class T> inline
+	void CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive & ar, SizeTag<T> & t)
+	{
+		uint64_t size = 0;
+		uint8_t byte;
+		int shift = 0;
+		do
+		{
+			ar.loadBinary(&byte, 1);
+			size |= (uint64_t)(byte & 0x7F) << shift;
+			shift += 7;
+		} while ((byte & 0x80) && shift < 64);
+		t.size = (typename std::remove_reference<T>::type)size;
+	}
+
+	template<class T> inline
+	void CEREAL_SAVE_FUNCTION_NAME(CompactOutputArchive & ar, BinaryData<T> const & bd)
+	{
+		ar.saveBinary(bd.data, (std::size_t)bd.size);
+	}
+
+	template<class T> inline
+	void CEREAL_LOAD_FUNCTION_NAME(CompactInputArchive & ar, BinaryData<T> & bd)
+	{
+		ar.loadBinary(bd.data, (std::size_t)bd.size);
+	}
+}
+
+CEREAL_REGISTER_ARCHIVE(CompactOutputArchive)
+CEREAL_REGISTER_ARCHIVE(CompactInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(CompactInputArchive, CompactOutputArchive)